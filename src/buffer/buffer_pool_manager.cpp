@@ -1,24 +1,36 @@
+#include <thread>
+
 #include "buffer/buffer_pool_manager.h"
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 
 BufferPoolManager::BufferPoolManager(size_t pool_size, DiskManager *disk_manager)
-        : pool_size_(pool_size), disk_manager_(disk_manager) {
+        : pool_size_(pool_size), disk_manager_(disk_manager), io_in_progress_(pool_size, false) {
   pages_ = new Page[pool_size_];
   replacer_ = new LRUReplacer(pool_size_);
   for (size_t i = 0; i < pool_size_; i++) {
+    pages_[i].ResizeMemory(disk_manager_->GetPageSize());
     free_list_.emplace_back(i);
   }
+  AddDiskManager(DEFAULT_FILE_ID, disk_manager_);
 }
 
 BufferPoolManager::~BufferPoolManager() {
-  for (auto page: page_table_) {
-    FlushPage(page.first);
-  }
+  FlushAllPages();
   delete[] pages_;
   delete replacer_;
 }
 
+void BufferPoolManager::AddDiskManager(file_id_t file_id, DiskManager *disk_manager) {
+  ASSERT(file_id < MAX_FILE_NUM, "Invalid file id.");
+  ASSERT(disk_manager->GetPageSize() == GetPageSize(), "Page size of all files in a buffer pool must be the same.");
+  std::scoped_lock<recursive_mutex> lock(latch_);
+  if (disk_managers_.size() <= file_id) {
+    disk_managers_.resize(file_id + 1, nullptr);
+  }
+  disk_managers_[file_id] = disk_manager;
+}
+
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   // 1.     Search the page table for the requested page (P).
   // 1.1    If P exists, pin it and return it immediately.
@@ -27,16 +39,60 @@ Page *BufferPoolManager::FetchPage(page_id_t page_id) {
   // 2.     If R is dirty, write it back to the disk.
   // 3.     Delete R from the page table and insert P.
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  return nullptr;
+  std::unique_lock<recursive_mutex> lock(latch_);
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    frame_id_t frame_id = iter->second;
+    pages_[frame_id].pin_count_++;
+    replacer_->Pin(frame_id);
+    // another thread may be still reading the page in
+    io_done_.wait(lock, [this, frame_id] { return !io_in_progress_[frame_id]; });
+    return &pages_[frame_id];
+  }
+  DiskManager *disk_manager = GetDiskManager(page_id);
+  frame_id_t frame_id;
+  if (disk_manager == nullptr || !FindFreeFrame(&frame_id)) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page_table_[page_id] = frame_id;
+  // read without holding the latch, so that reads of different files are not serialized by the buffer pool
+  io_in_progress_[frame_id] = true;
+  lock.unlock();
+  disk_manager->ReadPage(GetLocalPageId(page_id), page->data_);
+  lock.lock();
+  io_in_progress_[frame_id] = false;
+  io_done_.notify_all();
+  return page;
 }
 
-Page *BufferPoolManager::NewPage(page_id_t &page_id) {
+Page *BufferPoolManager::NewPage(page_id_t &page_id, file_id_t file_id) {
   // 0.   Make sure you call AllocatePage!
   // 1.   If all the pages in the buffer pool are pinned, return nullptr.
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  return nullptr;
+  std::scoped_lock<recursive_mutex> lock(latch_);
+  frame_id_t frame_id;
+  if (!FindFreeFrame(&frame_id)) {
+    return nullptr;
+  }
+  page_id_t new_page_id = AllocatePage(file_id);
+  if (new_page_id == INVALID_PAGE_ID) {
+    free_list_.push_back(frame_id);
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page->ResetMemory();
+  page->page_id_ = new_page_id;
+  page->pin_count_ = 1;
+  page->is_dirty_ = false;
+  page_table_[new_page_id] = frame_id;
+  page_id = new_page_id;
+  return page;
 }
 
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
@@ -45,28 +101,173 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
   // 1.   If P does not exist, return true.
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  return false;
+  std::scoped_lock<recursive_mutex> lock(latch_);
+  auto iter = page_table_.find(page_id);
+  if (iter != page_table_.end()) {
+    frame_id_t frame_id = iter->second;
+    Page *page = &pages_[frame_id];
+    if (page->pin_count_ > 0) {
+      return false;
+    }
+    replacer_->Pin(frame_id);
+    page_table_.erase(iter);
+    page->ResetMemory();
+    page->page_id_ = INVALID_PAGE_ID;
+    page->is_dirty_ = false;
+    free_list_.push_back(frame_id);
+  }
+  DeallocatePage(page_id);
+  return true;
+}
+
+std::vector<page_id_t> BufferPoolManager::DeletePages(const std::vector<page_id_t> &page_ids) {
+  std::vector<page_id_t> pinned_page_ids;
+  std::unordered_map<DiskManager *, std::vector<page_id_t>> file_page_ids;
+  {
+    std::scoped_lock<recursive_mutex> lock(latch_);
+    for (auto page_id : page_ids) {
+      auto iter = page_table_.find(page_id);
+      if (iter != page_table_.end()) {
+        frame_id_t frame_id = iter->second;
+        Page *page = &pages_[frame_id];
+        if (page->pin_count_ > 0) {
+          pinned_page_ids.push_back(page_id);
+          continue;
+        }
+        replacer_->Pin(frame_id);
+        page_table_.erase(iter);
+        page->ResetMemory();
+        page->page_id_ = INVALID_PAGE_ID;
+        page->is_dirty_ = false;
+        free_list_.push_back(frame_id);
+      }
+      DiskManager *disk_manager = GetDiskManager(page_id);
+      if (disk_manager != nullptr) {
+        file_page_ids[disk_manager].push_back(GetLocalPageId(page_id));
+      }
+    }
+  }
+  // the frames are already free, deallocating does not block other threads on the latch
+  for (auto &file_pages : file_page_ids) {
+    file_pages.first->DeAllocatePages(std::move(file_pages.second));
+  }
+  return pinned_page_ids;
 }
 
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-  return false;
+  std::scoped_lock<recursive_mutex> lock(latch_);
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return false;
+  }
+  Page *page = &pages_[iter->second];
+  if (page->pin_count_ <= 0) {
+    return false;
+  }
+  page->is_dirty_ |= is_dirty;
+  if (--page->pin_count_ == 0) {
+    replacer_->Unpin(iter->second);
+  }
+  return true;
 }
 
 bool BufferPoolManager::FlushPage(page_id_t page_id) {
-  return false;
+  std::unique_lock<recursive_mutex> lock(latch_);
+  auto iter = page_table_.find(page_id);
+  if (iter == page_table_.end()) {
+    return false;
+  }
+  frame_id_t frame_id = iter->second;
+  io_done_.wait(lock, [this, frame_id] { return !io_in_progress_[frame_id]; });
+  GetDiskManager(page_id)->WritePage(GetLocalPageId(page_id), pages_[frame_id].data_);
+  pages_[frame_id].is_dirty_ = false;
+  return true;
 }
 
-page_id_t BufferPoolManager::AllocatePage() {
-  int next_page_id = disk_manager_->AllocatePage();
-  return next_page_id;
+void BufferPoolManager::FlushAllPages() {
+  // pin the dirty pages so they stay in their frames while being written without the latch
+  std::unordered_map<DiskManager *, std::vector<frame_id_t>> dirty_frames;
+  {
+    std::scoped_lock<recursive_mutex> lock(latch_);
+    for (auto &entry : page_table_) {
+      Page *page = &pages_[entry.second];
+      if (!page->is_dirty_ || io_in_progress_[entry.second]) {
+        continue;
+      }
+      page->pin_count_++;
+      replacer_->Pin(entry.second);
+      page->is_dirty_ = false;
+      dirty_frames[GetDiskManager(entry.first)].push_back(entry.second);
+    }
+  }
+  // one writer per file
+  std::vector<std::thread> writers;
+  for (auto &file_frames : dirty_frames) {
+    writers.emplace_back([this, disk_manager = file_frames.first, &frames = file_frames.second] {
+      for (auto frame_id : frames) {
+        disk_manager->WritePage(GetLocalPageId(pages_[frame_id].page_id_), pages_[frame_id].data_);
+      }
+    });
+  }
+  for (auto &writer : writers) {
+    writer.join();
+  }
+  std::scoped_lock<recursive_mutex> lock(latch_);
+  for (auto &file_frames : dirty_frames) {
+    for (auto frame_id : file_frames.second) {
+      if (--pages_[frame_id].pin_count_ == 0) {
+        replacer_->Unpin(frame_id);
+      }
+    }
+  }
+}
+
+page_id_t BufferPoolManager::AllocatePage(file_id_t file_id) {
+  if (file_id >= disk_managers_.size() || disk_managers_[file_id] == nullptr) {
+    LOG(ERROR) << "Tablespace file " << file_id << " is not opened.";
+    return INVALID_PAGE_ID;
+  }
+  page_id_t next_page_id = disk_managers_[file_id]->AllocatePage();
+  return next_page_id == INVALID_PAGE_ID ? INVALID_PAGE_ID : MakePageId(file_id, next_page_id);
 }
 
 void BufferPoolManager::DeallocatePage(page_id_t page_id) {
-  disk_manager_->DeAllocatePage(page_id);
+  DiskManager *disk_manager = GetDiskManager(page_id);
+  if (disk_manager != nullptr) {
+    disk_manager->DeAllocatePage(GetLocalPageId(page_id));
+  }
 }
 
 bool BufferPoolManager::IsPageFree(page_id_t page_id) {
-  return disk_manager_->IsPageFree(page_id);
+  DiskManager *disk_manager = GetDiskManager(page_id);
+  return disk_manager == nullptr || disk_manager->IsPageFree(GetLocalPageId(page_id));
+}
+
+bool BufferPoolManager::FindFreeFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
+    return true;
+  }
+  if (!replacer_->Victim(frame_id)) {
+    return false;
+  }
+  Page *victim = &pages_[*frame_id];
+  if (victim->is_dirty_) {
+    GetDiskManager(victim->page_id_)->WritePage(GetLocalPageId(victim->page_id_), victim->data_);
+    victim->is_dirty_ = false;
+  }
+  page_table_.erase(victim->page_id_);
+  return true;
+}
+
+DiskManager *BufferPoolManager::GetDiskManager(page_id_t page_id) {
+  if (page_id < 0) {
+    return nullptr;
+  }
+  file_id_t file_id = GetFileId(page_id);
+  std::scoped_lock<recursive_mutex> lock(latch_);
+  return file_id < disk_managers_.size() ? disk_managers_[file_id] : nullptr;
 }
 
 // Only used for debug
@@ -79,4 +280,4 @@ bool BufferPoolManager::CheckAllUnpinned() {
     }
   }
   return res;
-}
\ No newline at end of file
+}
@@ -1,23 +1,61 @@
 #include "buffer/lru_replacer.h"
+#include "common/macros.h"
 
-LRUReplacer::LRUReplacer(size_t num_pages) {
-
+LRUReplacer::LRUReplacer(size_t num_pages)
+        : capacity_(num_pages), prev_(num_pages + 1), next_(num_pages + 1), is_linked_(num_pages, false) {
+  auto head = static_cast<frame_id_t>(capacity_);
+  prev_[head] = next_[head] = head;
 }
 
 LRUReplacer::~LRUReplacer() = default;
 
 bool LRUReplacer::Victim(frame_id_t *frame_id) {
-  return false;
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  *frame_id = next_[capacity_];
+  Unlink(*frame_id);
+  return true;
 }
 
 void LRUReplacer::Pin(frame_id_t frame_id) {
-
+  std::scoped_lock<std::mutex> lock(latch_);
+  ASSERT(static_cast<size_t>(frame_id) < capacity_, "Invalid frame id.");
+  if (is_linked_[frame_id]) {
+    Unlink(frame_id);
+  }
 }
 
 void LRUReplacer::Unpin(frame_id_t frame_id) {
-
+  std::scoped_lock<std::mutex> lock(latch_);
+  ASSERT(static_cast<size_t>(frame_id) < capacity_, "Invalid frame id.");
+  // unpin a frame already in the replacer keeps its position
+  if (is_linked_[frame_id] || size_ >= capacity_) {
+    return;
+  }
+  Link(frame_id);
 }
 
 size_t LRUReplacer::Size() {
-  return 0;
-}
\ No newline at end of file
+  std::scoped_lock<std::mutex> lock(latch_);
+  return size_;
+}
+
+void LRUReplacer::Link(frame_id_t frame_id) {
+  auto head = static_cast<frame_id_t>(capacity_);
+  frame_id_t tail = prev_[head];
+  prev_[frame_id] = tail;
+  next_[frame_id] = head;
+  next_[tail] = frame_id;
+  prev_[head] = frame_id;
+  is_linked_[frame_id] = true;
+  size_++;
+}
+
+void LRUReplacer::Unlink(frame_id_t frame_id) {
+  next_[prev_[frame_id]] = next_[frame_id];
+  prev_[next_[frame_id]] = prev_[frame_id];
+  is_linked_[frame_id] = false;
+  size_--;
+}
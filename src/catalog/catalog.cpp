@@ -20,23 +20,34 @@ CatalogMeta::CatalogMeta() {}
 CatalogManager::CatalogManager(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager,
                                LogManager *log_manager, bool init)
         : buffer_pool_manager_(buffer_pool_manager), lock_manager_(lock_manager),
-          log_manager_(log_manager), heap_(new SimpleMemHeap()) {
+          log_manager_(log_manager), heap_(new SimpleMemHeap()),
+          page_reclaimer_(new PageReclaimer(buffer_pool_manager)) {
   // ASSERT(false, "Not Implemented yet");
 }
 
 CatalogManager::~CatalogManager() {
+  // the old table heaps are allocated in the heap of their tables, so they are released before the tables
+  delete page_reclaimer_;
+  for (auto &table_kv : tables_) {
+    table_kv.second->~TableInfo();
+  }
   delete heap_;
 }
 
 dberr_t CatalogManager::CreateTable(const string &table_name, TableSchema *schema,
-                                    Transaction *txn, TableInfo *&table_info) {
+                                    Transaction *txn, TableInfo *&table_info, file_id_t file_id,
+                                    TableFormat format) {
   // ASSERT(false, "Not Implemented yet");
   return DB_FAILED;
 }
 
 dberr_t CatalogManager::GetTable(const string &table_name, TableInfo *&table_info) {
-  // ASSERT(false, "Not Implemented yet");
-  return DB_FAILED;
+  auto iter = table_names_.find(table_name);
+  if (iter == table_names_.end()) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  table_info = tables_[iter->second];
+  return DB_SUCCESS;
 }
 
 dberr_t CatalogManager::GetTables(vector<TableInfo *> &tables) const {
@@ -63,8 +74,48 @@ dberr_t CatalogManager::GetTableIndexes(const std::string &table_name, std::vect
 }
 
 dberr_t CatalogManager::DropTable(const string &table_name) {
-  // ASSERT(false, "Not Implemented yet");
-  return DB_FAILED;
+  auto iter = table_names_.find(table_name);
+  if (iter == table_names_.end()) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  // the table info is destroyed after its table heap is released
+  TableInfo *table_info = tables_[iter->second];
+  tables_.erase(iter->second);
+  table_names_.erase(iter);
+  page_reclaimer_->Release(table_info->ResetTableHeap(nullptr), [table_info]() { table_info->~TableInfo(); });
+  return DB_SUCCESS;
+}
+
+dberr_t CatalogManager::TruncateTable(const string &table_name, Transaction *txn) {
+  auto iter = table_names_.find(table_name);
+  if (iter == table_names_.end()) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  // the roots of the indexes would point to the released pages, resetting them is not supported yet
+  auto index_iter = index_names_.find(table_name);
+  if (index_iter != index_names_.end() && !index_iter->second.empty()) {
+    return DB_FAILED;
+  }
+  TableInfo *table_info = tables_[iter->second];
+  TableHeap *old_table_heap = table_info->GetTableHeap();
+  TableHeap *table_heap = TableHeap::Create(buffer_pool_manager_, table_info->GetSchema(), txn, log_manager_,
+                                            lock_manager_, table_info->GetMemHeap(), old_table_heap->GetFileId(),
+                                            old_table_heap->GetFormat());
+  // the new table heap is empty, so its options are set up before any tuple is inserted
+  if (old_table_heap->GetZoneMap() != nullptr) {
+    table_heap->EnableZoneMap(old_table_heap->GetZoneMap()->GetColumns());
+  }
+  for (uint32_t i = 0; i < table_info->GetSchema()->GetColumnCount(); i++) {
+    if (old_table_heap->GetDictionary(i) != nullptr) {
+      table_heap->EnableDictionary(i);
+    }
+  }
+  if (old_table_heap->IsAppendMode()) {
+    table_heap->SetAppendMode(true);
+  }
+  // the old table heap is destroyed once its pages are released
+  page_reclaimer_->Release(table_info->ResetTableHeap(table_heap));
+  return DB_SUCCESS;
 }
 
 dberr_t CatalogManager::DropIndex(const string &table_name, const string &index_name) {
@@ -1,5 +1,12 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
 #include "executor/execute_engine.h"
 #include "glog/logging.h"
+#include "storage/parallel_table_scan.h"
 
 ExecuteEngine::ExecuteEngine() {
 
@@ -24,8 +31,12 @@ dberr_t ExecuteEngine::Execute(pSyntaxNode ast, ExecuteContext *context) {
       return ExecuteCreateTable(ast, context);
     case kNodeDropTable:
       return ExecuteDropTable(ast, context);
+    case kNodeTruncateTable:
+      return ExecuteTruncateTable(ast, context);
     case kNodeShowIndexes:
       return ExecuteShowIndexes(ast, context);
+    case kNodeShowIOStats:
+      return ExecuteShowIOStats(ast, context);
     case kNodeCreateIndex:
       return ExecuteCreateIndex(ast, context);
     case kNodeDropIndex:
@@ -103,6 +114,17 @@ dberr_t ExecuteEngine::ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context
   return DB_FAILED;
 }
 
+dberr_t ExecuteEngine::ExecuteTruncateTable(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteTruncateTable" << std::endl;
+#endif
+  auto iter = dbs_.find(current_db_);
+  if (iter == dbs_.end()) {
+    return DB_FAILED;
+  }
+  return iter->second->catalog_mgr_->TruncateTable(ast->child_->val_, context->txn_);
+}
+
 dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteShowIndexes" << std::endl;
@@ -110,6 +132,26 @@ dberr_t ExecuteEngine::ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *conte
   return DB_FAILED;
 }
 
+dberr_t ExecuteEngine::ExecuteShowIOStats(pSyntaxNode ast, ExecuteContext *context) {
+#ifdef ENABLE_EXECUTE_DEBUG
+  LOG(INFO) << "ExecuteShowIOStats" << std::endl;
+#endif
+  auto iter = dbs_.find(current_db_);
+  if (iter == dbs_.end()) {
+    return DB_FAILED;
+  }
+  if (ast->child_ == nullptr) {
+    iter->second->DumpIOStats(std::cout);
+    return DB_SUCCESS;
+  }
+  std::ofstream out(ast->child_->val_, std::ios::app);
+  if (!out.is_open()) {
+    return DB_FAILED;
+  }
+  iter->second->DumpIOStats(out);
+  return DB_SUCCESS;
+}
+
 dberr_t ExecuteEngine::ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteCreateIndex" << std::endl;
@@ -124,18 +166,191 @@ dberr_t ExecuteEngine::ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context
   return DB_FAILED;
 }
 
+/**
+ * Format a value in the result of a select
+ */
+static std::string FormatField(const Field &field) {
+  if (field.IsNull()) {
+    return "null";
+  }
+  char buf[sizeof(int32_t) + sizeof(float)];
+  std::ostringstream out;
+  switch (field.GetTypeId()) {
+    case TypeId::kTypeInt:
+      field.SerializeTo(buf);
+      out << MACH_READ_INT32(buf);
+      break;
+    case TypeId::kTypeFloat:
+      field.SerializeTo(buf);
+      out << MACH_READ_FROM(float, buf);
+      break;
+    case TypeId::kTypeChar:
+      out.write(field.GetData(), field.GetLength());
+      break;
+    default:
+      break;
+  }
+  return out.str();
+}
+
 dberr_t ExecuteEngine::ExecuteSelect(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteSelect" << std::endl;
 #endif
-  return DB_FAILED;
+  auto iter = dbs_.find(current_db_);
+  if (iter == dbs_.end()) {
+    return DB_FAILED;
+  }
+  pSyntaxNode columns_node = ast->child_;
+  pSyntaxNode table_node = columns_node->next_;
+  pSyntaxNode conditions = table_node->next_;
+  TableInfo *table_info = nullptr;
+  if (iter->second->catalog_mgr_->GetTable(table_node->val_, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  Schema *schema = table_info->GetSchema();
+  TableHeap *table_heap = table_info->GetTableHeap();
+  // columns in the order they are output, and in ascending order as they are read
+  std::vector<uint32_t> output_columns;
+  if (columns_node->type_ == kNodeAllColumns) {
+    for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+      output_columns.push_back(i);
+    }
+  } else {
+    for (pSyntaxNode column = columns_node->child_; column != nullptr; column = column->next_) {
+      uint32_t index;
+      if (schema->GetColumnIndex(column->val_, index) != DB_SUCCESS) {
+        return DB_COLUMN_NAME_NOT_EXIST;
+      }
+      output_columns.push_back(index);
+    }
+  }
+  std::vector<uint32_t> columns = output_columns;
+  std::sort(columns.begin(), columns.end());
+  columns.erase(std::unique(columns.begin(), columns.end()), columns.end());
+  // conditions joined by 'and' are pushed down into the scan, other trees are evaluated by the scan workers
+  ScanPredicate predicate(table_heap);
+  bool is_pushed_down = conditions == nullptr || PushDownConditions(conditions, table_info, predicate);
+  std::function<bool(const RowView &row)> filter;
+  if (!is_pushed_down && !CompileConditions(conditions->child_, table_info, filter)) {
+    return DB_FAILED;
+  }
+  std::ostringstream out;
+  for (size_t i = 0; i < output_columns.size(); i++) {
+    out << (i == 0 ? "" : " | ") << schema->GetColumn(output_columns[i])->GetName();
+  }
+  out << std::endl;
+  size_t row_count = 0;
+  auto output_row = [&out, &output_columns, &row_count](auto get_field) {
+    for (size_t i = 0; i < output_columns.size(); i++) {
+      out << (i == 0 ? "" : " | ") << FormatField(*get_field(output_columns[i]));
+    }
+    out << std::endl;
+    row_count++;
+  };
+  if (is_pushed_down && scan_dop_ == 1) {
+    // only the output columns of the matching tuples are deserialized, a page at a time
+    RowBatch batch;
+    auto table_iter = table_heap->Begin(context->txn_, predicate.IsEmpty() ? nullptr : &predicate, columns);
+    while (table_iter.NextBatch(batch, SCAN_BATCH_SIZE) > 0) {
+      for (size_t i = 0; i < batch.GetRowCount(); i++) {
+        output_row([&batch, i](uint32_t column) { return batch.GetField(i, column); });
+      }
+    }
+  } else {
+    // the table is scanned by scan_dop_ workers, the rows found are read with their output columns only
+    auto rids = is_pushed_down ? SeqScan(table_info, predicate, context->txn_)
+                               : SeqScan(table_info, filter, context->txn_);
+    for (auto &rid : rids) {
+      Row row(rid);
+      if (table_heap->GetTuple(&row, columns, context->txn_)) {
+        output_row([&row](uint32_t column) { return row.GetField(column); });
+      }
+    }
+  }
+  out << row_count << " rows in set" << std::endl;
+  std::cout << out.str();
+  return DB_SUCCESS;
+}
+
+/**
+ * Convert a list of values to the fields of a row of schema
+ * @param values first node of the list
+ * @return false if the number or types of the values do not match the columns
+ */
+static bool MakeFields(pSyntaxNode values, Schema *schema, std::vector<Field> &fields) {
+  fields.reserve(schema->GetColumnCount());
+  for (auto column : schema->GetColumns()) {
+    if (values == nullptr) {
+      return false;
+    }
+    TypeId type = column->GetType();
+    if (values->type_ == kNodeNull) {
+      if (!column->IsNullable()) {
+        return false;
+      }
+      fields.emplace_back(type);
+    } else if (type == TypeId::kTypeInt && values->type_ == kNodeNumber) {
+      char *end = nullptr;
+      int64_t integer = std::strtoll(values->val_, &end, 10);
+      if (end == values->val_ || *end != '\0' || integer < INT32_MIN || integer > INT32_MAX) {
+        return false;
+      }
+      fields.emplace_back(type, static_cast<int32_t>(integer));
+    } else if (type == TypeId::kTypeFloat && values->type_ == kNodeNumber) {
+      char *end = nullptr;
+      float f = std::strtof(values->val_, &end);
+      if (end == values->val_ || *end != '\0') {
+        return false;
+      }
+      fields.emplace_back(type, f);
+    } else if (type == TypeId::kTypeChar && values->type_ == kNodeString) {
+      uint32_t len = strlen(values->val_);
+      if (len > column->GetLength()) {
+        return false;
+      }
+      // copied into the row, so the field does not own the value
+      fields.emplace_back(type, values->val_, len, false);
+    } else {
+      return false;
+    }
+    values = values->next_;
+  }
+  return values == nullptr;
 }
 
 dberr_t ExecuteEngine::ExecuteInsert(pSyntaxNode ast, ExecuteContext *context) {
 #ifdef ENABLE_EXECUTE_DEBUG
   LOG(INFO) << "ExecuteInsert" << std::endl;
 #endif
-  return DB_FAILED;
+  auto iter = dbs_.find(current_db_);
+  if (iter == dbs_.end()) {
+    return DB_FAILED;
+  }
+  TableInfo *table_info = nullptr;
+  if (iter->second->catalog_mgr_->GetTable(ast->child_->val_, table_info) != DB_SUCCESS) {
+    return DB_TABLE_NOT_EXIST;
+  }
+  std::vector<Row> rows;
+  for (pSyntaxNode values = ast->child_->next_; values != nullptr; values = values->next_) {
+    ASSERT(values->type_ == kNodeColumnValues, "Unexpected node type.");
+    std::vector<Field> fields;
+    if (!MakeFields(values->child_, table_info->GetSchema(), fields)) {
+      return DB_FAILED;
+    }
+    rows.emplace_back(fields);
+  }
+  TableHeap *table_heap = table_info->GetTableHeap();
+  auto rids = table_heap->InsertTuples(rows, context->txn_);
+  if (rids.size() != rows.size()) {
+    // the statement inserts all of its rows or none of them
+    for (auto &rid : rids) {
+      table_heap->MarkDelete(rid, context->txn_);
+      table_heap->ApplyDelete(rid, context->txn_);
+    }
+    return DB_FAILED;
+  }
+  return DB_SUCCESS;
 }
 
 dberr_t ExecuteEngine::ExecuteDelete(pSyntaxNode ast, ExecuteContext *context) {
@@ -188,3 +403,117 @@ dberr_t ExecuteEngine::ExecuteQuit(pSyntaxNode ast, ExecuteContext *context) {
   context->flag_quit_ = true;
   return DB_SUCCESS;
 }
+
+std::vector<RowId> ExecuteEngine::SeqScan(TableInfo *table_info, const std::function<bool(const RowView &row)> &predicate,
+                                          Transaction *txn) {
+  ParallelTableScan scan(table_info->GetTableHeap(), scan_dop_);
+  return scan.Filter(predicate, txn);
+}
+
+std::vector<RowId> ExecuteEngine::SeqScan(TableInfo *table_info, const ScanPredicate &predicate, Transaction *txn) {
+  ParallelTableScan scan(table_info->GetTableHeap(), scan_dop_);
+  return scan.Filter(predicate, txn);
+}
+
+/**
+ * Compile a comparison of a column with a constant
+ * @return false if the comparison can not be pushed down
+ */
+static bool PushDownComparison(pSyntaxNode node, Schema *schema, ScanPredicate &predicate) {
+  if (node->type_ != kNodeCompareOperator || node->child_ == nullptr || node->child_->next_ == nullptr) {
+    return false;
+  }
+  pSyntaxNode column_node = node->child_;
+  pSyntaxNode value_node = column_node->next_;
+  uint32_t column;
+  if (column_node->type_ != kNodeIdentifier || schema->GetColumnIndex(column_node->val_, column) != DB_SUCCESS) {
+    return false;
+  }
+  std::string op = node->val_;
+  if (op == "is" || op == "not") {
+    if (value_node->type_ != kNodeNull) {
+      return false;
+    }
+    predicate.AddNullCheck(column, op == "is");
+    return true;
+  }
+  static const std::unordered_map<std::string, ScanPredicate::CompareOp> ops = {
+          {"=",  ScanPredicate::kEqual},
+          {"<>", ScanPredicate::kNotEqual},
+          {"<",  ScanPredicate::kLessThan},
+          {"<=", ScanPredicate::kLessThanEquals},
+          {">",  ScanPredicate::kGreaterThan},
+          {">=", ScanPredicate::kGreaterThanEquals}
+  };
+  auto it = ops.find(op);
+  if (it == ops.end()) {
+    return false;
+  }
+  TypeId type = schema->GetColumn(column)->GetType();
+  if (value_node->type_ == kNodeNull) {
+    // never satisfied, compared with a null value of the column type
+    predicate.AddComparison(column, it->second, Field(type));
+    return true;
+  }
+  std::string value = value_node->val_;
+  if (type == TypeId::kTypeInt && value_node->type_ == kNodeNumber &&
+      value.find_first_of(".eE") == std::string::npos && value.size() < 11) {
+    int64_t integer = std::stoll(value);
+    if (integer < INT32_MIN || integer > INT32_MAX) {
+      return false;
+    }
+    predicate.AddComparison(column, it->second, Field(type, static_cast<int32_t>(integer)));
+    return true;
+  }
+  if (type == TypeId::kTypeFloat && value_node->type_ == kNodeNumber) {
+    predicate.AddComparison(column, it->second, Field(type, std::stof(value)));
+    return true;
+  }
+  if (type == TypeId::kTypeChar && value_node->type_ == kNodeString) {
+    predicate.AddComparison(column, it->second, Field(type, value_node->val_, value.size(), false));
+    return true;
+  }
+  return false;
+}
+
+bool ExecuteEngine::PushDownConditions(pSyntaxNode conditions, TableInfo *table_info, ScanPredicate &predicate) {
+  ASSERT(conditions->type_ == kNodeConditions, "Unexpected node type.");
+  bool pushed_all = true;
+  std::vector<pSyntaxNode> nodes = {conditions->child_};
+  while (!nodes.empty()) {
+    pSyntaxNode node = nodes.back();
+    nodes.pop_back();
+    if (node->type_ == kNodeConnector && strcmp(node->val_, "and") == 0) {
+      for (pSyntaxNode child = node->child_; child != nullptr; child = child->next_) {
+        nodes.push_back(child);
+      }
+    } else if (!PushDownComparison(node, table_info->GetSchema(), predicate)) {
+      pushed_all = false;
+    }
+  }
+  return pushed_all;
+}
+
+bool ExecuteEngine::CompileConditions(pSyntaxNode node, TableInfo *table_info,
+                                      std::function<bool(const RowView &row)> &predicate) {
+  if (node->type_ == kNodeConnector) {
+    std::function<bool(const RowView &row)> left, right;
+    if (node->child_ == nullptr || node->child_->next_ == nullptr ||
+        !CompileConditions(node->child_, table_info, left) ||
+        !CompileConditions(node->child_->next_, table_info, right)) {
+      return false;
+    }
+    if (strcmp(node->val_, "and") == 0) {
+      predicate = [left, right](const RowView &row) { return left(row) && right(row); };
+    } else {
+      predicate = [left, right](const RowView &row) { return left(row) || right(row); };
+    }
+    return true;
+  }
+  auto comparison = std::make_shared<ScanPredicate>(table_info->GetTableHeap());
+  if (!PushDownComparison(node, table_info->GetSchema(), *comparison)) {
+    return false;
+  }
+  predicate = [comparison](const RowView &row) { return comparison->Evaluate(row); };
+  return true;
+}
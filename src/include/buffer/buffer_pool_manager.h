@@ -1,9 +1,11 @@
 #ifndef MINISQL_BUFFER_POOL_MANAGER_H
 #define MINISQL_BUFFER_POOL_MANAGER_H
 
+#include <condition_variable>
 #include <list>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "page/page.h"
@@ -18,39 +20,77 @@ public:
 
   ~BufferPoolManager();
 
-  Page *(page_id_t page_id);
+  /**
+   * Register the disk manager of a tablespace file, pages of the file are addressed by page ids carrying its file id.
+   * The disk manager of the database file is registered as DEFAULT_FILE_ID on construction.
+   */
+  void AddDiskManager(file_id_t file_id, DiskManager *disk_manager);
+
+  Page *FetchPage(page_id_t page_id);
 
   bool UnpinPage(page_id_t page_id, bool is_dirty);
 
   bool FlushPage(page_id_t page_id);
 
-  Page *NewPage(page_id_t &page_id);
+  /**
+   * Flush all dirty pages, pages of different files are written in parallel
+   */
+  void FlushAllPages();
+
+  /**
+   * Allocate a new page in the given tablespace file
+   */
+  Page *NewPage(page_id_t &page_id, file_id_t file_id = DEFAULT_FILE_ID);
 
   bool DeletePage(page_id_t page_id);
 
+  /**
+   * Delete a batch of pages, the pages of each file are deallocated together
+   * @return ids of the pages which are pinned and not deleted
+   */
+  std::vector<page_id_t> DeletePages(const std::vector<page_id_t> &page_ids);
+
   bool IsPageFree(page_id_t page_id);
 
   bool CheckAllUnpinned();
 
+  /**
+   * @return the size of pages in this buffer pool, which is the page size of the underlying database file
+   */
+  inline uint32_t GetPageSize() const { return disk_manager_->GetPageSize(); }
+
 private:
   /**
-   * Allocate new page (operations like create index/table) For now just keep an increasing counter
+   * Allocate new page (operations like create index/table) in the given file
    */
-  page_id_t AllocatePage();
+  page_id_t AllocatePage(file_id_t file_id);
 
   /**
    * Deallocate page (operations like drop index/table) Need bitmap in header page for tracking pages
    */
   void DeallocatePage(page_id_t page_id);
 
+  /**
+   * Disk manager of the file which the page belongs to
+   */
+  DiskManager *GetDiskManager(page_id_t page_id);
+
+  /**
+   * Find a frame from the free list first, then from the replacer. A dirty victim is written back and removed
+   * from the page table.
+   */
+  bool FindFreeFrame(frame_id_t *frame_id);
 
 private:
   size_t pool_size_;                                        // number of pages in buffer pool
   Page *pages_;                                             // array of pages
-  DiskManager *disk_manager_;                               // pointer to the disk manager.
+  DiskManager *disk_manager_;                               // pointer to the disk manager of the database file
+  std::vector<DiskManager *> disk_managers_;                // disk managers indexed by file id
   std::unordered_map<page_id_t, frame_id_t> page_table_;    // to keep track of pages
   Replacer *replacer_;                                      // to find an unpinned page for replacement
   std::list<frame_id_t> free_list_;                         // to find a free page for replacement
+  std::vector<bool> io_in_progress_;                        // frames being read in without holding the latch
+  std::condition_variable_any io_done_;                     // to wait for a frame being read in
   recursive_mutex latch_;                                   // to protect shared data structure
 };
 
@@ -1,9 +1,7 @@
 #ifndef MINISQL_LRU_REPLACER_H
 #define MINISQL_LRU_REPLACER_H
 
-#include <list>
 #include <mutex>
-#include <unordered_set>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -18,7 +16,7 @@ class LRUReplacer : public Replacer {
 public:
   /**
    * Create a new LRUReplacer.
-   * @param num_pages the maximum number of pages the LRUReplacer will be required to store
+   * @param num_pages the maximum number of pages the LRUReplacer will be required to store, frame ids are below it
    */
   explicit LRUReplacer(size_t num_pages);
 
@@ -36,7 +34,19 @@ public:
   size_t Size() override;
 
 private:
-  // add your own private member variables here
+  void Link(frame_id_t frame_id);
+
+  void Unlink(frame_id_t frame_id);
+
+private:
+  size_t capacity_;
+  size_t size_{0};
+  // frames form a circular list through prev_ and next_, least recently unpinned first, with a head node at index
+  // capacity_, so that pinning and unpinning do not allocate
+  std::vector<frame_id_t> prev_;
+  std::vector<frame_id_t> next_;
+  std::vector<bool> is_linked_;
+  std::mutex latch_;
 };
 
 #endif  // MINISQL_LRU_REPLACER_H
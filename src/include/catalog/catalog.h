@@ -10,6 +10,7 @@
 #include "catalog/table.h"
 #include "common/config.h"
 #include "common/dberr.h"
+#include "storage/page_reclaimer.h"
 #include "transaction/lock_manager.h"
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
@@ -71,7 +72,12 @@ public:
 
   ~CatalogManager();
 
-  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info);
+  /**
+   * @param file_id tablespace file the table heap is placed in
+   * @param format page format of the table heap
+   */
+  dberr_t CreateTable(const std::string &table_name, TableSchema *schema, Transaction *txn, TableInfo *&table_info,
+                      file_id_t file_id = DEFAULT_FILE_ID, TableFormat format = kRowFormat);
 
   dberr_t GetTable(const std::string &table_name, TableInfo *&table_info);
 
@@ -85,8 +91,18 @@ public:
 
   dberr_t GetTableIndexes(const std::string &table_name, std::vector<IndexInfo *> &indexes) const;
 
+  /**
+   * Drop a table, its pages are released in the background
+   */
   dberr_t DropTable(const std::string &table_name);
 
+  /**
+   * Delete all tuples of a table by swapping in an empty table heap, the pages of the old one are released in
+   * the background so that the latency does not depend on the size of the table. The zone map, dictionaries and
+   * append mode of the table are kept. Tables with indexes can not be truncated yet.
+   */
+  dberr_t TruncateTable(const std::string &table_name, Transaction *txn);
+
   dberr_t DropIndex(const std::string &table_name, const std::string &index_name);
 
 private:
@@ -113,6 +129,8 @@ private:
   [[maybe_unused]] std::unordered_map<index_id_t, IndexInfo *> indexes_;
   // memory heap
   MemHeap *heap_;
+  // releases the pages of dropped and truncated tables
+  PageReclaimer *page_reclaimer_;
 };
 
 #endif //MINISQL_CATALOG_H
@@ -73,6 +73,11 @@ public:
 
   inline IndexSchema *GetIndexKeySchema() { return key_schema_; }
 
+  /**
+   * @return codec of the keys of the index, compiled once with the key schema
+   */
+  inline const RowCodec &GetKeyCodec() const { return key_schema_->GetRowCodec(); }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline TableInfo *GetTableInfo() const { return table_info_; }
@@ -2,6 +2,7 @@
 #define MINISQL_TABLE_H
 
 #include <memory>
+#include <vector>
 
 #include "glog/logging.h"
 #include "record/schema.h"
@@ -18,7 +19,8 @@ public:
   static uint32_t DeserializeFrom(char *buf, TableMetadata *&table_meta, MemHeap *heap);
 
   static TableMetadata *Create(table_id_t table_id, std::string table_name,
-                               page_id_t root_page_id, TableSchema *schema, MemHeap *heap);
+                               page_id_t root_page_id, TableSchema *schema, MemHeap *heap,
+                               TableFormat format = kRowFormat);
 
   inline table_id_t GetTableId() const { return table_id_; }
 
@@ -28,11 +30,20 @@ public:
 
   inline Schema *GetSchema() const { return schema_; }
 
+  inline TableFormat GetFormat() const { return format_; }
+
+  /**
+   * @return first page of the dictionary of a column, INVALID_PAGE_ID if the column is not encoded
+   */
+  inline page_id_t GetDictionaryPageId(uint32_t column) const {
+    return column < dictionary_page_ids_.size() ? dictionary_page_ids_[column] : INVALID_PAGE_ID;
+  }
 
 private:
   TableMetadata() = delete;
 
-  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema);
+  TableMetadata(table_id_t table_id, std::string table_name, page_id_t root_page_id, TableSchema *schema,
+                TableFormat format);
 
 private:
   static constexpr uint32_t TABLE_METADATA_MAGIC_NUM = 344528;
@@ -40,6 +51,8 @@ private:
   std::string table_name_;
   page_id_t root_page_id_;
   Schema *schema_;
+  TableFormat format_;   /** page format of the table heap */
+  std::vector<page_id_t> dictionary_page_ids_;   /** first dictionary page of each column, empty if none is encoded */
 };
 
 /**
@@ -53,16 +66,53 @@ public:
   }
 
   ~TableInfo() {
+    // objects in heap_ are placement new-ed, so they are destroyed before their memory is released
+    if (table_heap_ != nullptr) {
+      table_heap_->~TableHeap();
+    }
+    if (table_meta_ != nullptr) {
+      table_meta_->~TableMetadata();
+    }
     delete heap_;
   }
 
+  /**
+   * The dictionaries kept in the table metadata are opened in the table heap, e.g. when the table is loaded
+   */
   void Init(TableMetadata *table_meta, TableHeap *table_heap) {
     table_meta_ = table_meta;
     table_heap_ = table_heap;
+    for (uint32_t i = 0; i < table_meta_->dictionary_page_ids_.size(); i++) {
+      if (table_meta_->dictionary_page_ids_[i] != INVALID_PAGE_ID && table_heap_->GetDictionary(i) == nullptr) {
+        table_heap_->OpenDictionary(i, table_meta_->dictionary_page_ids_[i]);
+      }
+    }
   }
 
   inline TableHeap *GetTableHeap() const { return table_heap_; }
 
+  /**
+   * Replace the table heap, e.g. by an empty one when the table is truncated, or by nullptr when it is dropped.
+   * The caller takes over the replaced table heap and destroys it.
+   * @return the replaced table heap
+   */
+  TableHeap *ResetTableHeap(TableHeap *table_heap) {
+    TableHeap *old_table_heap = table_heap_;
+    table_heap_ = table_heap;
+    table_meta_->root_page_id_ = table_heap == nullptr ? INVALID_PAGE_ID : table_heap->GetFirstPageId();
+    SaveDictionaryPageIds();
+    return old_table_heap;
+  }
+
+  /**
+   * Encode a char column in a dictionary of the table heap, see TableHeap::EnableDictionary. The first page of
+   * the dictionary is kept in the table metadata.
+   */
+  void EnableDictionary(uint32_t column) {
+    table_heap_->EnableDictionary(column);
+    SaveDictionaryPageIds();
+  }
+
   inline MemHeap *GetMemHeap() const { return heap_; }
 
   inline table_id_t GetTableId() const { return table_meta_->table_id_; }
@@ -71,14 +121,38 @@ public:
 
   inline Schema *GetSchema() const { return table_meta_->schema_; }
 
+  /**
+   * @return codec of the rows of the table, compiled once with the table schema
+   */
+  inline const RowCodec &GetRowCodec() const { return table_meta_->schema_->GetRowCodec(); }
+
   inline page_id_t GetRootPageId() const { return table_meta_->root_page_id_; }
 
+  inline TableFormat GetFormat() const { return table_meta_->format_; }
+
+  inline page_id_t GetDictionaryPageId(uint32_t column) const { return table_meta_->GetDictionaryPageId(column); }
+
 private:
   explicit TableInfo() : heap_(new SimpleMemHeap()) {};
 
+  /**
+   * Keep the first page of the dictionary of each column of the table heap in the table metadata
+   */
+  void SaveDictionaryPageIds() {
+    std::vector<page_id_t> &page_ids = table_meta_->dictionary_page_ids_;
+    page_ids.clear();
+    for (uint32_t i = 0; table_heap_ != nullptr && i < GetSchema()->GetColumnCount(); i++) {
+      ColumnDictionary *dictionary = table_heap_->GetDictionary(i);
+      if (dictionary != nullptr) {
+        page_ids.resize(GetSchema()->GetColumnCount(), INVALID_PAGE_ID);
+        page_ids[i] = dictionary->GetFirstPageId();
+      }
+    }
+  }
+
 private:
-  TableMetadata *table_meta_;
-  TableHeap *table_heap_;
+  TableMetadata *table_meta_{nullptr};
+  TableHeap *table_heap_{nullptr};
   MemHeap *heap_; /** store all objects allocated in table_meta and table heap */
 };
 
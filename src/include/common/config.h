@@ -12,12 +12,15 @@ static constexpr int INVALID_LSN = -1;               // invalid log sequence num
 static constexpr int META_PAGE_ID = 0;               // physical page id of the disk file meta info
 static constexpr int CATALOG_META_PAGE_ID = 0;       // logical page id of the catalog meta data
 static constexpr int INDEX_ROOTS_PAGE_ID = 1;        // logical page id of the index roots
+static constexpr int TABLESPACES_PAGE_ID = 2;        // logical page id of the tablespaces
 
-static constexpr int PAGE_SIZE = 4096;               // size of a data page in byte
+static constexpr int PAGE_SIZE = 4096;               // default size of a data page in byte
+static constexpr int MIN_PAGE_SIZE = 4096;           // smallest page size a database file can use
+static constexpr int MAX_PAGE_SIZE = 32768;          // largest page size a database file can use
 static constexpr int DEFAULT_BUFFER_POOL_SIZE = 1024;// default size of buffer pool
 
 static constexpr uint32_t FIELD_NULL_LEN = UINT32_MAX;
-static constexpr uint32_t VARCHAR_MAX_LEN = PAGE_SIZE / 2;    // max length of varchar
+static constexpr uint32_t VARCHAR_MAX_LEN = 1 << 20;            // max length of varchar, long values are stored in overflow pages
 
 // static std::string DB_META_FILE = "minisql.meta.db";
 
@@ -28,5 +31,30 @@ using lsn_t = int32_t;
 using column_id_t = uint32_t;
 using index_id_t = uint32_t;
 using table_id_t = uint32_t;
+using file_id_t = uint32_t;
+
+/**
+ * Page id of a page in a tablespace file (the default tablespace is the database file itself):
+ * | 0 (1bit) | file id (8bit) | page id in file (23bit) |
+ */
+static constexpr file_id_t DEFAULT_FILE_ID = 0;      // file id of the default tablespace
+static constexpr uint32_t MAX_FILE_NUM = 1 << 8;     // max number of tablespace files of a database
+static constexpr int LOCAL_PAGE_ID_BITS = 23;
+static constexpr page_id_t MAX_LOCAL_PAGE_ID = (1 << LOCAL_PAGE_ID_BITS) - 1;
+
+inline page_id_t MakePageId(file_id_t file_id, page_id_t local_page_id) {
+  return static_cast<page_id_t>(file_id << LOCAL_PAGE_ID_BITS) | local_page_id;
+}
+
+inline file_id_t GetFileId(page_id_t page_id) { return static_cast<file_id_t>(page_id) >> LOCAL_PAGE_ID_BITS; }
+
+inline page_id_t GetLocalPageId(page_id_t page_id) { return page_id & MAX_LOCAL_PAGE_ID; }
+
+/**
+ * Page size is chosen per database file when it is created, valid sizes are 4KB, 8KB, 16KB and 32KB.
+ */
+inline bool IsValidPageSize(uint32_t page_size) {
+  return page_size >= MIN_PAGE_SIZE && page_size <= MAX_PAGE_SIZE && (page_size & (page_size - 1)) == 0;
+}
 
 #endif  // MINISQL_CONFIG_H
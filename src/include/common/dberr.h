@@ -10,6 +10,8 @@ enum dberr_t {
   DB_INDEX_NOT_FOUND,
   DB_COLUMN_NAME_NOT_EXIST,
   DB_KEY_NOT_FOUND,
+  DB_TABLESPACE_ALREADY_EXIST,
+  DB_TABLESPACE_NOT_EXIST,
 };
 
 #endif //MINISQL_DBERR_H
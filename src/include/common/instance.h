@@ -3,53 +3,138 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
 #include "common/config.h"
 #include "common/dberr.h"
+#include "page/tablespaces_page.h"
 #include "storage/disk_manager.h"
 
 class DBStorageEngine {
 public:
+  /**
+   * @param page_size Page size of a newly created database, an existing database keeps its own page size
+   */
   explicit DBStorageEngine(std::string db_name, bool init = true,
-                           uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE)
+                           uint32_t buffer_pool_size = DEFAULT_BUFFER_POOL_SIZE, uint32_t page_size = PAGE_SIZE)
           : db_file_name_(std::move(db_name)), init_(init) {
     // Init database file if needed
     if (init_) {
       remove(db_file_name_.c_str());
     }
     // Initialize components
-    disk_mgr_ = new DiskManager(db_file_name_);
+    disk_mgr_ = new DiskManager(db_file_name_, page_size);
     bpm_ = new BufferPoolManager(buffer_pool_size, disk_mgr_);
-    catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
     // Allocate static page for db storage engine
     if (init) {
       page_id_t id;
       ASSERT(bpm_->IsPageFree(CATALOG_META_PAGE_ID), "Catalog meta page not free.");
       ASSERT(bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Header page not free.");
+      ASSERT(bpm_->IsPageFree(TABLESPACES_PAGE_ID), "Tablespaces page not free.");
       ASSERT(bpm_->NewPage(id) != nullptr && id == CATALOG_META_PAGE_ID, "Failed to allocate catalog meta page.");
       ASSERT(bpm_->NewPage(id) != nullptr && id == INDEX_ROOTS_PAGE_ID, "Failed to allocate header page.");
+      ASSERT(bpm_->NewPage(id) != nullptr && id == TABLESPACES_PAGE_ID, "Failed to allocate tablespaces page.");
       bpm_->UnpinPage(CATALOG_META_PAGE_ID, false);
       bpm_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
+      bpm_->UnpinPage(TABLESPACES_PAGE_ID, false);
     } else {
       ASSERT(!bpm_->IsPageFree(CATALOG_META_PAGE_ID), "Invalid catalog meta page.");
       ASSERT(!bpm_->IsPageFree(INDEX_ROOTS_PAGE_ID), "Invalid header page.");
+      ASSERT(!bpm_->IsPageFree(TABLESPACES_PAGE_ID), "Invalid tablespaces page.");
+      OpenTablespaces();
     }
+    // tables and indexes of other tablespaces can be loaded once their files are opened
+    catalog_mgr_ = new CatalogManager(bpm_, nullptr, nullptr, init);
   }
 
   ~DBStorageEngine() {
     delete catalog_mgr_;
     delete bpm_;
+    for (auto tablespace_mgr : tablespace_mgrs_) {
+      delete tablespace_mgr;
+    }
     delete disk_mgr_;
   }
 
+  /**
+   * Create a tablespace whose pages are stored in a separate data file
+   * @param path data file of the tablespace, an existing file is overwritten
+   */
+  dberr_t CreateTablespace(const std::string &name, const std::string &path, file_id_t &file_id) {
+    auto *tablespaces_page = reinterpret_cast<TablespacesPage *>(bpm_->FetchPage(TABLESPACES_PAGE_ID)->GetData());
+    if (tablespaces_page->GetFileId(name, &file_id)) {
+      bpm_->UnpinPage(TABLESPACES_PAGE_ID, false);
+      return DB_TABLESPACE_ALREADY_EXIST;
+    }
+    int count = tablespaces_page->GetTablespaceCount();
+    if (count >= TablespacesPage::GetMaxTablespaceCount(bpm_->GetPageSize()) ||
+        count + 1 >= static_cast<int>(MAX_FILE_NUM)) {
+      bpm_->UnpinPage(TABLESPACES_PAGE_ID, false);
+      return DB_FAILED;
+    }
+    file_id = count + 1;
+    if (!tablespaces_page->Insert(file_id, name, path)) {
+      bpm_->UnpinPage(TABLESPACES_PAGE_ID, false);
+      return DB_FAILED;
+    }
+    remove(path.c_str());
+    OpenTablespace(file_id, path);
+    bpm_->UnpinPage(TABLESPACES_PAGE_ID, true);
+    return DB_SUCCESS;
+  }
+
+  /**
+   * Tablespace named in CREATE TABLE ... TABLESPACE, the data file is placed next to the database file
+   */
+  dberr_t CreateTablespace(const std::string &name, file_id_t &file_id) {
+    return CreateTablespace(name, db_file_name_ + "." + name, file_id);
+  }
+
+  dberr_t GetTablespace(const std::string &name, file_id_t &file_id) {
+    auto *tablespaces_page = reinterpret_cast<TablespacesPage *>(bpm_->FetchPage(TABLESPACES_PAGE_ID)->GetData());
+    bool found = tablespaces_page->GetFileId(name, &file_id);
+    bpm_->UnpinPage(TABLESPACES_PAGE_ID, false);
+    return found ? DB_SUCCESS : DB_TABLESPACE_NOT_EXIST;
+  }
+
+  /**
+   * Print the I/O stats of the database file and every tablespace file
+   */
+  void DumpIOStats(std::ostream &os) {
+    os << "file: " << disk_mgr_->GetFileName() << std::endl;
+    disk_mgr_->GetIOStats().Dump(os);
+    for (auto tablespace_mgr : tablespace_mgrs_) {
+      os << "file: " << tablespace_mgr->GetFileName() << std::endl;
+      tablespace_mgr->GetIOStats().Dump(os);
+    }
+  }
+
+private:
+  void OpenTablespaces() {
+    auto *tablespaces_page = reinterpret_cast<TablespacesPage *>(bpm_->FetchPage(TABLESPACES_PAGE_ID)->GetData());
+    for (int i = 0; i < tablespaces_page->GetTablespaceCount(); i++) {
+      OpenTablespace(tablespaces_page->GetFileIdAt(i), tablespaces_page->GetPathAt(i));
+    }
+    bpm_->UnpinPage(TABLESPACES_PAGE_ID, false);
+  }
+
+  void OpenTablespace(file_id_t file_id, const std::string &path) {
+    auto *tablespace_mgr = new DiskManager(path, disk_mgr_->GetPageSize());
+    tablespace_mgrs_.push_back(tablespace_mgr);
+    bpm_->AddDiskManager(file_id, tablespace_mgr);
+  }
+
 public:
   DiskManager *disk_mgr_;
   BufferPoolManager *bpm_;
   CatalogManager *catalog_mgr_;
   std::string db_file_name_;
   bool init_;
+
+private:
+  std::vector<DiskManager *> tablespace_mgrs_;
 };
 
 #endif //MINISQL_INSTANCE_H
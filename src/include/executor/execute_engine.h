@@ -1,11 +1,16 @@
 #ifndef MINISQL_EXECUTE_ENGINE_H
 #define MINISQL_EXECUTE_ENGINE_H
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include "common/dberr.h"
 #include "common/instance.h"
+#include "record/row_pool.h"
+#include "record/row_view.h"
+#include "storage/scan_predicate.h"
 #include "transaction/transaction.h"
+#include "utils/mem_heap.h"
 
 extern "C" {
 #include "parser/parser.h"
@@ -20,6 +25,8 @@ extern "C" {
 struct ExecuteContext {
   bool flag_quit_{false};
   Transaction *txn_{nullptr};
+  ArenaMemHeap heap_;   /** memory of the statement, released at once when the context is destroyed */
+  RowPool row_pool_;   /** rows of the statement, reused from tuple to tuple */
 };
 
 /**
@@ -40,6 +47,13 @@ public:
    */
   dberr_t Execute(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Set the number of worker threads of a sequential scan
+   */
+  inline void SetScanParallelism(uint32_t dop) { scan_dop_ = dop; }
+
+  inline uint32_t GetScanParallelism() const { return scan_dop_; }
+
 private:
   dberr_t ExecuteCreateDatabase(pSyntaxNode ast, ExecuteContext *context);
 
@@ -55,14 +69,22 @@ private:
 
   dberr_t ExecuteDropTable(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteTruncateTable(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteShowIndexes(pSyntaxNode ast, ExecuteContext *context);
 
+  dberr_t ExecuteShowIOStats(pSyntaxNode ast, ExecuteContext *context);
+
   dberr_t ExecuteCreateIndex(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDropIndex(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteSelect(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Insert the rows of all value lists of the statement with one TableHeap::InsertTuples batch. There is no
+   * separate bulk load statement, files of data are loaded by multi-row inserts.
+   */
   dberr_t ExecuteInsert(pSyntaxNode ast, ExecuteContext *context);
 
   dberr_t ExecuteDelete(pSyntaxNode ast, ExecuteContext *context);
@@ -79,9 +101,41 @@ private:
 
   dberr_t ExecuteQuit(pSyntaxNode ast, ExecuteContext *context);
 
+  /**
+   * Sequential scan of a table with scan_dop_ workers, predicate is evaluated in the workers
+   * @return ids of the rows satisfying predicate
+   */
+  std::vector<RowId> SeqScan(TableInfo *table_info, const std::function<bool(const RowView &row)> &predicate,
+                             Transaction *txn);
+
+  /**
+   * Sequential scan of a table, pages are skipped by their zones if the table has a zone map, and tuples not
+   * satisfying predicate are skipped on their pages
+   */
+  std::vector<RowId> SeqScan(TableInfo *table_info, const ScanPredicate &predicate, Transaction *txn);
+
+  /**
+   * Compile the comparisons of single columns with constants in where conditions into predicate of a scan.
+   * Only comparisons joined by 'and' at the top of the condition tree are pushed down.
+   * @param conditions node of type kNodeConditions
+   * @return true if all conditions are pushed down, otherwise rows from the scan must still be checked
+   * against the conditions
+   */
+  static bool PushDownConditions(pSyntaxNode conditions, TableInfo *table_info, ScanPredicate &predicate);
+
+  /**
+   * Compile a tree of where conditions into a predicate evaluated on the tuples by the workers of a scan
+   * @param node root of the tree, a connector or a comparison
+   * @return false if a comparison is not of a column with a constant of its type
+   */
+  static bool CompileConditions(pSyntaxNode node, TableInfo *table_info,
+                                std::function<bool(const RowView &row)> &predicate);
+
 private:
   [[maybe_unused]] std::unordered_map<std::string, DBStorageEngine *> dbs_;  /** all opened databases */
   [[maybe_unused]] std::string current_db_;  /** current database */
+  uint32_t scan_dop_{1};  /** degree of parallelism of sequential scan */
+  static constexpr size_t SCAN_BATCH_SIZE = 256;  /** rows read at once by a sequential scan in one thread */
 };
 
 #endif //MINISQL_EXECUTE_ENGINE_H
@@ -41,6 +41,9 @@ public:
   // Remove a key and its value from this B+ tree.
   void Remove(const KeyType &key, Transaction *transaction = nullptr);
 
+  // Replace the value of a key in its leaf, the tree is not restructured.
+  bool Update(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
+
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction = nullptr);
 
@@ -65,7 +68,7 @@ public:
     }
     out << "digraph G {" << std::endl;
     Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
-    BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(root_page);
+    BPlusTreePage *node = reinterpret_cast<BPlusTreePage *>(root_page->GetData());
     ToGraph(node, buffer_pool_manager_, out);
     out << "}" << std::endl;
   }
@@ -80,7 +83,6 @@ private:
 
   template<typename N>
   N *Split(N *node);
-  N* FindbrotherPage(N *node,Transaction *transaction);
 
   template<typename N>
   bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
@@ -96,6 +98,9 @@ private:
 
   void UpdateRootPageId(int insert_record = 0);
 
+  // free the pages of the subtree rooted at the given page
+  void Destroy(page_id_t page_id);
+
   /* Debug Routines for FREE!! */
   void ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const;
 
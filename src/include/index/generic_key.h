@@ -2,20 +2,23 @@
 #define MINISQL_GENERIC_KEY_H
 
 #include <cstring>
+#include <vector>
 
 #include "record/row.h"
 #include "record/field.h"
+#include "record/row_view.h"
+#include "record/type_kernels.h"
 
 template<size_t KeySize>
 class GenericKey {
 public:
   inline void SerializeFromKey(const Row &key, Schema *schema) {
-    // initialize to 0
-    uint32_t size = key.GetSerializedSize(schema);
+    const RowCodec &codec = schema->GetRowCodec();
     ASSERT(key.GetFieldCount() == schema->GetColumnCount(), "field nums not match.");
-    ASSERT(size <= KeySize, "Index key size exceed max key size.");
-    memset(data, 0, KeySize);
-    key.SerializeTo(data, schema);
+    ASSERT(codec.GetSerializedSize(key.GetFields()) <= KeySize, "Index key size exceed max key size.");
+    // the codec zeroes the fixed part, only the bytes after the key are initialized here
+    uint32_t size = codec.SerializeTo(key.GetFields(), data);
+    memset(data + size, 0, KeySize - size);
   }
 
   inline void DeserializeToKey(Row &key, Schema *schema) const {
@@ -48,27 +51,26 @@ public:
 
 /**
  * Function object returns true if lhs < rhs, used for trees
+ *
+ * Keys are compared in their serialized form, with the kernel of every key column selected once from the key
+ * schema, so a comparison neither deserializes the keys nor makes virtual calls.
  */
 template<size_t KeySize>
 class GenericComparator {
 public:
   inline int operator()(const GenericKey<KeySize> &lhs,
                         const GenericKey<KeySize> &rhs) const {
-    int column_count = key_schema_->GetColumnCount();
-    Row lhs_key(INVALID_ROWID);
-    Row rhs_key(INVALID_ROWID);
-    lhs.DeserializeToKey(lhs_key, key_schema_);
-    rhs.DeserializeToKey(rhs_key, key_schema_);
-
-    for (int i = 0; i < column_count; i++) {
-      Field *lhs_value = lhs_key.GetField(i);
-      Field *rhs_value = rhs_key.GetField(i);
-
-      if (lhs_value->CompareLessThan(*rhs_value) == CmpBool::kTrue)
-        return -1;
-
-      if (lhs_value->CompareGreaterThan(*rhs_value) == CmpBool::kTrue)
-        return 1;
+    RowView lhs_key(const_cast<char *>(lhs.data), INVALID_ROWID, key_schema_);
+    RowView rhs_key(const_cast<char *>(rhs.data), INVALID_ROWID, key_schema_);
+    for (uint32_t i = 0; i < compares_.size(); i++) {
+      // a null value is neither less nor greater than another value
+      if (lhs_key.IsNull(i) || rhs_key.IsNull(i)) {
+        continue;
+      }
+      int result = compares_[i](lhs_key.GetFieldData(i), rhs_key.GetFieldData(i));
+      if (result != 0) {
+        return result < 0 ? -1 : 1;
+      }
     }
     // equals
     return 0;
@@ -76,13 +78,19 @@ public:
 
   GenericComparator(const GenericComparator &other) {
     this->key_schema_ = other.key_schema_;
+    this->compares_ = other.compares_;
   }
 
   // constructor
-  GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
+  GenericComparator(Schema *key_schema) : key_schema_(key_schema) {
+    for (uint32_t i = 0; i < key_schema_->GetColumnCount(); i++) {
+      compares_.push_back(GetSerializedCompare(key_schema_->GetColumn(i)->GetType()));
+    }
+  }
 
 private:
   Schema *key_schema_;
+  std::vector<SerializedCompare> compares_;   /** kernel of every key column */
 };
 
 #endif  // MINISQL_GENERIC_KEY_H
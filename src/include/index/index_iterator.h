@@ -5,12 +5,30 @@
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+/**
+ * Iterator over the key/value pairs of a B+ tree in key order. The leaf page of the current pair is pinned while
+ * the iterator is on it, the end iterator pins no page.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+
 public:
-  // you may define your own constructor based on your member variables
+  /**
+   * End iterator of any tree
+   */
   explicit IndexIterator();
 
+  /**
+   * Iterator at the index-th pair of a pinned leaf page, or at the first pair after it, the iterator takes over
+   * the pin of the page
+   */
+  explicit IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page, int index);
+
+  IndexIterator(const IndexIterator &other);
+
+  IndexIterator &operator=(const IndexIterator &other);
+
   ~IndexIterator();
 
   /** Return the key/value pair this iterator is currently pointing at. */
@@ -26,7 +44,17 @@ public:
   bool operator!=(const IndexIterator &itr) const;
 
 private:
-  // add your own private member variables here
+  /**
+   * Move to the next leaf page while the index is past the pairs of the current one
+   */
+  void SkipPage();
+
+  inline page_id_t GetPageId() const { return leaf_ == nullptr ? INVALID_PAGE_ID : leaf_->GetPageId(); }
+
+private:
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  LeafPage *leaf_{nullptr};   /** pinned leaf page of the current pair, nullptr at the end */
+  int index_{0};
 };
 
 
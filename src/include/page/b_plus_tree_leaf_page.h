@@ -28,7 +28,8 @@
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
 #define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE (((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType)) - 1)
+#define LEAF_PAGE_SIZE_OF(page_size) ((((page_size) - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType)) - 1)
+#define LEAF_PAGE_SIZE LEAF_PAGE_SIZE_OF(PAGE_SIZE)
 
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -53,6 +54,8 @@ public:
 
   bool Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const;
 
+  bool Update(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
 
   // Split and Merge utility methods
@@ -40,6 +40,11 @@ private:
    */
   bool IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const;
 
+  /**
+   * @return the first free page at or after page_offset (wrapping around), GetMaxSupportedSize() if extent is full.
+   */
+  uint32_t FindNextFreePage(uint32_t page_offset) const;
+
   /** Note: need to update if modify page structure. */
   static constexpr size_t MAX_CHARS = PageSize - 2 * sizeof(uint32_t);
 
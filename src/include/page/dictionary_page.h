@@ -0,0 +1,60 @@
+#ifndef MINISQL_DICTIONARY_PAGE_H
+#define MINISQL_DICTIONARY_PAGE_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "common/config.h"
+
+/**
+ * Dictionary pages of a column form a chain, entries hold the distinct values of the column in the order they
+ * were added, so the code of a value is the number of entries before it in the chain. Entries are of fixed
+ * width, a value takes its length and MAX_VALUE_LENGTH bytes.
+ *
+ * Format (size in byte):
+ *  -----------------------------------------------------------------------------
+ * | NextPageId (4) | EntryCount (4) | Value_1 length (4) | Value_1 (16) | ... |
+ *  -----------------------------------------------------------------------------
+ */
+class DictionaryPage {
+public:
+  static constexpr uint32_t MAX_VALUE_LENGTH = 16;
+
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetEntryCount() const { return count_; }
+
+  const char *GetValue(uint32_t index) const { return entries_[index].data_; }
+
+  uint32_t GetLength(uint32_t index) const { return entries_[index].len_; }
+
+  void Append(const char *data, uint32_t len) {
+    entries_[count_].len_ = len;
+    memcpy(entries_[count_].data_, data, len);
+    count_++;
+  }
+
+  /**
+   * @return the max number of entries a page of the given size can hold
+   */
+  static constexpr uint32_t GetMaxEntryCount(uint32_t page_size) { return (page_size - 8) / sizeof(Entry); }
+
+private:
+  struct Entry {
+    uint32_t len_;
+    char data_[MAX_VALUE_LENGTH];
+  };
+
+  page_id_t next_page_id_;
+  uint32_t count_;
+  Entry entries_[0];
+};
+
+#endif //MINISQL_DICTIONARY_PAGE_H
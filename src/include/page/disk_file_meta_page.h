@@ -5,10 +5,21 @@
 
 #include "page/bitmap_page.h"
 
-static constexpr page_id_t MAX_VALID_PAGE_ID = (PAGE_SIZE - 8) / 4 * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
-
+/**
+ * Disk file meta page format (size in byte):
+ *  ---------------------------------------------------------------------------------------
+ * | AllocatedPages (4) | ExtentNums (4) | PageSize (4) | Extent_1 used (4) | ... |
+ *  ---------------------------------------------------------------------------------------
+ */
 class DiskFileMetaPage {
 public:
+  /**
+   * @return The max number of extents a file with the given page size can hold.
+   */
+  static constexpr uint32_t GetMaxExtentNums(uint32_t page_size) {
+    return (page_size - SIZE_META_PAGE_HEADER) / sizeof(uint32_t);
+  }
+
   uint32_t GetExtentNums() {
     return num_extents_;
   }
@@ -24,10 +35,20 @@ public:
     return extent_used_page_[extent_id];
   }
 
+  uint32_t GetPageSize() {
+    return page_size_;
+  }
+
+  static constexpr uint32_t SIZE_META_PAGE_HEADER = 12;
+
 public:
   uint32_t num_allocated_pages_{0};
   uint32_t num_extents_{0};   // each extent consists with a bit map and BIT_MAP_SIZE pages
+  uint32_t page_size_{0};     // page size of the file, 0 means not initialized yet
   uint32_t extent_used_page_[0];
 };
 
+static constexpr page_id_t MAX_VALID_PAGE_ID =
+        DiskFileMetaPage::GetMaxExtentNums(PAGE_SIZE) * BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
+
 #endif //MINISQL_DISK_FILE_META_PAGE_H
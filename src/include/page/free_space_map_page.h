@@ -0,0 +1,63 @@
+#ifndef MINISQL_FREE_SPACE_MAP_PAGE_H
+#define MINISQL_FREE_SPACE_MAP_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * Free space map pages of a table heap form a chain, every entry records
+ * the free space bucket of one table page, in the order the pages were added. The entry of a page removed from
+ * the table heap has an invalid page id until the map is compacted.
+ *
+ * Format (size in byte):
+ *  --------------------------------------------------------------------------------
+ * | NextPageId (4) | EntryCount (4) | Page_1 id (4) | Page_1 bucket (4) | ... |
+ *  --------------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+public:
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    count_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetEntryCount() const { return count_; }
+
+  page_id_t GetPageId(uint32_t index) const { return entries_[index].page_id_; }
+
+  uint32_t GetBucket(uint32_t index) const { return entries_[index].bucket_; }
+
+  void SetBucket(uint32_t index, uint32_t bucket) { entries_[index].bucket_ = bucket; }
+
+  void SetPageId(uint32_t index, page_id_t page_id) { entries_[index].page_id_ = page_id; }
+
+  void Append(page_id_t page_id, uint32_t bucket) {
+    entries_[count_].page_id_ = page_id;
+    entries_[count_].bucket_ = bucket;
+    count_++;
+  }
+
+  void Clear() { count_ = 0; }
+
+  /**
+   * @return the max number of entries a page of the given size can hold
+   */
+  static constexpr uint32_t GetMaxEntryCount(uint32_t page_size) { return (page_size - 8) / 8; }
+
+private:
+  struct Entry {
+    page_id_t page_id_;
+    uint32_t bucket_;
+  };
+
+  page_id_t next_page_id_;
+  uint32_t count_;
+  Entry entries_[0];
+};
+
+#endif //MINISQL_FREE_SPACE_MAP_PAGE_H
@@ -20,7 +20,11 @@ public:
     count_ = 0;
   }
 
-  bool Insert(const index_id_t index_id, const page_id_t root_id);
+  /**
+   * @param page_size size of the page, which bounds the number of index roots
+   * @return false if the index id exists or the page is full
+   */
+  bool Insert(const index_id_t index_id, const page_id_t root_id, uint32_t page_size);
 
   bool Delete(const index_id_t index_id);
 
@@ -31,9 +35,12 @@ public:
 
   int GetIndexCount() { return count_; }
 
-private:
-  static constexpr int MAX_INDEX_COUNT = (PAGE_SIZE - 4) / 8;
+  /**
+   * @return the max number of index roots a page of the given size can hold
+   */
+  static constexpr int GetMaxIndexCount(uint32_t page_size) { return (page_size - 4) / 8; }
 
+private:
   int FindIndex(const index_id_t index_id);
 
 private:
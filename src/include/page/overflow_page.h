@@ -0,0 +1,45 @@
+#ifndef MINISQL_OVERFLOW_PAGE_H
+#define MINISQL_OVERFLOW_PAGE_H
+
+#include <cstdint>
+
+#include "common/config.h"
+
+/**
+ * A char value too long to be stored in row is split into a chain of overflow pages,
+ * the row only keeps the length of the value and the id of the first page
+ *
+ * Format (size in byte):
+ *  ---------------------------------------------
+ * | NextPageId (4) | DataSize (4) | Data ... |
+ *  ---------------------------------------------
+ */
+class OverflowPage {
+public:
+  void Init() {
+    next_page_id_ = INVALID_PAGE_ID;
+    size_ = 0;
+  }
+
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  uint32_t GetDataSize() const { return size_; }
+
+  void SetDataSize(uint32_t size) { size_ = size; }
+
+  char *GetData() { return data_; }
+
+  /**
+   * @return the max number of value bytes a page of the given size can hold
+   */
+  static constexpr uint32_t GetMaxDataSize(uint32_t page_size) { return page_size - 8; }
+
+private:
+  page_id_t next_page_id_;
+  uint32_t size_;
+  char data_[0];
+};
+
+#endif //MINISQL_OVERFLOW_PAGE_H
@@ -21,14 +21,20 @@ public:
   DISALLOW_COPY(Page)
 
   /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  Page() : Page(PAGE_SIZE) {}
 
-  /** Default destructor. */
-  ~Page() = default;
+  /** Constructor for a page of the given size. Zeros out the page data. */
+  explicit Page(uint32_t page_size) : data_(new char[page_size]), page_size_(page_size) { ResetMemory(); }
+
+  /** Destructor. Releases the page data. */
+  ~Page() { delete[] data_; }
 
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
 
+  /** @return the size in byte of the data held by this page */
+  inline uint32_t GetPageSize() { return page_size_; }
+
   /** @return the page id of this page */
   inline page_id_t GetPageId() { return page_id_; }
 
@@ -66,10 +72,23 @@ protected:
 
 private:
   /** Zeroes out the data that is held within the page. */
-  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, page_size_); }
+
+  /** Re-allocates the data of this page to hold page_size bytes, used by buffer pool for non-default page sizes. */
+  inline void ResizeMemory(uint32_t page_size) {
+    if (page_size == page_size_) {
+      return;
+    }
+    delete[] data_;
+    data_ = new char[page_size];
+    page_size_ = page_size;
+    ResetMemory();
+  }
 
   /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  char *data_;
+  /** The size of the data, equals to the page size of the database file. */
+  uint32_t page_size_;
   /** The ID of this page. */
   page_id_t page_id_ = INVALID_PAGE_ID;
   /** The pin count of this page. */
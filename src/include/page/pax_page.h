@@ -0,0 +1,261 @@
+#ifndef MINISQL_PAX_PAGE_H
+#define MINISQL_PAX_PAGE_H
+/**
+ * Table page in PAX format, the values of each column are kept together in a minipage:
+ *  -----------------------------------------------------------------------------------------
+ *  | HEADER | BITMAPS | Minipage 1 | ... | Minipage N | ... FREE SPACE ... | CHAR VALUES |
+ *  -----------------------------------------------------------------------------------------
+ *                                                      ^ fixed area end   ^ char data pointer
+ *
+ *  Header format (size in bytes):
+ *  -----------------------------------------------------------------------------------------------
+ *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| CharDataPointer (4)| TupleCount (4) |
+ *  -----------------------------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------------
+ *  | FreeSpaceMapPageId (4) | Capacity (4) | ColumnCount (4) | FixedAreaEnd (4) |
+ *  ----------------------------------------------------------------------------------
+ *  ----------------------------------------------------------------------------
+ *  | Minipage_1 offset (4) | ... | Minipage_N offset (4) | Used bitmap | Deleted bitmap |
+ *  ----------------------------------------------------------------------------
+ *  Minipage format:
+ *  ---------------------------------------------------
+ *  | Null bitmap | Value_1 | ... | Value_Capacity |
+ *  ---------------------------------------------------
+ *  Int and float values are stored in the minipage of their column. Char values are serialized as in a row at
+ *  the end of the page, the minipage of a char column holds the offset of the value of each slot.
+ *
+ *  The layout is decided by the schema and Capacity, the max number of tuples in the page, when the page is
+ *  initialized. Every bitmap has a bit per slot and is padded to 4 bytes. Page id, prev/next page id and
+ *  FreeSpaceMapPageId are at the same offsets as in TablePage.
+ *
+ *  Char values of deleted or updated tuples are left as garbage, until an insert or update needs the space and
+ *  the char values are compacted.
+ **/
+
+#include <cstring>
+#include <vector>
+
+#include "common/macros.h"
+#include "common/rowid.h"
+#include "page/page.h"
+#include "record/row.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+
+class RowView;
+
+class ScanPredicate;
+
+class PaxPage : public Page {
+public:
+  /**
+   * @param char_size expected serialized size of the char values of a tuple
+   * @return max number of tuples of schema in a page
+   */
+  static uint32_t GetCapacity(uint32_t page_size, Schema *schema, uint32_t char_size);
+
+  void Init(page_id_t page_id, page_id_t prev_id, Schema *schema, uint32_t capacity, LogManager *log_mgr,
+            Transaction *txn);
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  page_id_t GetPrevPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_PREV_PAGE_ID); }
+
+  page_id_t GetNextPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_NEXT_PAGE_ID); }
+
+  void SetPrevPageId(page_id_t prev_page_id) {
+    memcpy(GetData() + OFFSET_PREV_PAGE_ID, &prev_page_id, sizeof(page_id_t));
+  }
+
+  void SetNextPageId(page_id_t next_page_id) {
+    memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
+  }
+
+  /**
+   * @return the first free space map page of the table heap, only valid in its first page
+   */
+  page_id_t GetFreeSpaceMapPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_FSM_PAGE_ID); }
+
+  void SetFreeSpaceMapPageId(page_id_t page_id) {
+    memcpy(GetData() + OFFSET_FSM_PAGE_ID, &page_id, sizeof(page_id_t));
+  }
+
+  bool InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  /**
+   * Insert rows in [begin, end) until the page is full
+   * @return number of rows inserted, the rid of each inserted row is wrapped in it
+   */
+  size_t InsertTuples(std::vector<Row> &rows, size_t begin, size_t end, Schema *schema, Transaction *txn,
+                      LockManager *lock_manager, LogManager *log_manager);
+
+  bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  bool UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
+                   Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
+
+  void ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  void RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager);
+
+  bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
+
+  /**
+   * Read a tuple even if it is marked deleted
+   * @return false if the slot is free
+   */
+  bool GetStoredTuple(Row *row, Schema *schema);
+
+  /**
+   * Point view at a tuple in this page
+   * @return false if the tuple is deleted
+   */
+  bool GetTupleView(const RowId &rid, RowView &view);
+
+  /**
+   * @return number of slots up to the last used one
+   */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
+  uint32_t GetCapacity() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CAPACITY); }
+
+  bool GetFirstTupleRid(RowId *first_rid);
+
+  /**
+   * @return rids of the tuples marked deleted
+   */
+  std::vector<RowId> GetDeletedRids();
+
+  /**
+   * @return true if no slot is used
+   */
+  bool IsEmpty();
+
+  /**
+   * Move the char values of used slots to the end of the page so that the garbage joins the free space
+   * @return free space for char values after compaction
+   */
+  uint32_t CompactCharData(Schema *schema);
+
+  bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
+
+  /**
+   * Find the first tuple from slot on which satisfies predicate
+   * @param predicate a null predicate is satisfied by every tuple
+   * @return false if no tuple is found
+   */
+  bool FindTupleRid(uint32_t slot, const ScanPredicate *predicate, Schema *schema, RowId *rid);
+
+  /**
+   * @return space for char values if a slot is free, otherwise 0
+   */
+  uint32_t GetTotalFreeSpace();
+
+  /**
+   * @return serialized size of the char values of a row
+   */
+  static uint32_t GetCharSize(const Row &row, Schema *schema);
+
+  /**
+   * @return average serialized size of the char values of the tuples in this page
+   */
+  uint32_t GetAverageCharSize();
+
+  /**
+   * @return true if slot holds a tuple which is not deleted
+   */
+  inline bool IsLive(uint32_t slot) {
+    return GetBit(GetUsedBitmap(), slot) && !GetBit(GetDeletedBitmap(), slot);
+  }
+
+  inline bool IsNull(uint32_t slot, uint32_t column) { return GetBit(GetNullBitmap(column), slot); }
+
+  /**
+   * @return serialized value of a non-null field
+   */
+  inline char *GetFieldData(uint32_t slot, uint32_t column, TypeId type) {
+    if (type == TypeId::kTypeChar) {
+      return GetData() + reinterpret_cast<uint32_t *>(GetColumnValues(column))[slot];
+    }
+    return GetColumnValues(column) + slot * Type::GetTypeSize(type);
+  }
+
+  /**
+   * @return values of all slots of a column, for a char column the offsets of the values in this page
+   */
+  inline char *GetColumnValues(uint32_t column) { return GetNullBitmap(column) + GetBitmapSize(GetCapacity()); }
+
+  inline const char *GetNullBitmap(uint32_t column) const {
+    return const_cast<PaxPage *>(this)->GetNullBitmap(column);
+  }
+
+  inline char *GetNullBitmap(uint32_t column) {
+    return GetData() + reinterpret_cast<uint32_t *>(GetData() + OFFSET_MINIPAGE_OFFSETS)[column];
+  }
+
+  /**
+   * @return bitmap of the slots holding a tuple, including the ones marked deleted
+   */
+  inline char *GetUsedBitmap() { return GetData() + OFFSET_MINIPAGE_OFFSETS + sizeof(uint32_t) * GetColumnCount(); }
+
+  inline char *GetDeletedBitmap() { return GetUsedBitmap() + GetBitmapSize(GetCapacity()); }
+
+  static inline bool GetBit(const char *bitmap, uint32_t i) { return (bitmap[i / 8] >> (i % 8)) & 1; }
+
+  /**
+   * @return size of a bitmap of count bits, padded to 4 bytes
+   */
+  static inline uint32_t GetBitmapSize(uint32_t count) { return (count + 31) / 32 * 4; }
+
+private:
+  uint32_t GetCharDataPointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_CHAR_DATA); }
+
+  void SetCharDataPointer(uint32_t offset) { memcpy(GetData() + OFFSET_CHAR_DATA, &offset, sizeof(uint32_t)); }
+
+  void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
+
+  uint32_t GetColumnCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_COLUMN_COUNT); }
+
+  uint32_t GetFixedAreaEnd() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FIXED_AREA_END); }
+
+  uint32_t GetFreeCharSpace() { return GetCharDataPointer() - GetFixedAreaEnd(); }
+
+  static inline void SetBit(char *bitmap, uint32_t i, bool value) {
+    if (value) {
+      bitmap[i / 8] |= static_cast<char>(1 << (i % 8));
+    } else {
+      bitmap[i / 8] &= static_cast<char>(~(1 << (i % 8)));
+    }
+  }
+
+  /**
+   * @return first free slot, or INVALID_SLOT if the page is full
+   */
+  uint32_t FindFreeSlot();
+
+  /**
+   * @return serialized size of the char values of the tuple in slot
+   */
+  uint32_t GetCharSize(uint32_t slot, Schema *schema);
+
+  /**
+   * Write the values of row to a free slot, the char values must fit in the free space
+   */
+  void WriteTuple(uint32_t slot, const Row &row, Schema *schema);
+
+private:
+  static_assert(sizeof(page_id_t) == 4);
+  static constexpr uint32_t INVALID_SLOT = static_cast<uint32_t>(-1);
+  static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
+  static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
+  static constexpr size_t OFFSET_CHAR_DATA = 16;
+  static constexpr size_t OFFSET_TUPLE_COUNT = 20;
+  static constexpr size_t OFFSET_FSM_PAGE_ID = 24;
+  static constexpr size_t OFFSET_CAPACITY = 28;
+  static constexpr size_t OFFSET_COLUMN_COUNT = 32;
+  static constexpr size_t OFFSET_FIXED_AREA_END = 36;
+  static constexpr size_t OFFSET_MINIPAGE_OFFSETS = 40;
+};
+
+#endif //MINISQL_PAX_PAGE_H
@@ -12,12 +12,27 @@
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  ---------------------------------------------------------------------------------------
+ *  | TupleCount (4) | FreeSpaceMapPageId (4) | FreeSlotHead (4) | FragmentedSpace (4) |
+ *  ---------------------------------------------------------------------------------------
+ *  ----------------------------------------------------
+ *  | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  ----------------------------------------------------
+ *  FreeSpaceMapPageId is only used in the first page of a table heap.
+ *
+ *  Slots of deleted tuples form a free slot chain starting from FreeSlotHead, the offset of a free slot holds
+ *  the next free slot. Storage of deleted tuples is left as holes counted by FragmentedSpace, until an insert
+ *  or update needs it and the page is compacted.
+ *
+ *  A tuple which no longer fits in its page after an update is moved to another page, and its slot keeps a
+ *  forward record holding the RowId of the moved tuple, so the RowId of the tuple does not change. A moved
+ *  tuple is prefixed by the RowId of its home slot. Forward records and moved tuples are flagged in their size,
+ *  scans skip forward records and read moved tuples where they are.
  **/
 
 #include <cstring>
+#include <vector>
+
 #include "common/macros.h"
 #include "common/rowid.h"
 #include "page/page.h"
@@ -26,6 +41,10 @@
 #include "transaction/log_manager.h"
 #include "transaction/transaction.h"
 
+class RowView;
+
+class ScanPredicate;
+
 class TablePage : public Page {
 public:
   void Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn);
@@ -46,6 +65,19 @@ public:
 
   bool InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Insert a tuple moved from home_rid, whose slot keeps a forward record of its new location
+   * @param[in/out] row the location of the moved tuple is wrapped in it
+   */
+  bool InsertMovedTuple(Row &row, const RowId &home_rid, Schema *schema);
+
+  /**
+   * Insert rows in [begin, end) until the page is full
+   * @return number of rows inserted, the rid of each inserted row is wrapped in it
+   */
+  size_t InsertTuples(std::vector<Row> &rows, size_t begin, size_t end, Schema *schema, Transaction *txn,
+                      LockManager *lock_manager, LogManager *log_manager);
+
   bool MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
   bool UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
@@ -57,10 +89,100 @@ public:
 
   bool GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * @param[out] target_rid location of the moved tuple if rid holds a forward record
+   * @return true if rid holds a forward record
+   */
+  bool GetForwardRid(const RowId &rid, RowId *target_rid);
+
+  /**
+   * Replace the tuple in rid by a forward record of target_rid, a forward record in rid is pointed at target_rid
+   * @param[out] old_row the replaced tuple, untouched if rid already holds a forward record
+   * @return false if the tuple is deleted or the page has no room for the record
+   */
+  bool ForwardTuple(const RowId &rid, const RowId &target_rid, Row *old_row, Schema *schema);
+
+  /**
+   * Replace the forward record in rid by row, which moves back to its home slot
+   * @return false if the page has no room for row
+   */
+  bool RestoreTuple(const RowId &rid, const Row &row, Schema *schema);
+
+  /**
+   * Read a tuple even if it is marked deleted, used to release the overflow pages of its values
+   * @return false if the slot is free
+   */
+  bool GetStoredTuple(Row *row, Schema *schema);
+
+  /**
+   * @return serialized data of a tuple in this page, nullptr if the tuple is deleted or moved to another page
+   */
+  char *GetTupleData(const RowId &rid);
+
+  /**
+   * Point view at a tuple in this page, the view of a moved tuple has the RowId of its home slot
+   * @return false if the tuple is deleted or moved to another page
+   */
+  bool GetTupleView(const RowId &rid, RowView &view);
+
+  /**
+   * @return number of slots in the slot directory, including free ones
+   */
+  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
+
   bool GetFirstTupleRid(RowId *first_rid);
 
+  /**
+   * @return rids of the tuples marked deleted, the rid of its home slot for a moved tuple
+   */
+  std::vector<RowId> GetDeletedRids();
+
+  /**
+   * @return true if no slot holds a tuple or a forward record
+   */
+  bool IsEmpty();
+
   bool GetNextTupleRid(const RowId &cur_rid, RowId *next_rid);
 
+  /**
+   * Find the first tuple from slot on which satisfies predicate, tuples are evaluated in place without being
+   * deserialized
+   * @param predicate a null predicate is satisfied by every tuple
+   * @return false if no tuple is found
+   */
+  bool FindTupleRid(uint32_t slot, const ScanPredicate *predicate, Schema *schema, RowId *rid);
+
+  /**
+   * @return the max serialized size of a row which fits in this page
+   */
+  uint32_t GetMaxRowSize() { return GetMaxRowSize(GetPageSize()); }
+
+  static uint32_t GetMaxRowSize(uint32_t page_size) { return page_size - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE; }
+
+  /**
+   * @return the first free space map page of the table heap, only valid in its first page
+   */
+  page_id_t GetFreeSpaceMapPageId() { return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_FSM_PAGE_ID); }
+
+  void SetFreeSpaceMapPageId(page_id_t page_id) {
+    memcpy(GetData() + OFFSET_FSM_PAGE_ID, &page_id, sizeof(page_id_t));
+  }
+
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /**
+   * @return contiguous free space plus holes left by deleted tuples, available to inserts after compaction
+   */
+  uint32_t GetTotalFreeSpace() { return GetFreeSpaceRemaining() + GetFragmentedSpace(); }
+
+  /**
+   * Move all tuples to the end of the page so that holes left by deleted tuples join the free space.
+   * Slot numbers do not change.
+   */
+  void Compact();
+
 private:
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
 
@@ -68,13 +190,15 @@ private:
     memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
   }
 
-  uint32_t GetTupleCount() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_COUNT); }
-
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
+  uint32_t GetFreeSlotHead() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SLOT_HEAD); }
+
+  void SetFreeSlotHead(uint32_t slot_num) { memcpy(GetData() + OFFSET_FREE_SLOT_HEAD, &slot_num, sizeof(uint32_t)); }
+
+  uint32_t GetFragmentedSpace() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FRAGMENTED_SPACE); }
+
+  void SetFragmentedSpace(uint32_t size) { memcpy(GetData() + OFFSET_FRAGMENTED_SPACE, &size, sizeof(uint32_t)); }
 
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -92,26 +216,67 @@ private:
     memcpy(GetData() + OFFSET_TUPLE_SIZE + SIZE_TUPLE * slot_num, &size, sizeof(uint32_t));
   }
 
+  /**
+   * @return RowId of the home slot of the moved tuple in slot_num
+   */
+  RowId GetHomeRid(uint32_t slot_num) {
+    return RowId(*reinterpret_cast<int64_t *>(GetData() + GetTupleOffsetAtSlot(slot_num)));
+  }
+
+  /**
+   * Take storage of size for a new slot, the page is compacted if needed
+   * @return the new slot, or INVALID_SLOT if the page is full
+   */
+  uint32_t AllocateTuple(uint32_t size);
+
+  /**
+   * Resize the storage of a slot, the page is compacted if needed. The content of the storage is not kept.
+   * @return false if the page has no room
+   */
+  bool ResizeTuple(uint32_t slot_num, uint32_t size);
+
   static bool IsDeleted(uint32_t tuple_size) { return static_cast<bool>(tuple_size & DELETE_MASK) || tuple_size == 0; }
 
   static uint32_t SetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size | DELETE_MASK); }
 
   static uint32_t UnsetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size & (~DELETE_MASK)); }
 
+  static bool IsForward(uint32_t tuple_size) { return (tuple_size & FORWARD_MASK) != 0; }
+
+  static bool IsMoved(uint32_t tuple_size) { return (tuple_size & MOVED_MASK) != 0; }
+
+  /**
+   * @return true if the tuple is read by scans, i.e. neither deleted nor moved to another page
+   */
+  static bool IsVisible(uint32_t tuple_size) { return !IsDeleted(tuple_size) && !IsForward(tuple_size); }
+
+  /**
+   * @return size of the storage of a tuple without flags
+   */
+  static uint32_t GetStoredSize(uint32_t tuple_size) { return tuple_size & SIZE_MASK; }
+
 private:
   static_assert(sizeof(page_id_t) == 4);
   static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
-  static constexpr size_t SIZE_TUPLE = 8;
+  static constexpr uint32_t FORWARD_MASK = 1U << 30;   /** the slot holds a forward record */
+  static constexpr uint32_t MOVED_MASK = 1U << 29;   /** the slot holds a moved tuple */
+  static constexpr uint32_t SIZE_MASK = MOVED_MASK - 1;
+  static constexpr uint32_t SIZE_RID = sizeof(int64_t);   /** size of a forward record or the prefix of a moved tuple */
+  static constexpr uint32_t INVALID_SLOT = static_cast<uint32_t>(-1);
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 36;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FSM_PAGE_ID = 24;
+  static constexpr size_t OFFSET_FREE_SLOT_HEAD = 28;
+  static constexpr size_t OFFSET_FRAGMENTED_SPACE = 32;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 36;
+  static constexpr size_t OFFSET_TUPLE_SIZE = 40;
 
 public:
-  static constexpr size_t SIZE_MAX_ROW = PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE;
+  /** Space taken by the slot of a tuple */
+  static constexpr size_t SIZE_TUPLE = 8;
 };
 
 #endif
\ No newline at end of file
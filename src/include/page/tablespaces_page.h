@@ -0,0 +1,60 @@
+#ifndef MINISQL_TABLESPACES_PAGE_H
+#define MINISQL_TABLESPACES_PAGE_H
+
+#include <string>
+
+#include "common/config.h"
+
+/**
+ * Database use the one as tablespaces page to store the data file of
+ * every tablespace, the default tablespace (the database file) is not recorded
+ *
+ * Format (size in byte):
+ *  -------------------------------------------------------------------------------------
+ * | RecordCount (4) | File_1 id (4) | File_1 name (64) | File_1 path (256) | File_2 id (4) | ... |
+ *  -------------------------------------------------------------------------------------
+ */
+class TablespacesPage {
+public:
+  static constexpr uint32_t MAX_NAME_LEN = 63;
+  static constexpr uint32_t MAX_PATH_LEN = 255;
+
+  void Init() {
+    count_ = 0;
+  }
+
+  bool Insert(const file_id_t file_id, const std::string &name, const std::string &path);
+
+  // return file_id if success
+  bool GetFileId(const std::string &name, file_id_t *file_id);
+
+  int GetTablespaceCount() { return count_; }
+
+  file_id_t GetFileIdAt(int index) { return records_[index].file_id_; }
+
+  std::string GetNameAt(int index) { return records_[index].name_; }
+
+  std::string GetPathAt(int index) { return records_[index].path_; }
+
+  /**
+   * @return the max number of tablespaces a page of the given size can hold
+   */
+  static constexpr int GetMaxTablespaceCount(uint32_t page_size) {
+    return (page_size - 4) / sizeof(TablespaceRecord);
+  }
+
+private:
+  int FindTablespace(const std::string &name);
+
+private:
+  struct TablespaceRecord {
+    file_id_t file_id_;
+    char name_[MAX_NAME_LEN + 1];
+    char path_[MAX_PATH_LEN + 1];
+  };
+
+  int count_;
+  TablespaceRecord records_[0];
+};
+
+#endif //MINISQL_TABLESPACES_PAGE_H
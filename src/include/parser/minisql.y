@@ -11,22 +11,22 @@
 	pSyntaxNode syntax_node;
 }
 
-%token <syntax_node> CREATE DROP SELECT INSERT DELETE UPDATE
+%token <syntax_node> CREATE DROP TRUNCATE SELECT INSERT DELETE UPDATE
 %token <syntax_node> TRXBEGIN TRXCOMMIT TRXROLLBACK QUIT EXECFILE SHOW USE USING
-%token <syntax_node> DATABASE DATABASES TABLE TABLES INDEX INDEXES
+%token <syntax_node> DATABASE DATABASES TABLE TABLES TABLESPACE INDEX INDEXES IOSTATS
 %token <syntax_node> ON FROM WHERE INTO SET VALUES PRIMARY KEY UNIQUE
 %token <syntax_node> CHAR INT FLOAT AND OR NOT IS FLAGNULL
 %token <syntax_node> IDENTIFIER STRING NUMBER EQ NE LE GE
 
 %type <syntax_node> start sql
 %type <syntax_node> sql_create_database sql_drop_database sql_show_databases sql_use_database
-%type <syntax_node> sql_show_tables sql_create_table sql_drop_table
+%type <syntax_node> sql_show_tables sql_create_table sql_drop_table sql_truncate_table
 %type <syntax_node> column_definition_list column_definition column_type column_list
-%type <syntax_node> sql_create_index sql_drop_index sql_show_indexes
+%type <syntax_node> sql_create_index sql_drop_index sql_show_indexes sql_show_iostats
 %type <syntax_node> sql_trx_begin sql_trx_commit sql_trx_rollback
 %type <syntax_node> sql_select select_columns column_values column_value operator
 %type <syntax_node> connector where_conditions where_condition
-%type <syntax_node> sql_insert sql_delete sql_update update_values update_value
+%type <syntax_node> sql_insert value_lists sql_delete sql_update update_values update_value
 %type <syntax_node> sql_quit sql_exec_file
 
 %%
@@ -46,9 +46,11 @@ sql:
   | sql_show_tables { $$ = $1; }
   | sql_create_table { $$ = $1; }
   | sql_drop_table { $$ = $1; }
+  | sql_truncate_table { $$ = $1; }
   | sql_create_index { $$ = $1; }
   | sql_drop_index { $$ = $1; }
   | sql_show_indexes { $$ = $1; }
+  | sql_show_iostats { $$ = $1; }
   | sql_select { $$ = $1; }
   | sql_insert { $$ = $1; }
   | sql_delete { $$ = $1; }
@@ -101,6 +103,39 @@ sql_create_table:
     SyntaxNodeAddChildren($$, $3);
     SyntaxNodeAddChildren($$, list_node);
   }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' TABLESPACE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode tablespace_node = CreateSyntaxNode(kNodeTablespace, "tablespace");
+    SyntaxNodeAddChildren(tablespace_node, $8);
+    SyntaxNodeAddChildren($$, tablespace_node);
+  }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode format_node = CreateSyntaxNode(kNodeTableFormat, "table format");
+    SyntaxNodeAddChildren(format_node, $8);
+    SyntaxNodeAddChildren($$, format_node);
+  }
+  | CREATE TABLE IDENTIFIER '(' column_definition_list ')' TABLESPACE IDENTIFIER USING IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeCreateTable, NULL);
+    pSyntaxNode list_node = CreateSyntaxNode(kNodeColumnDefinitionList, NULL);
+    SyntaxNodeAddChildren(list_node, $5);
+    SyntaxNodeAddChildren($$, $3);
+    SyntaxNodeAddChildren($$, list_node);
+    pSyntaxNode tablespace_node = CreateSyntaxNode(kNodeTablespace, "tablespace");
+    SyntaxNodeAddChildren(tablespace_node, $8);
+    SyntaxNodeAddChildren($$, tablespace_node);
+    pSyntaxNode format_node = CreateSyntaxNode(kNodeTableFormat, "table format");
+    SyntaxNodeAddChildren(format_node, $10);
+    SyntaxNodeAddChildren($$, format_node);
+  }
   ;
 
 column_list:
@@ -160,6 +195,13 @@ sql_drop_table:
   }
   ;
 
+sql_truncate_table:
+  TRUNCATE TABLE IDENTIFIER {
+    $$ = CreateSyntaxNode(kNodeTruncateTable, NULL);
+    SyntaxNodeAddChildren($$, $3);
+  }
+  ;
+
 sql_create_index:
   CREATE INDEX IDENTIFIER ON IDENTIFIER '(' column_list ')' {
     $$ = CreateSyntaxNode(kNodeCreateIndex, NULL);
@@ -195,6 +237,16 @@ sql_show_indexes:
   }
   ;
 
+sql_show_iostats:
+  SHOW IOSTATS {
+    $$ = CreateSyntaxNode(kNodeShowIOStats, NULL);
+  }
+  | SHOW IOSTATS INTO STRING {
+    $$ = CreateSyntaxNode(kNodeShowIOStats, NULL);
+    SyntaxNodeAddChildren($$, $4);
+  }
+  ;
+
 sql_select:
   SELECT select_columns FROM IDENTIFIER {
     $$ = CreateSyntaxNode(kNodeSelect, NULL);
@@ -289,12 +341,22 @@ operator:
   ;
 
 sql_insert:
-  INSERT INTO IDENTIFIER VALUES '(' column_values ')' {
+  INSERT INTO IDENTIFIER VALUES value_lists {
     $$ = CreateSyntaxNode(kNodeInsert, NULL);
     SyntaxNodeAddChildren($$, $3);
-    pSyntaxNode col_val_node = CreateSyntaxNode(kNodeColumnValues, NULL);
-    SyntaxNodeAddChildren(col_val_node, $6);
-    SyntaxNodeAddChildren($$, col_val_node);
+    SyntaxNodeAddChildren($$, $5);
+  }
+  ;
+
+value_lists:
+  '(' column_values ')' ',' value_lists {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
+    SyntaxNodeAddSibling($$, $5);
+  }
+  | '(' column_values ')' {
+    $$ = CreateSyntaxNode(kNodeColumnValues, NULL);
+    SyntaxNodeAddChildren($$, $2);
   }
   ;
 
@@ -1,14 +1,14 @@
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -16,9 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,118 +31,153 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_MINISQL_YACC_H_INCLUDED
+# define YY_YY_MINISQL_YACC_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-/* Put the tokens into the symbol table, so that GDB and other debuggers
-   know about them.  */
-enum yytokentype {
-  CREATE = 258,
-  DROP = 259,
-  SELECT = 260,
-  INSERT = 261,
-  DELETE = 262,
-  UPDATE = 263,
-  TRXBEGIN = 264,
-  TRXCOMMIT = 265,
-  TRXROLLBACK = 266,
-  QUIT = 267,
-  EXECFILE = 268,
-  SHOW = 269,
-  USE = 270,
-  USING = 271,
-  DATABASE = 272,
-  DATABASES = 273,
-  TABLE = 274,
-  TABLES = 275,
-  INDEX = 276,
-  INDEXES = 277,
-  ON = 278,
-  FROM = 279,
-  WHERE = 280,
-  INTO = 281,
-  SET = 282,
-  VALUES = 283,
-  PRIMARY = 284,
-  KEY = 285,
-  UNIQUE = 286,
-  CHAR = 287,
-  INT = 288,
-  FLOAT = 289,
-  AND = 290,
-  OR = 291,
-  NOT = 292,
-  IS = 293,
-  FLAGNULL = 294,
-  IDENTIFIER = 295,
-  STRING = 296,
-  NUMBER = 297,
-  EQ = 298,
-  NE = 299,
-  LE = 300,
-  GE = 301
-};
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    CREATE = 258,                  /* CREATE  */
+    DROP = 259,                    /* DROP  */
+    TRUNCATE = 260,                /* TRUNCATE  */
+    SELECT = 261,                  /* SELECT  */
+    INSERT = 262,                  /* INSERT  */
+    DELETE = 263,                  /* DELETE  */
+    UPDATE = 264,                  /* UPDATE  */
+    TRXBEGIN = 265,                /* TRXBEGIN  */
+    TRXCOMMIT = 266,               /* TRXCOMMIT  */
+    TRXROLLBACK = 267,             /* TRXROLLBACK  */
+    QUIT = 268,                    /* QUIT  */
+    EXECFILE = 269,                /* EXECFILE  */
+    SHOW = 270,                    /* SHOW  */
+    USE = 271,                     /* USE  */
+    USING = 272,                   /* USING  */
+    DATABASE = 273,                /* DATABASE  */
+    DATABASES = 274,               /* DATABASES  */
+    TABLE = 275,                   /* TABLE  */
+    TABLES = 276,                  /* TABLES  */
+    TABLESPACE = 277,              /* TABLESPACE  */
+    INDEX = 278,                   /* INDEX  */
+    INDEXES = 279,                 /* INDEXES  */
+    IOSTATS = 280,                 /* IOSTATS  */
+    ON = 281,                      /* ON  */
+    FROM = 282,                    /* FROM  */
+    WHERE = 283,                   /* WHERE  */
+    INTO = 284,                    /* INTO  */
+    SET = 285,                     /* SET  */
+    VALUES = 286,                  /* VALUES  */
+    PRIMARY = 287,                 /* PRIMARY  */
+    KEY = 288,                     /* KEY  */
+    UNIQUE = 289,                  /* UNIQUE  */
+    CHAR = 290,                    /* CHAR  */
+    INT = 291,                     /* INT  */
+    FLOAT = 292,                   /* FLOAT  */
+    AND = 293,                     /* AND  */
+    OR = 294,                      /* OR  */
+    NOT = 295,                     /* NOT  */
+    IS = 296,                      /* IS  */
+    FLAGNULL = 297,                /* FLAGNULL  */
+    IDENTIFIER = 298,              /* IDENTIFIER  */
+    STRING = 299,                  /* STRING  */
+    NUMBER = 300,                  /* NUMBER  */
+    EQ = 301,                      /* EQ  */
+    NE = 302,                      /* NE  */
+    LE = 303,                      /* LE  */
+    GE = 304                       /* GE  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define CREATE 258
 #define DROP 259
-#define SELECT 260
-#define INSERT 261
-#define DELETE 262
-#define UPDATE 263
-#define TRXBEGIN 264
-#define TRXCOMMIT 265
-#define TRXROLLBACK 266
-#define QUIT 267
-#define EXECFILE 268
-#define SHOW 269
-#define USE 270
-#define USING 271
-#define DATABASE 272
-#define DATABASES 273
-#define TABLE 274
-#define TABLES 275
-#define INDEX 276
-#define INDEXES 277
-#define ON 278
-#define FROM 279
-#define WHERE 280
-#define INTO 281
-#define SET 282
-#define VALUES 283
-#define PRIMARY 284
-#define KEY 285
-#define UNIQUE 286
-#define CHAR 287
-#define INT 288
-#define FLOAT 289
-#define AND 290
-#define OR 291
-#define NOT 292
-#define IS 293
-#define FLAGNULL 294
-#define IDENTIFIER 295
-#define STRING 296
-#define NUMBER 297
-#define EQ 298
-#define NE 299
-#define LE 300
-#define GE 301
-
-
-#if !defined YYSTYPE && !defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 10 "minisql.y"
+#define TRUNCATE 260
+#define SELECT 261
+#define INSERT 262
+#define DELETE 263
+#define UPDATE 264
+#define TRXBEGIN 265
+#define TRXCOMMIT 266
+#define TRXROLLBACK 267
+#define QUIT 268
+#define EXECFILE 269
+#define SHOW 270
+#define USE 271
+#define USING 272
+#define DATABASE 273
+#define DATABASES 274
+#define TABLE 275
+#define TABLES 276
+#define TABLESPACE 277
+#define INDEX 278
+#define INDEXES 279
+#define IOSTATS 280
+#define ON 281
+#define FROM 282
+#define WHERE 283
+#define INTO 284
+#define SET 285
+#define VALUES 286
+#define PRIMARY 287
+#define KEY 288
+#define UNIQUE 289
+#define CHAR 290
+#define INT 291
+#define FLOAT 292
+#define AND 293
+#define OR 294
+#define NOT 295
+#define IS 296
+#define FLAGNULL 297
+#define IDENTIFIER 298
+#define STRING 299
+#define NUMBER 300
+#define EQ 301
+#define NE 302
+#define LE 303
+#define GE 304
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
 {
-  pSyntaxNode syntax_node;
-}
-/* Line 1529 of yacc.c.  */
-#line 145 "./minisql_yacc.h"
-        YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+#line 10 "minisql.y"
+
+	pSyntaxNode syntax_node;
+
+#line 169 "./minisql_yacc.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
+
 extern YYSTYPE yylval;
 
+
+int yyparse (void);
+
+
+#endif /* !YY_YY_MINISQL_YACC_H_INCLUDED  */
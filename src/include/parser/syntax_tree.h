@@ -43,7 +43,11 @@ typedef enum {
   kNodeIndexType, /** type of index */
   kNodeTrxBegin, /** begin transaction command */
   kNodeTrxCommit, /** commit transaction command */
-  kNodeTrxRollback /** rollback transaction command */
+  kNodeTrxRollback, /** rollback transaction command */
+  kNodeTablespace, /** tablespace of a table */
+  kNodeTableFormat, /** page format of a table, row, pax or clustered */
+  kNodeShowIOStats, /** show disk io stats command, optionally dumped into a file */
+  kNodeTruncateTable /** truncate table command */
 } SyntaxNodeType;
 
 /**
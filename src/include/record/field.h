@@ -1,12 +1,14 @@
 #ifndef MINISQL_FIELD_H
 #define MINISQL_FIELD_H
 
+#include <algorithm>
 #include <cstring>
 
 #include "common/config.h"
 #include "common/macros.h"
 #include "record/types.h"
 #include "record/type_id.h"
+#include "record/type_kernels.h"
 
 class Field {
   friend class Type;
@@ -17,12 +19,17 @@ class Field {
 
   friend class TypeFloat;
 
+  friend class RowCodec;
+
 public:
+  static constexpr uint32_t INLINE_SIZE = 16;   /** char values up to this length are stored in the field */
+  static constexpr uint32_t PREFIX_SIZE = 8;   /** first bytes of a longer char value cached in the field */
+
   explicit Field(const TypeId type) : type_id_(type), len_(FIELD_NULL_LEN), is_null_(true) {}
 
   ~Field() {
     if (type_id_ == TypeId::kTypeChar && manage_data_) {
-      delete[] value_.chars_;
+      delete[] value_.chars_.data_;
     }
   }
 
@@ -40,50 +47,195 @@ public:
     len_ = Type::GetTypeSize(type);
   }
 
-  // char
+  // char, a managed value up to INLINE_SIZE bytes is copied into the field instead of an allocated buffer
   explicit Field(TypeId type, char *data, uint32_t len, bool manage_data) : type_id_(type), manage_data_(manage_data) {
     ASSERT(type == TypeId::kTypeChar, "Invalid type.");
     if (data == nullptr) {
       is_null_ = true;
       len_ = 0;
-      value_.chars_ = nullptr;
+      value_.chars_.data_ = nullptr;
       manage_data_ = false;
     } else {
-      if (manage_data) {
+      len_ = len;
+      if (manage_data && len <= INLINE_SIZE) {
+        memcpy(value_.inline_, data, len);
+        is_inline_ = true;
+        manage_data_ = false;
+      } else if (manage_data) {
         ASSERT(len < VARCHAR_MAX_LEN, "Field length exceeds max varchar length");
-        value_.chars_ = new char[len];
-        memcpy(value_.chars_, data, len);
+        value_.chars_.data_ = new char[len];
+        memcpy(value_.chars_.data_, data, len);
+        CachePrefix();
       } else {
-        value_.chars_ = data;
+        value_.chars_.data_ = data;
+        CachePrefix();
       }
-      len_ = len;
     }
   }
 
+  // char stored out of line in overflow pages, the data is fetched later by the table heap
+  explicit Field(TypeId type, uint32_t len, page_id_t external_page_id)
+          : type_id_(type), len_(len), external_page_id_(external_page_id) {
+    ASSERT(type == TypeId::kTypeChar, "Invalid type.");
+    value_.chars_.data_ = nullptr;
+  }
+
+  /**
+   * @return a char value encoded as a code in the dictionary of its column, the value is decoded later by the
+   * table heap
+   */
+  static Field Encoded(uint32_t code) {
+    Field field(TypeId::kTypeChar);
+    field.is_null_ = false;
+    field.len_ = 0;
+    field.value_.chars_.data_ = nullptr;
+    field.is_encoded_ = true;
+    field.code_ = code;
+    return field;
+  }
+
   // copy constructor
   explicit Field(const Field &other) {
     type_id_ = other.type_id_;
     len_ = other.len_;
     is_null_ = other.is_null_;
     manage_data_ = other.manage_data_;
+    is_inline_ = other.is_inline_;
+    is_encoded_ = other.is_encoded_;
+    external_page_id_ = other.external_page_id_;
+    value_ = other.value_;
     if (type_id_ == TypeId::kTypeChar && !is_null_ && manage_data_) {
-      value_.chars_ = new char[len_];
-      memcpy(value_.chars_, other.value_.chars_, len_);
-    } else {
-      value_ = other.value_;
+      value_.chars_.data_ = new char[len_];
+      memcpy(value_.chars_.data_, other.value_.chars_.data_, len_);
+    }
+  }
+
+  // copy whose char value is allocated in heap unless it is inline, it is valid as long as the heap
+  explicit Field(const Field &other, MemHeap *heap)
+          : value_(other.value_), type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_),
+            is_inline_(other.is_inline_), is_encoded_(other.is_encoded_), external_page_id_(other.external_page_id_) {
+    if (type_id_ == TypeId::kTypeChar && !is_null_ && !is_inline_ && other.value_.chars_.data_ != nullptr) {
+      value_.chars_.data_ = static_cast<char *>(heap->Allocate(std::max(len_, 1u)));
+      memcpy(value_.chars_.data_, other.value_.chars_.data_, len_);
     }
   }
 
+  // move constructor, other is left null
+  Field(Field &&other) noexcept
+          : value_(other.value_), type_id_(other.type_id_), len_(other.len_), is_null_(other.is_null_),
+            manage_data_(other.manage_data_), is_inline_(other.is_inline_), is_encoded_(other.is_encoded_),
+            external_page_id_(other.external_page_id_) {
+    other.Release();
+  }
+
   // copy
   Field &operator=(Field &other) {
     Swap(*this, other);
     return *this;
   }
 
+  // move
+  Field &operator=(Field &&other) noexcept {
+    if (this != &other) {
+      if (type_id_ == TypeId::kTypeChar && manage_data_) {
+        delete[] value_.chars_.data_;
+      }
+      value_ = other.value_;
+      type_id_ = other.type_id_;
+      len_ = other.len_;
+      is_null_ = other.is_null_;
+      manage_data_ = other.manage_data_;
+      is_inline_ = other.is_inline_;
+      is_encoded_ = other.is_encoded_;
+      external_page_id_ = other.external_page_id_;
+      other.Release();
+    }
+    return *this;
+  }
+
   inline bool IsNull() const {
     return is_null_;
   }
 
+  inline TypeId GetTypeId() const { return type_id_; }
+
+  /**
+   * @return true if the value is stored out of line in overflow pages
+   */
+  inline bool IsExternal() const { return !is_encoded_ && external_page_id_ != INVALID_PAGE_ID; }
+
+  /**
+   * @return true if the value is stored as a code in the dictionary of its column
+   */
+  inline bool IsEncoded() const { return is_encoded_; }
+
+  /**
+   * @return false if the value is stored out of line or encoded, and not fetched or decoded yet
+   */
+  inline bool IsFetched() const {
+    return (!IsExternal() && !is_encoded_) || is_inline_ || value_.chars_.data_ != nullptr;
+  }
+
+  inline page_id_t GetExternalPageId() const { return external_page_id_; }
+
+  /**
+   * Store the value out of line, the serialized value becomes a pointer to the first overflow page
+   */
+  inline void SetExternal(page_id_t page_id) {
+    ASSERT(type_id_ == TypeId::kTypeChar && !is_null_, "Only char value can be stored out of line.");
+    external_page_id_ = page_id;
+  }
+
+  /**
+   * Store the value in row again, the value must be fetched
+   */
+  inline void ClearExternal() {
+    ASSERT(IsFetched(), "Value is not fetched.");
+    external_page_id_ = INVALID_PAGE_ID;
+  }
+
+  inline uint32_t GetCode() const { return code_; }
+
+  /**
+   * Store the value as a code in the dictionary of its column, the value must be fetched and in row
+   */
+  inline void SetEncoded(uint32_t code) {
+    ASSERT(type_id_ == TypeId::kTypeChar && !is_null_ && !IsExternal() && IsFetched(),
+           "Only char value in row can be encoded.");
+    is_encoded_ = true;
+    code_ = code;
+  }
+
+  /**
+   * Store the value itself again, the value must be fetched
+   */
+  inline void ClearEncoded() {
+    ASSERT(IsFetched(), "Value is not decoded.");
+    is_encoded_ = false;
+    external_page_id_ = INVALID_PAGE_ID;
+  }
+
+  /**
+   * Set the value of the code of an encoded field, the value is copied into the field, which is no longer encoded
+   */
+  inline void SetDecodedData(const char *data, uint32_t len) {
+    ASSERT(is_encoded_ && !IsFetched() && len <= INLINE_SIZE, "Value is already decoded.");
+    memcpy(value_.inline_, data, len);
+    len_ = len;
+    is_inline_ = true;
+    ClearEncoded();
+  }
+
+  /**
+   * Set the value fetched from overflow pages, the field takes the ownership of data
+   */
+  inline void SetFetchedData(char *data) {
+    ASSERT(!IsFetched(), "Value is already fetched.");
+    value_.chars_.data_ = data;
+    manage_data_ = true;
+    CachePrefix();
+  }
+
   inline uint32_t GetLength() const {
     return Type::GetInstance(type_id_)->GetLength(*this);
   }
@@ -130,25 +282,117 @@ public:
     return Type::GetInstance(type_id_)->CompareGreaterThanEquals(*this, o);
   }
 
+  /**
+   * Three-way comparison with a non-null value of the same type, a char value must be fetched
+   * @return negative, zero or positive if this value is less than, equal to or greater than o
+   */
+  inline int Compare(const Field &o) const;
+
+  /**
+   * Compare as values of type_id without looking up the type, for loops over values of a type known ahead
+   */
+  template<TypeId type_id>
+  inline int CompareAs(const Field &o) const;
+
   friend void Swap(Field &first, Field &second) {
     std::swap(first.value_, second.value_);
     std::swap(first.type_id_, second.type_id_);
     std::swap(first.len_, second.len_);
     std::swap(first.is_null_, second.is_null_);
     std::swap(first.manage_data_, second.manage_data_);
+    std::swap(first.is_inline_, second.is_inline_);
+    std::swap(first.is_encoded_, second.is_encoded_);
+    std::swap(first.external_page_id_, second.external_page_id_);
+  }
+
+private:
+  /**
+   * Give up the value after it is moved, the field becomes null
+   */
+  inline void Release() {
+    value_.chars_.data_ = nullptr;
+    len_ = FIELD_NULL_LEN;
+    is_null_ = true;
+    manage_data_ = false;
+    is_inline_ = false;
+    is_encoded_ = false;
+    external_page_id_ = INVALID_PAGE_ID;
   }
 
+  inline void CachePrefix() { memcpy(value_.chars_.prefix_, value_.chars_.data_, std::min(len_, PREFIX_SIZE)); }
+
+  inline const char *GetChars() const { return is_inline_ ? value_.inline_ : value_.chars_.data_; }
+
+  /**
+   * @return the first min(len_, PREFIX_SIZE) bytes of a fetched char value, without following the data pointer
+   */
+  inline const char *GetPrefix() const { return is_inline_ ? value_.inline_ : value_.chars_.prefix_; }
+
 protected:
+  struct Chars {
+    char *data_;
+    char prefix_[PREFIX_SIZE];
+  };
+
   union Val {
     int32_t integer_;
     float float_;
-    char *chars_;
+    Chars chars_;
+    char inline_[INLINE_SIZE];
   } value_;
   TypeId type_id_;
   uint32_t len_;
   bool is_null_{false};
-  bool manage_data_{false};
+  bool manage_data_{false};   /** the char value is in a buffer owned by the field */
+  bool is_inline_{false};   /** the char value is in value_.inline_ */
+  bool is_encoded_{false};   /** the char value is serialized as code_ */
+  union {
+    page_id_t external_page_id_{INVALID_PAGE_ID};
+    uint32_t code_;   /** an encoded value is never stored out of line */
+  };
 };
 
+template<>
+inline int Field::CompareAs<TypeId::kTypeInt>(const Field &o) const {
+  ASSERT(type_id_ == TypeId::kTypeInt && o.type_id_ == TypeId::kTypeInt, "Not comparable.");
+  ASSERT(!is_null_ && !o.is_null_, "Null value is not comparable.");
+  return TypeKernel<TypeId::kTypeInt>::Compare(value_.integer_, o.value_.integer_);
+}
+
+template<>
+inline int Field::CompareAs<TypeId::kTypeFloat>(const Field &o) const {
+  ASSERT(type_id_ == TypeId::kTypeFloat && o.type_id_ == TypeId::kTypeFloat, "Not comparable.");
+  ASSERT(!is_null_ && !o.is_null_, "Null value is not comparable.");
+  return TypeKernel<TypeId::kTypeFloat>::Compare(value_.float_, o.value_.float_);
+}
+
+template<>
+inline int Field::CompareAs<TypeId::kTypeChar>(const Field &o) const {
+  ASSERT(type_id_ == TypeId::kTypeChar && o.type_id_ == TypeId::kTypeChar, "Not comparable.");
+  ASSERT(!is_null_ && !o.is_null_, "Null value is not comparable.");
+  ASSERT(IsFetched() && o.IsFetched(), "Value stored out of line is not fetched.");
+  // the cached prefixes decide most comparisons without following the data pointers
+  uint32_t prefix_len = std::min({len_, o.len_, PREFIX_SIZE});
+  int result = memcmp(GetPrefix(), o.GetPrefix(), prefix_len);
+  if (result != 0) {
+    return result;
+  }
+  return TypeKernel<TypeId::kTypeChar>::Compare(GetChars() + prefix_len, len_ - prefix_len,
+                                                o.GetChars() + prefix_len, o.len_ - prefix_len);
+}
+
+inline int Field::Compare(const Field &o) const {
+  switch (type_id_) {
+    case TypeId::kTypeInt:
+      return CompareAs<TypeId::kTypeInt>(o);
+    case TypeId::kTypeFloat:
+      return CompareAs<TypeId::kTypeFloat>(o);
+    case TypeId::kTypeChar:
+      return CompareAs<TypeId::kTypeChar>(o);
+    default:
+      ASSERT(false, "Not comparable.");
+      return 0;
+  }
+}
 
 #endif //MINISQL_FIELD_H
@@ -10,28 +10,43 @@
 #include "utils/mem_heap.h"
 
 /**
- *  Row format:
+ *  Row format (version 2):
+ * ------------------------------------------------------------------------------
+ * | Header | Fixed-width fields | Offset array | Char field-1 | ... | Char field-M |
+ * ------------------------------------------------------------------------------
+ *  Header format:
+ * ----------------------------------------------------------------------------
+ * | Field Nums | ROW_FORMAT_V2 (4) | Null bitmap (Field Nums / 8, rounded up) |
+ * ----------------------------------------------------------------------------
+ *  Int and float fields take their size at offsets precomputed by the schema, even when null. The offset
+ *  array has an entry for each char field, holding the offset of the field in the row, so every field is
+ *  found without decoding the others.
+ *
+ *  Rows written in format version 1 are still readable, their header has no ROW_FORMAT_V2 flag:
  * -------------------------------------------
  * | Header | Field-1 | ... | Field-N |
  * -------------------------------------------
- *  Header format:
- * --------------------------------------------
- * | Field Nums | Null bitmap |
- * -------------------------------------------
- *  
+ *  Null fields take no space after the header.
  *
+ *  Rows in format version 2 are written and read by the RowCodec of the schema.
  */
 class Row {
+  friend class RowView;
+
 public:
+  static constexpr uint32_t ROW_FORMAT_VERSION = 2;   /** format of newly written rows */
+  static constexpr uint32_t ROW_FORMAT_V2 = 1u << 31;   /** flag in the field nums of a row in format version 2 */
+  static constexpr size_t HEAP_BLOCK_SIZE = 512;   /** arena block of the fields of a row, fits about 16 fields */
+
   /**
    * Row used for insert
    * Field integrity should check by upper level
    */
-  explicit Row(std::vector<Field> &fields) : heap_(new SimpleMemHeap) {
+  explicit Row(std::vector<Field> &fields) : heap_(new ArenaMemHeap(HEAP_BLOCK_SIZE)) {
     // deep copy
+    fields_.reserve(fields.size());
     for (auto &field : fields) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(field));
+      fields_.push_back(ALLOC_P(heap_, Field)(field, heap_));
     }
   }
 
@@ -43,42 +58,76 @@ public:
   /**
    * Row used for deserialize and update
    */
-  Row(RowId rid) : rid_(rid), heap_(new SimpleMemHeap) {}
+  Row(RowId rid) : rid_(rid), heap_(new ArenaMemHeap(HEAP_BLOCK_SIZE)) {}
 
   /**
    * Row copy function
    */
-  Row(const Row &other) : heap_(new SimpleMemHeap) {
-    if (!fields_.empty()) {
-      for (auto &field : fields_) {
-        heap_->Free(field);
-      }
-      fields_.clear();
-    }
-    rid_ = other.rid_;
+  Row(const Row &other) : rid_(other.rid_), heap_(new ArenaMemHeap(HEAP_BLOCK_SIZE)) {
+    fields_.reserve(other.fields_.size());
     for (auto &field : other.fields_) {
-      void *buf = heap_->Allocate(sizeof(Field));
-      fields_.push_back(new(buf)Field(*field));
+      fields_.push_back(ALLOC_P(heap_, Field)(*field, heap_));
+    }
+  }
+
+  /**
+   * Take the fields and the heap of other, a moved row may only be reset, assigned or destroyed
+   */
+  Row(Row &&other) noexcept : rid_(other.rid_), fields_(std::move(other.fields_)), heap_(other.heap_) {
+    other.fields_.clear();
+    other.heap_ = nullptr;
+  }
+
+  Row &operator=(Row &&other) noexcept {
+    if (this != &other) {
+      DestroyFields();
+      delete heap_;
+      rid_ = other.rid_;
+      fields_ = std::move(other.fields_);
+      heap_ = other.heap_;
+      other.fields_.clear();
+      other.heap_ = nullptr;
     }
+    return *this;
   }
 
   virtual ~Row() {
+    DestroyFields();
     delete heap_;
   }
 
+  /**
+   * Drop the fields to read another tuple into the row, the field vector and the heap blocks are kept
+   */
+  void Reset(RowId rid) {
+    DestroyFields();
+    if (heap_ == nullptr) {
+      heap_ = new ArenaMemHeap(HEAP_BLOCK_SIZE);
+    } else {
+      heap_->Reset();
+    }
+    rid_ = rid;
+  }
+
   /**
    * Note: Make sure that bytes write to buf is equal to GetSerializedSize()
    */
-  uint32_t SerializeTo(char *buf, Schema *schema) const;
+  uint32_t SerializeTo(char *buf, Schema *schema, uint32_t format_version = ROW_FORMAT_VERSION) const;
 
   uint32_t DeserializeFrom(char *buf, Schema *schema);
 
+  /**
+   * Deserialize a row and append its fields, which are allocated in heap
+   * @return bytes read from buf
+   */
+  static uint32_t DeserializeFields(char *buf, Schema *schema, std::vector<Field *> &fields, MemHeap *heap);
+
   /**
    * For empty row, return 0
    * For non-empty row with null fields, eg: |null|null|null|, return header size only
    * @return
    */
-  uint32_t GetSerializedSize(Schema *schema) const;
+  uint32_t GetSerializedSize(Schema *schema, uint32_t format_version = ROW_FORMAT_VERSION) const;
 
   inline const RowId GetRowId() const { return rid_; }
 
@@ -86,6 +135,8 @@ public:
 
   inline std::vector<Field *> &GetFields() { return fields_; }
 
+  inline const std::vector<Field *> &GetFields() const { return fields_; }
+
   inline Field *GetField(uint32_t idx) const {
     ASSERT(idx < fields_.size(), "Failed to access field");
     return fields_[idx];
@@ -96,10 +147,17 @@ public:
 private:
   Row &operator=(const Row &other) = delete;
 
+  void DestroyFields() {
+    for (auto field : fields_) {
+      field->~Field();
+    }
+    fields_.clear();
+  }
+
 private:
   RowId rid_{};
   std::vector<Field *> fields_;   /** Make sure that all fields are created by mem heap */
-  MemHeap *heap_{nullptr};
+  ArenaMemHeap *heap_{nullptr};
 };
 
 #endif //MINISQL_TUPLE_H
@@ -0,0 +1,80 @@
+#ifndef MINISQL_ROW_BATCH_H
+#define MINISQL_ROW_BATCH_H
+
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+#include "utils/mem_heap.h"
+
+/**
+ * A batch of rows of the same schema filled by TableIterator::NextBatch.
+ *
+ * Fields of all rows are kept row by row in one vector and allocated in the arena of the batch, which is
+ * reset as a whole when the batch is cleared, so a batch can be reused without a Row and a heap per tuple.
+ */
+class RowBatch {
+  friend class TableIterator;
+
+public:
+  RowBatch() = default;
+
+  ~RowBatch() { Clear(); }
+
+  RowBatch(const RowBatch &other) = delete;
+
+  RowBatch &operator=(const RowBatch &other) = delete;
+
+  inline size_t GetRowCount() const { return rids_.size(); }
+
+  inline bool IsEmpty() const { return rids_.empty(); }
+
+  inline RowId GetRowId(size_t row) const { return rids_[row]; }
+
+  inline Field *GetField(size_t row, uint32_t column) const {
+    ASSERT(row < rids_.size() && column < column_count_, "Failed to access field");
+    return fields_[row * column_count_ + column];
+  }
+
+  /**
+   * Remove all rows, memory of their fields is released at once
+   */
+  void Clear() {
+    if (fields_.empty()) {
+      rids_.clear();
+      return;
+    }
+    for (auto field : fields_) {
+      field->~Field();
+    }
+    fields_.clear();
+    rids_.clear();
+    heap_.Reset();
+  }
+
+private:
+  /**
+   * Deserialize a tuple and append it to the batch
+   * @param columns projected columns in ascending order, all columns are deserialized if it is null
+   */
+  void Append(const RowView &row, const std::vector<uint32_t> *columns) {
+    column_count_ = row.GetFieldCount();
+    if (columns == nullptr) {
+      row.DeserializeFields(fields_, &heap_);
+    } else {
+      row.DeserializeFields(*columns, fields_, &heap_);
+    }
+    rids_.push_back(row.GetRowId());
+  }
+
+private:
+  uint32_t column_count_{0};
+  std::vector<RowId> rids_;
+  std::vector<Field *> fields_;   /** fields of row i are [i * column_count_, (i + 1) * column_count_) */
+  ArenaMemHeap heap_;
+};
+
+#endif //MINISQL_ROW_BATCH_H
@@ -0,0 +1,93 @@
+#ifndef MINISQL_ROW_CODEC_H
+#define MINISQL_ROW_CODEC_H
+
+#include <cstdint>
+#include <vector>
+
+#include "record/type_id.h"
+#include "utils/mem_heap.h"
+
+class Field;
+
+class Schema;
+
+/**
+ * Serializer of rows in format version 2 (see record/row.h) compiled once per schema. The plan lists the type,
+ * the slot offset and the null bitmap bit of every column, and the char columns in column order, so a row is
+ * written and read in a single pass over flat arrays, with the values of a type encoded inline instead of
+ * through the Type of every field.
+ *
+ * Every Schema holds its codec, tables and indexes reach it through their schemas.
+ */
+class RowCodec {
+public:
+  static constexpr uint32_t FIELD_GROUP_SIZE = 8;   /** fields allocated at once, a group fits a row arena block */
+
+  RowCodec() = default;
+
+  /**
+   * Compile the plan of a schema, the codec is only valid for rows of the schema
+   */
+  void Compile(const Schema *schema);
+
+  /**
+   * @return size of a row of the fields in format version 2, 0 for an empty row
+   */
+  uint32_t GetSerializedSize(const std::vector<Field *> &fields) const;
+
+  /**
+   * Note: buf must hold GetSerializedSize(fields) bytes
+   * @return bytes written to buf
+   */
+  uint32_t SerializeTo(const std::vector<Field *> &fields, char *buf) const;
+
+  /**
+   * Deserialize a row in format version 2 and append its fields, which are allocated in heap
+   * @return bytes read from buf
+   */
+  uint32_t DeserializeFields(char *buf, std::vector<Field *> &fields, MemHeap *heap) const;
+
+  /**
+   * Deserialize a column of a row in format version 2
+   * @return the field allocated in heap
+   */
+  Field *DeserializeField(char *buf, uint32_t column, MemHeap *heap) const;
+
+  inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
+
+private:
+  struct ColumnPlan {
+    TypeId type_;
+    uint32_t offset_;   /** offset of a fixed-width value, or of the offset array entry of a char value */
+    uint32_t null_byte_;   /** byte of the null bit in the row */
+    uint8_t null_mask_;
+  };
+
+  static inline bool IsNull(const char *buf, const ColumnPlan &column) {
+    return (buf[column.null_byte_] & column.null_mask_) != 0;
+  }
+
+  /**
+   * @return offset of a non-null char value in the row
+   */
+  static inline uint32_t GetCharOffset(const char *buf, const ColumnPlan &column) {
+    return *reinterpret_cast<const uint32_t *>(buf + column.offset_);
+  }
+
+  /**
+   * Construct the field of a column in slot, a long char value is copied into heap
+   */
+  static Field *DecodeField(char *buf, const ColumnPlan &column, void *slot, MemHeap *heap);
+
+  /**
+   * Construct the field of a non-null char value in slot as TypeChar::DeserializeFrom does
+   */
+  static Field *DecodeChar(char *storage, void *slot, MemHeap *heap);
+
+private:
+  std::vector<ColumnPlan> columns_;
+  std::vector<uint32_t> char_columns_;   /** char columns in column order, their values follow the fixed part */
+  uint32_t fixed_row_size_{0};
+};
+
+#endif //MINISQL_ROW_CODEC_H
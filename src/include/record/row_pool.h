@@ -0,0 +1,48 @@
+#ifndef MINISQL_ROW_POOL_H
+#define MINISQL_ROW_POOL_H
+
+#include <vector>
+
+#include "common/rowid.h"
+#include "record/row.h"
+
+/**
+ * Free list of rows. A released row keeps its field vector and heap blocks, so once the pool is warm, reading a
+ * tuple into an acquired row allocates nothing. Not thread safe, every iterator or executor owns its pool.
+ */
+class RowPool {
+public:
+  RowPool() = default;
+
+  ~RowPool() {
+    for (auto row : free_rows_) {
+      delete row;
+    }
+  }
+
+  RowPool(const RowPool &other) = delete;
+
+  RowPool &operator=(const RowPool &other) = delete;
+
+  /**
+   * @return an empty row with the rid, to be released to the pool
+   */
+  Row *Acquire(RowId rid) {
+    if (free_rows_.empty()) {
+      return new Row(rid);
+    }
+    Row *row = free_rows_.back();
+    free_rows_.pop_back();
+    row->Reset(rid);
+    return row;
+  }
+
+  void Release(Row *row) { free_rows_.push_back(row); }
+
+  inline size_t GetFreeCount() const { return free_rows_.size(); }
+
+private:
+  std::vector<Row *> free_rows_;
+};
+
+#endif //MINISQL_ROW_POOL_H
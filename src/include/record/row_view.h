@@ -0,0 +1,101 @@
+#ifndef MINISQL_ROW_VIEW_H
+#define MINISQL_ROW_VIEW_H
+
+#include <vector>
+
+#include "common/rowid.h"
+#include "page/pax_page.h"
+#include "record/field.h"
+#include "record/row.h"
+#include "record/schema.h"
+
+/**
+ * Read-only view of a serialized row, usually in a pinned page. Fields are decoded only when they are
+ * accessed, in constant time for rows in format version 2. Char values refer to the serialized bytes instead
+ * of being copied, so a view is only valid while the bytes are, e.g. until the page is unpinned. Materialize
+ * the view into a Row to keep it longer.
+ *
+ * A view can be pointed at another tuple of the same schema by Reset. For rows in format version 1, offsets of
+ * decoded fields are cached in a vector whose memory is reused. A view of a tuple in a PaxPage reads its fields
+ * from the minipages of their columns.
+ */
+class RowView {
+public:
+  explicit RowView(Schema *schema) : schema_(schema) {}
+
+  explicit RowView(char *data, const RowId &rid, Schema *schema) : schema_(schema) { Reset(data, rid); }
+
+  explicit RowView(PaxPage *page, const RowId &rid, Schema *schema) : schema_(schema) { Reset(page, rid); }
+
+  /**
+   * Point the view at another serialized row of the same schema
+   */
+  void Reset(char *data, const RowId &rid);
+
+  /**
+   * Point the view at a tuple of the same schema in a PaxPage
+   */
+  void Reset(PaxPage *page, const RowId &rid);
+
+  inline RowId GetRowId() const { return rid_; }
+
+  inline uint32_t GetFieldCount() const { return schema_->GetColumnCount(); }
+
+  inline bool IsNull(uint32_t column) const {
+    ASSERT(column < GetFieldCount(), "Failed to access field");
+    if (pax_page_ != nullptr) {
+      return pax_page_->IsNull(rid_.GetSlotNum(), column);
+    }
+    return (data_[sizeof(uint32_t) + column / 8] >> (column % 8)) & 1;
+  }
+
+  /**
+   * @return a field referring to the serialized value, a value stored out of line or encoded is not fetched
+   */
+  Field GetField(uint32_t column) const;
+
+  /**
+   * Append the fields of an index key, referring to the serialized values
+   * @param key_map Column of this row for each key column, see IndexMetadata::GetKeyMapping
+   */
+  void GetKeyFields(const std::vector<uint32_t> &key_map, std::vector<Field> &key) const;
+
+  /**
+   * Deserialize the whole row into row, which owns its fields
+   */
+  void Materialize(Row *row) const;
+
+  /**
+   * Deserialize the projected columns into row, the fields of other columns are null
+   * @param columns projected columns in ascending order
+   */
+  void Materialize(Row *row, const std::vector<uint32_t> &columns) const;
+
+  /**
+   * Append a field for every column, allocated in heap, only the projected columns are deserialized and
+   * the fields of other columns are null
+   * @param columns projected columns in ascending order
+   */
+  void DeserializeFields(const std::vector<uint32_t> &columns, std::vector<Field *> &fields, MemHeap *heap) const;
+
+  /**
+   * Append a field for every column, allocated in heap
+   */
+  void DeserializeFields(std::vector<Field *> &fields, MemHeap *heap) const;
+
+  /**
+   * @return serialized value of a non-null field, in format version 1 the offsets of the fields before it are
+   * decoded if needed
+   */
+  char *GetFieldData(uint32_t column) const;
+
+private:
+  Schema *schema_;
+  char *data_{nullptr};
+  PaxPage *pax_page_{nullptr};   /** page of the tuple if it is in PAX format, otherwise the tuple is in data_ */
+  RowId rid_{INVALID_ROWID};
+  bool is_v2_{true};
+  mutable std::vector<uint32_t> offsets_;   /** offsets of the fields decoded so far */
+};
+
+#endif //MINISQL_ROW_VIEW_H
@@ -4,13 +4,17 @@
 #include "common/macros.h"
 #include "glog/logging.h"
 #include "record/column.h"
+#include "record/row_codec.h"
 
 #ifndef MINISQL_SCHEMA_H
 #define MINISQL_SCHEMA_H
 
 class Schema {
 public:
-  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {}
+  explicit Schema(const std::vector<Column *> columns) : columns_(std::move(columns)) {
+    ComputeRowLayout();
+    row_codec_.Compile(this);
+  }
 
   inline const std::vector<Column *> &GetColumns() const { return columns_; }
 
@@ -28,6 +32,27 @@ public:
 
   inline uint32_t GetColumnCount() const { return static_cast<uint32_t>(columns_.size()); }
 
+  /**
+   * Row layout of format version 2, see record/row.h
+   * @return for a fixed-width column, offset of its value in a row, for a char column, offset of its entry
+   * in the offset array
+   */
+  inline uint32_t GetFieldOffset(uint32_t column_index) const { return field_offsets_[column_index]; }
+
+  inline bool IsFixedWidth(uint32_t column_index) const {
+    return columns_[column_index]->GetType() != TypeId::kTypeChar;
+  }
+
+  /**
+   * @return size of the header, the fixed-width fields and the offset array of a row in format version 2
+   */
+  inline uint32_t GetFixedRowSize() const { return fixed_row_size_; }
+
+  /**
+   * @return codec of rows of the schema in format version 2, compiled with the schema
+   */
+  inline const RowCodec &GetRowCodec() const { return row_codec_; }
+
   /**
    * Shallow copy schema, only used in index
    *
@@ -72,9 +97,32 @@ public:
    */
   static uint32_t DeserializeFrom(char *buf, Schema *&schema, MemHeap *heap);
 
+private:
+  void ComputeRowLayout() {
+    // header: field nums and null bitmap
+    uint32_t offset = sizeof(uint32_t) + (GetColumnCount() + 7) / 8;
+    field_offsets_.resize(GetColumnCount());
+    for (uint32_t i = 0; i < GetColumnCount(); i++) {
+      if (IsFixedWidth(i)) {
+        field_offsets_[i] = offset;
+        offset += Type::GetTypeSize(columns_[i]->GetType());
+      }
+    }
+    for (uint32_t i = 0; i < GetColumnCount(); i++) {
+      if (!IsFixedWidth(i)) {
+        field_offsets_[i] = offset;
+        offset += sizeof(uint32_t);
+      }
+    }
+    fixed_row_size_ = offset;
+  }
+
 private:
   static constexpr uint32_t SCHEMA_MAGIC_NUM = 200715;
   std::vector<Column *> columns_;   /** don't need to delete pointer to column */
+  std::vector<uint32_t> field_offsets_;
+  uint32_t fixed_row_size_{0};
+  RowCodec row_codec_;
 };
 
 using IndexSchema = Schema;
@@ -0,0 +1,98 @@
+#ifndef MINISQL_TYPE_KERNELS_H
+#define MINISQL_TYPE_KERNELS_H
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+#include "record/type_id.h"
+#include "record/types.h"
+
+/**
+ * Three-way comparison of values of a type, resolved at compile time so that a loop over a column whose type is
+ * known ahead runs without looking up the Type and without virtual calls. Results are negative, zero or positive.
+ *
+ * CompareSerialized compares two non-null values in their serialized form, as in a row, a PAX minipage or an
+ * index key, so that no Field is built. Char values stored out of line or encoded can not be compared this way.
+ */
+template<TypeId type_id>
+struct TypeKernel;
+
+template<>
+struct TypeKernel<TypeId::kTypeInt> {
+  static inline int Compare(int32_t left, int32_t right) { return (left > right) - (left < right); }
+
+  static inline int CompareSerialized(const char *left, const char *right) {
+    return Compare(MACH_READ_FROM(int32_t, left), MACH_READ_FROM(int32_t, right));
+  }
+};
+
+template<>
+struct TypeKernel<TypeId::kTypeFloat> {
+  static inline int Compare(float left, float right) { return (left > right) - (left < right); }
+
+  static inline int CompareSerialized(const char *left, const char *right) {
+    return Compare(MACH_READ_FROM(float, left), MACH_READ_FROM(float, right));
+  }
+};
+
+template<>
+struct TypeKernel<TypeId::kTypeChar> {
+  static inline int Compare(const char *left, uint32_t left_len, const char *right, uint32_t right_len) {
+    int result = memcmp(left, right, std::min(left_len, right_len));
+    if (result != 0) {
+      return result;
+    }
+    return (left_len > right_len) - (left_len < right_len);
+  }
+
+  static inline bool IsExternal(const char *storage) {
+    return (MACH_READ_FROM(uint32_t, storage) & TypeChar::EXTERNAL_FLAG) != 0;
+  }
+
+  static inline bool IsEncoded(const char *storage) {
+    return (MACH_READ_FROM(uint32_t, storage) & (TypeChar::EXTERNAL_FLAG | TypeChar::DICTIONARY_FLAG)) ==
+           TypeChar::DICTIONARY_FLAG;
+  }
+
+  static inline uint32_t GetCode(const char *storage) {
+    return MACH_READ_FROM(uint32_t, storage) & ~TypeChar::DICTIONARY_FLAG;
+  }
+
+  /**
+   * @return true if the bytes of the value follow its length
+   */
+  static inline bool IsInRow(const char *storage) {
+    return (MACH_READ_FROM(uint32_t, storage) & (TypeChar::EXTERNAL_FLAG | TypeChar::DICTIONARY_FLAG)) == 0;
+  }
+
+  static inline int CompareSerialized(const char *left, const char *right) {
+    ASSERT(IsInRow(left) && IsInRow(right), "Value stored out of line or encoded is not fetched.");
+    return Compare(left + sizeof(uint32_t), MACH_READ_FROM(uint32_t, left), right + sizeof(uint32_t),
+                   MACH_READ_FROM(uint32_t, right));
+  }
+};
+
+/**
+ * Comparison of serialized values of a column, see TypeKernel::CompareSerialized
+ */
+using SerializedCompare = int (*)(const char *left, const char *right);
+
+/**
+ * Select the kernel of a column once, e.g. from its Schema, to call it for every value of the column
+ */
+inline SerializedCompare GetSerializedCompare(TypeId type_id) {
+  switch (type_id) {
+    case TypeId::kTypeInt:
+      return &TypeKernel<TypeId::kTypeInt>::CompareSerialized;
+    case TypeId::kTypeFloat:
+      return &TypeKernel<TypeId::kTypeFloat>::CompareSerialized;
+    case TypeId::kTypeChar:
+      return &TypeKernel<TypeId::kTypeChar>::CompareSerialized;
+    default:
+      ASSERT(false, "Unsupported type.");
+      return nullptr;
+  }
+}
+
+#endif //MINISQL_TYPE_KERNELS_H
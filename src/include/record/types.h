@@ -55,6 +55,12 @@ public:
   // Get serialize size of a field
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const;
 
+  // Make a field referring to the non-null value serialized in storage, without copying variable length data.
+  virtual Field DeserializeView(char *storage) const;
+
+  // Get serialize size of the non-null value in storage
+  virtual uint32_t GetSerializedSize(const char *storage) const;
+
   // Access the raw variable length data
   virtual const char *GetData(const Field &val) const;
 
@@ -88,6 +94,10 @@ public:
 
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const override;
 
+  virtual Field DeserializeView(char *storage) const override;
+
+  virtual uint32_t GetSerializedSize(const char *storage) const override;
+
   virtual CmpBool CompareEquals(const Field &left, const Field &right) const override;
 
   virtual CmpBool CompareNotEquals(const Field &left, const Field &right) const override;
@@ -105,12 +115,27 @@ class TypeChar : public Type {
 public:
   explicit TypeChar() : Type(TypeId::kTypeChar) {}
 
+  /**
+   * Flag set in the length of a value stored out of line, the length is followed by the first overflow page id
+   */
+  static constexpr uint32_t EXTERNAL_FLAG = 1u << 31;
+
+  /**
+   * Flag set in the length of a value encoded in the dictionary of its column, the other bits hold the code and
+   * no bytes follow
+   */
+  static constexpr uint32_t DICTIONARY_FLAG = 1u << 30;
+
   virtual uint32_t SerializeTo(const Field &field, char *buf) const override;
 
   virtual uint32_t DeserializeFrom(char *storage, Field **field, bool is_null, MemHeap *heap) const override;
 
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const override;
 
+  virtual Field DeserializeView(char *storage) const override;
+
+  virtual uint32_t GetSerializedSize(const char *storage) const override;
+
   virtual const char *GetData(const Field &val) const override;
 
   virtual uint32_t GetLength(const Field &val) const override;
@@ -138,6 +163,10 @@ public:
 
   virtual uint32_t GetSerializedSize(const Field &field, bool is_null) const override;
 
+  virtual Field DeserializeView(char *storage) const override;
+
+  virtual uint32_t GetSerializedSize(const char *storage) const override;
+
   virtual CmpBool CompareEquals(const Field &left, const Field &right) const override;
 
   virtual CmpBool CompareNotEquals(const Field &left, const Field &right) const override;
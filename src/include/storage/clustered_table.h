@@ -0,0 +1,190 @@
+#ifndef MINISQL_CLUSTERED_TABLE_H
+#define MINISQL_CLUSTERED_TABLE_H
+
+#include <functional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwlatch.h"
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "record/row_view.h"
+#include "transaction/lock_manager.h"
+#include "transaction/log_manager.h"
+#include "transaction/transaction.h"
+
+/** Size of the primary and secondary keys of a clustered table */
+static constexpr uint32_t CLUSTERED_KEY_SIZE = 32;
+/** Size of the slot of a row in a leaf page of a clustered table, including the size of the row */
+static constexpr uint32_t CLUSTERED_ROW_SIZE = 128;
+
+/**
+ * Index-organized table, rows are stored in the leaf pages of a BPlusTree keyed by primary key. A range scan
+ * reads the leaves of the range one after another instead of fetching a heap page per rid.
+ *
+ * Rows have no rids, they move when leaves are split or merged, so a secondary index maps its keys to primary
+ * keys. A row is serialized into a fixed-size slot of a leaf after its size, a row larger than the slot is
+ * stored in a chain of overflow pages and the slot keeps its first page instead. Like BPlusTreeIndex, secondary
+ * keys are unique.
+ *
+ * Trees are identified by index ids, their root pages are kept in the index roots page, so a table is loaded by
+ * creating it again with the same ids. The catalog does not create or load clustered tables yet.
+ */
+class ClusteredTable {
+  using PrimaryTree = BPlusTree<GenericKey<CLUSTERED_KEY_SIZE>, GenericKey<CLUSTERED_ROW_SIZE>,
+                                GenericComparator<CLUSTERED_KEY_SIZE>>;
+  using SecondaryTree = BPlusTree<GenericKey<CLUSTERED_KEY_SIZE>, GenericKey<CLUSTERED_KEY_SIZE>,
+                                  GenericComparator<CLUSTERED_KEY_SIZE>>;
+
+public:
+  /**
+   * Row of a scan, only valid while the consumer it is passed to runs
+   * @return false to stop the scan
+   */
+  using Consumer = std::function<bool(const RowView &row)>;
+
+  /**
+   * Create a clustered table, or load it if the index roots page has a root for its tree
+   * @param index_id id of the tree holding the rows
+   * @param key_map columns of the primary key
+   */
+  static ClusteredTable *Create(BufferPoolManager *buffer_pool_manager, index_id_t index_id, Schema *schema,
+                                std::vector<uint32_t> key_map, LogManager *log_manager, LockManager *lock_manager,
+                                MemHeap *heap) {
+    void *buf = heap->Allocate(sizeof(ClusteredTable));
+    return new(buf) ClusteredTable(buffer_pool_manager, index_id, schema, std::move(key_map), log_manager,
+                                   lock_manager, heap);
+  }
+
+  ~ClusteredTable();
+
+  /**
+   * Add a secondary index, the rows of the table are indexed unless the index is loaded with its tree
+   * @param index_id id of the tree of the index
+   * @param key_map columns of the secondary key
+   * @return false if two rows have the same secondary key or a key column of a row is null
+   */
+  bool CreateSecondaryIndex(index_id_t index_id, std::vector<uint32_t> key_map, Transaction *txn);
+
+  /**
+   * @return false if a row with the same primary or secondary key exists, a key column is null or the overflow
+   * pages of the row can not be allocated
+   */
+  bool InsertTuple(const Row &row, Transaction *txn);
+
+  /**
+   * @param key fields of the primary key columns in key order
+   * @param[out] row the values of the row with the key are read into it
+   * @return false if there is no row with the key
+   */
+  bool GetTuple(const Row &key, Row *row, Transaction *txn);
+
+  /**
+   * Find a row through a secondary index and the primary key it maps to
+   * @param index position of the secondary index in the order the indexes were created
+   * @param key fields of the secondary key columns in key order
+   */
+  bool GetTupleBySecondaryKey(uint32_t index, const Row &key, Row *row, Transaction *txn);
+
+  /**
+   * Replace the row with the same primary key in its slot
+   * @return false if there is no row with the key, the overflow pages of the new row can not be allocated or its
+   * secondary key is taken by another row
+   */
+  bool UpdateTuple(const Row &row, Transaction *txn);
+
+  /**
+   * @return false if there is no row with the key
+   */
+  bool DeleteTuple(const Row &key, Transaction *txn);
+
+  /**
+   * Pass the rows with keys in [begin_key, end_key) to consumer in key order
+   * @param begin_key nullptr to start from the first row
+   * @param end_key nullptr to go on to the last row
+   */
+  void Scan(const Row *begin_key, const Row *end_key, const Consumer &consumer, Transaction *txn);
+
+  /**
+   * Free the pages of the table and its secondary indexes
+   */
+  void FreeTable();
+
+  /**
+   * @return number of leaf pages holding the rows
+   */
+  size_t GetPageCount();
+
+  inline const std::vector<uint32_t> &GetKeyMapping() const { return key_map_; }
+
+private:
+  explicit ClusteredTable(BufferPoolManager *buffer_pool_manager, index_id_t index_id, Schema *schema,
+                          std::vector<uint32_t> key_map, LogManager *log_manager, LockManager *lock_manager,
+                          MemHeap *heap);
+
+  /**
+   * Secondary index from the values of some columns to primary keys
+   */
+  struct SecondaryIndex {
+    std::vector<uint32_t> key_map_;
+    Schema *key_schema_;
+    SecondaryTree tree_;
+  };
+
+  /**
+   * Serialize a key whose fields are in key order
+   * @return false if a field is null or the key does not fit in a key
+   */
+  static bool SerializeKey(const Row &key, Schema *key_schema, GenericKey<CLUSTERED_KEY_SIZE> *index_key);
+
+  /**
+   * Serialize the key of a row
+   */
+  static bool SerializeKey(const RowView &row, const std::vector<uint32_t> &key_map, Schema *key_schema,
+                           GenericKey<CLUSTERED_KEY_SIZE> *index_key);
+
+  /**
+   * Serialize the secondary keys of a row into keys, one per index
+   * @return false if a key column is null or a key is taken by a row other than the one with the primary key
+   */
+  bool SerializeSecondaryKeys(const RowView &row, const GenericKey<CLUSTERED_KEY_SIZE> &primary_key,
+                              std::vector<GenericKey<CLUSTERED_KEY_SIZE>> *keys, Transaction *txn);
+
+  /**
+   * Write a serialized row into a slot, in overflow pages if it does not fit in the slot
+   * @return false if the overflow pages can not be allocated
+   */
+  bool WriteSlot(const std::vector<char> &data, GenericKey<CLUSTERED_ROW_SIZE> *slot);
+
+  /**
+   * @return the serialized row of a slot, read into buffer if it is stored in overflow pages
+   */
+  char *ReadSlot(const GenericKey<CLUSTERED_ROW_SIZE> &slot, std::vector<char> &buffer);
+
+  /**
+   * Release the overflow pages of the row of a slot
+   */
+  void FreeSlot(const GenericKey<CLUSTERED_ROW_SIZE> &slot);
+
+  /**
+   * @return the first page of a new chain of overflow pages holding data, or INVALID_PAGE_ID if the disk is full
+   */
+  page_id_t WriteOverflowPages(const char *data, uint32_t len);
+
+  void FreeOverflowPages(page_id_t page_id);
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  Schema *schema_;
+  std::vector<uint32_t> key_map_;
+  Schema *key_schema_;
+  GenericComparator<CLUSTERED_KEY_SIZE> comparator_;
+  PrimaryTree tree_;
+  std::vector<SecondaryIndex> secondary_indexes_;
+  MemHeap *heap_;   // key schemas are allocated in it
+  ReaderWriterLatch latch_;   // scans and lookups share it, modifications hold it exclusively
+  [[maybe_unused]] LogManager *log_manager_;
+  [[maybe_unused]] LockManager *lock_manager_;
+};
+
+#endif //MINISQL_CLUSTERED_TABLE_H
@@ -0,0 +1,120 @@
+#ifndef MINISQL_COLUMN_DICTIONARY_H
+#define MINISQL_COLUMN_DICTIONARY_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/dictionary_page.h"
+#include "record/field.h"
+
+/**
+ * ColumnDictionary maps the distinct values of a char column with few of them, like a status or a category, to
+ * small codes, so that rows store a code instead of the value. Codes are given in the order values are added and
+ * never change, values are never removed. The values are persisted in a chain of DictionaryPage and indexed by
+ * value and by code in memory.
+ *
+ * Decode does not latch, values are kept in fixed chunks which are never moved, and a code is published by
+ * the size only after its value is written. Create, Open and Free must not run concurrently with other calls.
+ *
+ * Only values up to MAX_VALUE_LENGTH bytes are encoded, and only the first MAX_SIZE distinct values, other values
+ * are stored in rows as they are.
+ */
+class ColumnDictionary {
+public:
+  static constexpr uint32_t MAX_VALUE_LENGTH = DictionaryPage::MAX_VALUE_LENGTH;
+  static constexpr uint32_t MAX_SIZE = 1 << 16;
+  static constexpr uint32_t INVALID_CODE = UINT32_MAX;
+
+  static_assert(MAX_VALUE_LENGTH <= Field::INLINE_SIZE, "Decoded values must be stored in the field.");
+
+  explicit ColumnDictionary(BufferPoolManager *buffer_pool_manager)
+          : buffer_pool_manager_(buffer_pool_manager),
+            entries_per_page_(DictionaryPage::GetMaxEntryCount(buffer_pool_manager->GetPageSize())) {}
+
+  /**
+   * Allocate the first page of an empty dictionary in the given file
+   * @return id of the first dictionary page
+   */
+  page_id_t Create(file_id_t file_id);
+
+  /**
+   * Load a dictionary persisted in the chain starting from first_page_id
+   */
+  void Open(page_id_t first_page_id);
+
+  /**
+   * Release all dictionary pages
+   */
+  void Free();
+
+  /**
+   * @return code of the value, the value is added if it is new, INVALID_CODE if it is not encoded
+   */
+  uint32_t Encode(const char *data, uint32_t len);
+
+  /**
+   * @return code of the value, INVALID_CODE if it is not in the dictionary
+   */
+  uint32_t Lookup(const char *data, uint32_t len);
+
+  /**
+   * Set the value of the code of an encoded field
+   * @return false if the code is not in the dictionary
+   */
+  inline bool Decode(Field *field) const {
+    uint32_t code = field->GetCode();
+    if (code >= size_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    const Entry &entry = chunks_[code / CHUNK_SIZE][code % CHUNK_SIZE];
+    field->SetDecodedData(entry.data_, entry.len_);
+    return true;
+  }
+
+  /**
+   * @return number of distinct values
+   */
+  inline uint32_t GetSize() const { return size_.load(std::memory_order_acquire); }
+
+  inline page_id_t GetFirstPageId() const { return page_ids_.empty() ? INVALID_PAGE_ID : page_ids_.front(); }
+
+private:
+  /**
+   * Append a new value to the last dictionary page, a new page is chained when the last one is full
+   */
+  void Persist(const std::string &value);
+
+  /**
+   * Give the next code to the value in memory
+   */
+  void AddValue(const std::string &value);
+
+  /**
+   * Forget all values in memory
+   */
+  void Clear();
+
+private:
+  static constexpr uint32_t CHUNK_SIZE = 1 << 10;
+
+  struct Entry {
+    uint32_t len_;
+    char data_[MAX_VALUE_LENGTH];
+  };
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  uint32_t entries_per_page_;
+  std::vector<page_id_t> page_ids_;
+  std::unique_ptr<Entry[]> chunks_[MAX_SIZE / CHUNK_SIZE];   // value of each code, in chunks allocated on demand
+  std::atomic<uint32_t> size_{0};                           // number of values readable without the latch
+  std::unordered_map<std::string, uint32_t> codes_;         // code of each value
+  std::mutex latch_;                                        // guards codes_ and the pages
+};
+
+#endif //MINISQL_COLUMN_DICTIONARY_H
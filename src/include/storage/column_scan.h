@@ -0,0 +1,100 @@
+#ifndef MINISQL_COLUMN_SCAN_H
+#define MINISQL_COLUMN_SCAN_H
+
+#include <functional>
+#include <vector>
+
+#include "page/pax_page.h"
+#include "page/table_page.h"
+#include "record/field.h"
+#include "storage/table_heap.h"
+#include "transaction/transaction.h"
+
+/**
+ * Values of some columns of the tuples in a page, one vector per column indexed by slot. Slots without a live
+ * tuple are not selected.
+ *
+ * For a table in PAX format the vectors refer to the minipages of the page, otherwise the values are copied out
+ * of the rows. Either way a batch is only valid while the consumer it is passed to runs.
+ */
+class ColumnBatch {
+  friend class ColumnScan;
+
+public:
+  /**
+   * @return number of slots in the batch, including the ones not selected
+   */
+  inline size_t GetRowCount() const { return row_count_; }
+
+  inline uint32_t GetColumnCount() const { return vectors_.size(); }
+
+  inline bool IsSelected(size_t row) const { return PaxPage::GetBit(selection_.data(), row); }
+
+  /**
+   * @return rid of the tuple in a slot, the rid of its home slot for a tuple moved by an update
+   */
+  inline RowId GetRowId(size_t row) const { return rids_.empty() ? RowId(page_id_, row) : rids_[row]; }
+
+  /**
+   * @param i index of the column in the columns of the scan
+   */
+  inline bool IsNull(size_t row, uint32_t i) const { return PaxPage::GetBit(vectors_[i].nulls_, row); }
+
+  /**
+   * @return values of an int or float column, the value of a null field is undefined
+   */
+  template<typename T>
+  inline const T *GetValues(uint32_t i) const {
+    ASSERT(vectors_[i].type_ != TypeId::kTypeChar && sizeof(T) == Type::GetTypeSize(vectors_[i].type_),
+           "Values are not of type T.");
+    return reinterpret_cast<const T *>(vectors_[i].values_);
+  }
+
+  /**
+   * @return a field referring to the value, a value stored out of line or encoded is not fetched
+   */
+  Field GetField(size_t row, uint32_t i) const;
+
+private:
+  struct ColumnVector {
+    TypeId type_{TypeId::kTypeInvalid};
+    const char *nulls_{nullptr};
+    const char *values_{nullptr};   /** for a char column, offsets of the values in the page */
+    std::vector<char> null_buffer_;   /** values copied out of rows */
+    std::vector<char> value_buffer_;
+  };
+
+  page_id_t page_id_{INVALID_PAGE_ID};
+  char *page_data_{nullptr};
+  size_t row_count_{0};
+  std::vector<char> selection_;
+  std::vector<RowId> rids_;   /** rids of the selected slots of a page in row format */
+  std::vector<ColumnVector> vectors_;
+};
+
+/**
+ * Scan of some columns of a table heap, page by page in the order of the page chain. Pages of a table in PAX
+ * format are passed to the consumer without copying their values.
+ */
+class ColumnScan {
+public:
+  using Consumer = std::function<void(const ColumnBatch &batch)>;
+
+  explicit ColumnScan(TableHeap *table_heap, std::vector<uint32_t> columns);
+
+  /**
+   * Pass the columns of every page of the table to consumer
+   */
+  void Scan(const Consumer &consumer, Transaction *txn);
+
+private:
+  void ReadPage(PaxPage *page, ColumnBatch &batch);
+
+  void ReadPage(TablePage *page, ColumnBatch &batch);
+
+private:
+  TableHeap *table_heap_;
+  std::vector<uint32_t> columns_;
+};
+
+#endif //MINISQL_COLUMN_SCAN_H
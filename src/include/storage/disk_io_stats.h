@@ -0,0 +1,107 @@
+#ifndef MINISQL_DISK_IO_STATS_H
+#define MINISQL_DISK_IO_STATS_H
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+// kind of pages in a disk file, see DiskManager for the file layout
+enum class DiskPageType {
+  META_PAGE = 0, BITMAP_PAGE, DATA_PAGE
+};
+
+enum class DiskIOType {
+  READ = 0, WRITE
+};
+
+/**
+ * Log-scaled latency histogram in nanoseconds. Every power of two is split into 4 buckets,
+ * so a percentile is reported with at most 25% error.
+ */
+class LatencyHistogram {
+public:
+  static constexpr uint32_t BUCKET_NUM = 160;
+
+  void Record(uint64_t latency_ns);
+
+  uint64_t GetCount() const { return count_.load(std::memory_order_relaxed); }
+
+  uint64_t GetTotalLatency() const { return total_ns_.load(std::memory_order_relaxed); }
+
+  /**
+   * @param quantile in (0, 1], e.g. 0.99 for p99
+   * @return upper bound of the bucket which holds the quantile, 0 if nothing recorded
+   */
+  uint64_t GetPercentile(double quantile) const;
+
+  void Reset();
+
+  static uint32_t GetBucketIndex(uint64_t latency_ns);
+
+  static uint64_t GetBucketUpperBound(uint32_t index);
+
+private:
+  std::atomic<uint64_t> buckets_[BUCKET_NUM]{};
+  std::atomic<uint64_t> count_{0};
+  std::atomic<uint64_t> total_ns_{0};
+};
+
+/**
+ * I/O counters of a disk file: number of operations, bytes moved and latency, per page type and I/O type.
+ */
+class DiskIOStats {
+public:
+  static constexpr uint32_t PAGE_TYPE_NUM = 3;
+  static constexpr uint32_t IO_TYPE_NUM = 2;
+
+  void Record(DiskPageType page_type, DiskIOType io_type, uint64_t bytes, uint64_t latency_ns) {
+    auto &counter = GetCounter(page_type, io_type);
+    counter.bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    counter.latency_.Record(latency_ns);
+  }
+
+  uint64_t GetCount(DiskPageType page_type, DiskIOType io_type) const {
+    return GetCounter(page_type, io_type).latency_.GetCount();
+  }
+
+  uint64_t GetBytes(DiskPageType page_type, DiskIOType io_type) const {
+    return GetCounter(page_type, io_type).bytes_.load(std::memory_order_relaxed);
+  }
+
+  const LatencyHistogram &GetLatency(DiskPageType page_type, DiskIOType io_type) const {
+    return GetCounter(page_type, io_type).latency_;
+  }
+
+  /**
+   * Print one line per page type and I/O type: ops, bytes, throughput and p50/p99/p999 latency
+   */
+  void Dump(std::ostream &os) const;
+
+  /**
+   * Append the stats to a file
+   * @return false if the file can not be opened
+   */
+  bool DumpToFile(const std::string &file_name) const;
+
+  void Reset();
+
+private:
+  struct IOCounter {
+    std::atomic<uint64_t> bytes_{0};
+    LatencyHistogram latency_;
+  };
+
+  IOCounter &GetCounter(DiskPageType page_type, DiskIOType io_type) {
+    return counters_[static_cast<int>(page_type)][static_cast<int>(io_type)];
+  }
+
+  const IOCounter &GetCounter(DiskPageType page_type, DiskIOType io_type) const {
+    return counters_[static_cast<int>(page_type)][static_cast<int>(io_type)];
+  }
+
+private:
+  IOCounter counters_[PAGE_TYPE_NUM][IO_TYPE_NUM];
+};
+
+#endif //MINISQL_DISK_IO_STATS_H
@@ -6,10 +6,12 @@
 #include <iostream>
 #include <mutex>
 #include <string>
+#include <vector>
 #include "common/config.h"
 #include "common/macros.h"
 #include "page/bitmap_page.h"
 #include "page/disk_file_meta_page.h"
+#include "storage/disk_io_stats.h"
 
 /**
  * DiskManager takes care of the allocation and de allocation of pages within a database. It performs the reading and
@@ -18,15 +20,20 @@
  * Disk page storage format: (Free Page BitMap Size = PAGE_SIZE * 8, we note it as N)
  * | Meta Page | Free Page BitMap 1 | Page 1 | Page 2 | ....
  *      | Page N | Free Page BitMap 2 | Page N+1 | ... | Page 2N | ... |
+ *
+ * The page size is chosen when the file is created and recorded in the meta page, an existing file is always
+ * opened with its recorded page size.
  */
 class DiskManager {
 public:
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, uint32_t page_size = PAGE_SIZE);
 
   ~DiskManager() {
     if (!closed) {
       Close();
     }
+    delete[] meta_data_;
+    delete[] bitmap_data_;
   }
 
   /**
@@ -52,6 +59,11 @@ public:
    */
   void DeAllocatePage(page_id_t logical_page_id);
 
+  /**
+   * Free a batch of pages, the bitmap page of each extent is read and written once
+   */
+  void DeAllocatePages(std::vector<page_id_t> logical_page_ids);
+
   /**
    * Return whether specific logical_page_id is free
    */
@@ -70,6 +82,24 @@ public:
     return meta_data_;
   }
 
+  inline const std::string &GetFileName() const { return file_name_; }
+
+  /**
+   * @return the page size of the database file
+   */
+  inline uint32_t GetPageSize() const { return page_size_; }
+
+  /**
+   * @return the number of pages one bitmap page can record with the page size of this file
+   */
+  inline size_t GetBitmapSize() const { return bitmap_size_; }
+
+  /**
+   * I/O counters and latency histograms of this file, broken down into meta, bitmap and data pages
+   */
+  inline DiskIOStats &GetIOStats() { return io_stats_; }
+
+  /** Bitmap capacity with the default page size */
   static constexpr size_t BITMAP_SIZE = BitmapPage<PAGE_SIZE>::GetMaxSupportedSize();
 
 private:
@@ -78,6 +108,29 @@ private:
    */
   int GetFileSize(const std::string &file_name);
 
+  /**
+   * Read the page size recorded in the meta page of an existing file
+   * @return 0 if the file is empty or the page size is not recorded
+   */
+  uint32_t ReadRecordedPageSize();
+
+  /**
+   * Physical page id of the bitmap page which manages the given extent
+   */
+  page_id_t GetBitmapPhysicalId(uint32_t extent_id) const {
+    return static_cast<page_id_t>(1 + extent_id * (bitmap_size_ + 1));
+  }
+
+  /**
+   * Whether the physical page is the meta page, a bitmap page or a data page
+   */
+  DiskPageType GetPageType(page_id_t physical_page_id) const {
+    if (physical_page_id == META_PAGE_ID) {
+      return DiskPageType::META_PAGE;
+    }
+    return (physical_page_id - 1) % (bitmap_size_ + 1) == 0 ? DiskPageType::BITMAP_PAGE : DiskPageType::DATA_PAGE;
+  }
+
   /**
    * Read physical page from disk
    */
@@ -100,7 +153,12 @@ private:
   // with multiple buffer pool instances, need to protect file access
   std::recursive_mutex db_io_latch_;
   bool closed{false};
-  char meta_data_[PAGE_SIZE];
+  uint32_t page_size_;
+  size_t bitmap_size_;
+  char *meta_data_;
+  // buffer to read/modify/write bitmap pages, protected by db_io_latch_
+  char *bitmap_data_;
+  DiskIOStats io_stats_;
 };
 
 #endif
\ No newline at end of file
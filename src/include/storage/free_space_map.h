@@ -0,0 +1,141 @@
+#ifndef MINISQL_FREE_SPACE_MAP_H
+#define MINISQL_FREE_SPACE_MAP_H
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "page/free_space_map_page.h"
+
+/**
+ * FreeSpaceMap tracks the free space of every page of a table heap in coarse buckets, so that an insert finds
+ * a page with enough room without walking the page chain. The bucket of each page is persisted in a chain of
+ * FreeSpaceMapPage, and indexed by bucket in memory.
+ *
+ * A page in bucket b has at least b * (page size / BUCKET_NUM) bytes free.
+ */
+class FreeSpaceMap {
+public:
+  static constexpr uint32_t BUCKET_NUM = 64;
+
+  explicit FreeSpaceMap(BufferPoolManager *buffer_pool_manager)
+          : buffer_pool_manager_(buffer_pool_manager),
+            bucket_width_(buffer_pool_manager->GetPageSize() / BUCKET_NUM),
+            entries_per_page_(FreeSpaceMapPage::GetMaxEntryCount(buffer_pool_manager->GetPageSize())) {}
+
+  /**
+   * Allocate the first map page of an empty map in the given file
+   * @return id of the first map page
+   */
+  page_id_t Create(file_id_t file_id);
+
+  /**
+   * Load a map persisted in the chain starting from first_map_page_id
+   */
+  void Open(page_id_t first_map_page_id);
+
+  /**
+   * Drop all entries, map pages are kept for reuse
+   */
+  void Clear();
+
+  /**
+   * Release all map pages
+   */
+  void Free();
+
+  /**
+   * Fetch a table page with at least size bytes free. The page is pinned before the map is unlatched, so that
+   * it is not released if it is removed before the caller latches it.
+   * @return the pinned page, nullptr if there is none
+   */
+  Page *FetchPage(uint32_t size);
+
+  /**
+   * Fetch the last table page appended to the map, pinned as in FetchPage
+   */
+  Page *FetchLastPage();
+
+  /**
+   * Record the free space of a table page linked into the table heap, a page not in the map yet is appended
+   */
+  void Add(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Record the free space of a table page in the map, a page not in the map, e.g. one removed since the
+   * caller wrote it, is ignored
+   */
+  void Update(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Drop the entry of a table page unlinked from the table heap, the entries after it keep their order
+   */
+  void Remove(page_id_t page_id);
+
+  /**
+   * @return the last table page appended to the map
+   */
+  page_id_t GetLastPageId();
+
+  /**
+   * @return number of table pages in the map
+   */
+  uint32_t GetPageCount();
+
+  /**
+   * @return all table pages in the map, in the order they were appended
+   */
+  std::vector<page_id_t> GetPageIds();
+
+  inline uint32_t GetBucket(uint32_t free_space) const {
+    return std::min(free_space / bucket_width_, BUCKET_NUM - 1);
+  }
+
+private:
+  void ClearEntries();
+
+  page_id_t GetLastEntryPageId();
+
+  /**
+   * Drop the entries of removed pages from memory and the map pages
+   */
+  void Compact();
+
+  /**
+   * Append an entry in memory
+   * @return the new entry
+   */
+  uint32_t AddEntry(page_id_t page_id, uint32_t bucket);
+
+  /**
+   * Move an entry to another bucket
+   */
+  void UpdateEntry(uint32_t entry, uint32_t bucket);
+
+  void AddToBucket(uint32_t entry, uint32_t bucket);
+
+  void RemoveFromBucket(uint32_t entry);
+
+  /**
+   * Write the bucket of an entry to its map page, a new map page is chained when the last one is full
+   */
+  void Persist(uint32_t entry);
+
+private:
+  BufferPoolManager *buffer_pool_manager_;
+  uint32_t bucket_width_;
+  uint32_t entries_per_page_;
+  std::vector<page_id_t> map_page_ids_;
+  std::vector<page_id_t> page_ids_;                    // table page of each entry, invalid if removed
+  uint32_t removed_count_{0};                          // entries of removed pages
+  std::vector<uint8_t> buckets_;                       // bucket of each entry
+  std::vector<uint32_t> bucket_pos_;                   // position of each entry in the list of its bucket
+  std::unordered_map<page_id_t, uint32_t> entry_of_;   // entry of each table page
+  std::vector<uint32_t> bucket_entries_[BUCKET_NUM];   // entries in each bucket
+  uint64_t non_empty_buckets_{0};                      // bit b is set iff bucket b has entries
+  std::mutex latch_;
+};
+
+#endif //MINISQL_FREE_SPACE_MAP_H
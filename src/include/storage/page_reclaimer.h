@@ -0,0 +1,71 @@
+#ifndef MINISQL_PAGE_RECLAIMER_H
+#define MINISQL_PAGE_RECLAIMER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/table_heap.h"
+
+/**
+ * Background worker releasing the pages of dropped and truncated tables, so that DDL statements return without
+ * walking the page chains of the tables.
+ *
+ * Pages which are still pinned when they are released are retried until they are unpinned.
+ */
+class PageReclaimer {
+public:
+  explicit PageReclaimer(BufferPoolManager *buffer_pool_manager);
+
+  /**
+   * Release the pages queued so far and stop the background thread
+   */
+  ~PageReclaimer();
+
+  /**
+   * Queue all pages of a table heap to be released, the table heap must not be used any more. It is destroyed
+   * once its pages are released, so the memory it is placed in must outlive the reclaimer.
+   * @param on_released called after the table heap is destroyed, e.g. to destroy the table it belonged to
+   */
+  void Release(TableHeap *table_heap, std::function<void()> on_released = nullptr);
+
+  /**
+   * Queue pages to be released, e.g. the pages of a dropped index
+   */
+  void Release(std::vector<page_id_t> page_ids);
+
+  /**
+   * Wait until all pages queued so far are released
+   */
+  void Drain();
+
+private:
+  struct Task {
+    TableHeap *table_heap_{nullptr};   /** table heap to free, or nullptr to release page_ids_ */
+    std::vector<page_id_t> page_ids_;
+    std::function<void()> on_released_;
+  };
+
+  void Run();
+
+  inline bool IsIdle() const { return tasks_.empty() && !busy_ && pinned_page_ids_.empty(); }
+
+private:
+  static constexpr std::chrono::milliseconds RETRY_INTERVAL{10};   // pause before retrying pinned pages
+  BufferPoolManager *buffer_pool_manager_;
+  std::thread thread_;
+  std::mutex latch_;   // guards the members below
+  std::condition_variable task_cv_;
+  std::condition_variable idle_cv_;
+  std::deque<Task> tasks_;
+  std::vector<page_id_t> pinned_page_ids_;   // pages to retry
+  bool busy_{false};
+  bool stop_requested_{false};
+};
+
+#endif //MINISQL_PAGE_RECLAIMER_H
@@ -0,0 +1,98 @@
+#ifndef MINISQL_PARALLEL_TABLE_SCAN_H
+#define MINISQL_PARALLEL_TABLE_SCAN_H
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "record/row_view.h"
+#include "storage/scan_predicate.h"
+#include "storage/table_heap.h"
+#include "transaction/transaction.h"
+
+/**
+ * Morsel-driven scan of a table heap with several worker threads.
+ *
+ * The pages of the heap, taken from its free space map, are split into morsels of consecutive pages. Every
+ * worker starts with an equal share of morsels in its own queue, takes morsels from the front of it and steals
+ * from the back of the queue of another worker when its own runs out, so a slow worker does not hold up the scan.
+ *
+ * Rows are passed as views into the pinned pages, a row kept after the consumer returns must be materialized.
+ */
+class ParallelTableScan {
+public:
+  /**
+   * Called by a worker for every row of the table, partial results can be kept per worker id
+   */
+  using Consumer = std::function<void(uint32_t worker_id, const RowView &row)>;
+
+  static constexpr uint32_t DEFAULT_MORSEL_SIZE = 16;   // pages in a morsel
+
+  /**
+   * @param dop degree of parallelism, the scan runs in the calling thread if it is 1
+   */
+  explicit ParallelTableScan(TableHeap *table_heap, uint32_t dop, uint32_t morsel_size = DEFAULT_MORSEL_SIZE);
+
+  /**
+   * Pass every row of the table to consumer, rows of a page are passed in slot order by one worker
+   */
+  void Scan(const Consumer &consumer, Transaction *txn);
+
+  /**
+   * Evaluate predicate in the workers
+   * @return ids of the rows satisfying predicate, partial results of each worker are concatenated
+   */
+  std::vector<RowId> Filter(const std::function<bool(const RowView &row)> &predicate, Transaction *txn);
+
+  /**
+   * Evaluate predicate in the workers, pages whose zones can not satisfy it are not read
+   */
+  std::vector<RowId> Filter(const ScanPredicate &predicate, Transaction *txn);
+
+  inline uint32_t GetDegreeOfParallelism() const { return dop_; }
+
+  /**
+   * @return number of pages skipped by the last scan because their zones can not satisfy the predicate
+   */
+  inline size_t GetSkippedPageCount() const { return skipped_page_count_; }
+
+private:
+  /**
+   * Pages [begin, end) of the page list
+   */
+  struct Morsel {
+    size_t begin_;
+    size_t end_;
+  };
+
+  struct MorselQueue {
+    std::deque<Morsel> morsels_;
+    std::mutex latch_;
+  };
+
+  /**
+   * Take a morsel from the own queue of a worker, or steal one from another worker
+   * @return false if all morsels are taken
+   */
+  bool NextMorsel(uint32_t worker_id, Morsel &morsel);
+
+  /**
+   * Pass every row of the pages which may satisfy predicate to consumer
+   */
+  void Scan(const Consumer &consumer, const ScanPredicate *predicate, Transaction *txn);
+
+  void ScanPage(page_id_t page_id, uint32_t worker_id, const Consumer &consumer, Transaction *txn);
+
+  void RunWorker(uint32_t worker_id, const Consumer &consumer, Transaction *txn);
+
+private:
+  TableHeap *table_heap_;
+  uint32_t dop_;
+  uint32_t morsel_size_;
+  std::vector<page_id_t> page_ids_;
+  std::vector<MorselQueue> queues_;
+  size_t skipped_page_count_{0};
+};
+
+#endif //MINISQL_PARALLEL_TABLE_SCAN_H
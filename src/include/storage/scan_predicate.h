@@ -0,0 +1,87 @@
+#ifndef MINISQL_SCAN_PREDICATE_H
+#define MINISQL_SCAN_PREDICATE_H
+
+#include <vector>
+
+#include "record/field.h"
+#include "record/row_view.h"
+#include "storage/column_dictionary.h"
+
+class TableHeap;
+
+/**
+ * Conjunction of comparisons of single columns with constants, evaluated by a scan on the serialized tuples
+ * in a page, so tuples which do not match are skipped without building a Row.
+ *
+ * As in SQL, a comparison with a null value is never satisfied.
+ */
+class ScanPredicate {
+  friend class ZoneMap;
+
+public:
+  enum CompareOp {
+    kEqual,
+    kNotEqual,
+    kLessThan,
+    kLessThanEquals,
+    kGreaterThan,
+    kGreaterThanEquals,
+    kIsNull,
+    kNotNull
+  };
+
+  /**
+   * @param table_heap heap to fetch the values stored out of line from and to decode encoded values with, may be
+   * null if no compared column has values stored out of line or encoded
+   */
+  explicit ScanPredicate(TableHeap *table_heap = nullptr) : table_heap_(table_heap) {}
+
+  /**
+   * Add `column op value`, value must have the type of the column and is copied
+   */
+  void AddComparison(uint32_t column, CompareOp op, const Field &value);
+
+  /**
+   * Add `column is null` or `column is not null`
+   */
+  void AddNullCheck(uint32_t column, bool is_null);
+
+  inline bool IsEmpty() const { return comparisons_.empty(); }
+
+  inline size_t GetComparisonCount() const { return comparisons_.size(); }
+
+  /**
+   * @return true if row satisfies all comparisons
+   */
+  bool Evaluate(const RowView &row) const;
+
+private:
+  /**
+   * @return true if the serialized value in a tuple satisfies the comparison with the serialized constant
+   */
+  using MatchFunc = bool (*)(const char *storage, const char *value);
+
+  struct Comparison {
+    Comparison(uint32_t column, CompareOp op, const Field &value) : column_(column), op_(op), value_(value) {}
+
+    uint32_t column_;
+    CompareOp op_;
+    Field value_;
+    std::vector<char> value_data_;   /** serialized value_ */
+    MatchFunc match_{nullptr};   /** kernel of the type and the operator, null if value_ is null */
+    uint32_t code_{ColumnDictionary::INVALID_CODE};   /** dictionary code of value_ for an (in)equality */
+  };
+
+  /**
+   * Select the kernel of a comparison once, so that evaluating it needs neither a Field nor a virtual call
+   */
+  static MatchFunc SelectMatch(TypeId type_id, CompareOp op);
+
+  static CmpBool Compare(const Field &field, const Comparison &comparison);
+
+private:
+  TableHeap *table_heap_;
+  std::vector<Comparison> comparisons_;
+};
+
+#endif //MINISQL_SCAN_PREDICATE_H
@@ -1,48 +1,111 @@
 #ifndef MINISQL_TABLE_HEAP_H
 #define MINISQL_TABLE_HEAP_H
 
+#include <memory>
+#include <mutex>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "page/pax_page.h"
 #include "page/table_page.h"
+#include "storage/column_dictionary.h"
+#include "storage/free_space_map.h"
 #include "storage/table_iterator.h"
+#include "storage/zone_map.h"
 #include "transaction/log_manager.h"
 #include "transaction/lock_manager.h"
 
+/**
+ * Layout of the pages of a table heap
+ */
+enum TableFormat {
+  kRowFormat = 0,   /** tuples are stored as serialized rows in TablePage */
+  kPaxFormat        /** values of each column are stored together in PaxPage, for tables mostly scanned */
+};
+
+/**
+ * Work done by vacuuming pages of a table heap
+ */
+struct VacuumStats {
+  size_t page_count_{0};            /** pages vacuumed */
+  size_t tuple_count_{0};           /** deleted tuples removed */
+  size_t reclaimed_size_{0};        /** bytes freed in the vacuumed pages */
+  size_t released_page_count_{0};   /** empty pages unlinked from the page chain */
+
+  VacuumStats &operator+=(const VacuumStats &other) {
+    page_count_ += other.page_count_;
+    tuple_count_ += other.tuple_count_;
+    reclaimed_size_ += other.reclaimed_size_;
+    released_page_count_ += other.released_page_count_;
+    return *this;
+  }
+};
+
 class TableHeap {
   friend class TableIterator;
 
+  friend class ParallelTableScan;
+
+  friend class ColumnScan;
+
 public:
+  /**
+   * Create a table heap whose pages are allocated in the given tablespace file
+   */
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           file_id_t file_id = DEFAULT_FILE_ID, TableFormat format = kRowFormat) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, schema, txn, log_manager, lock_manager, file_id, format);
   }
 
   static TableHeap *Create(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap) {
+                           LogManager *log_manager, LockManager *lock_manager, MemHeap *heap,
+                           TableFormat format = kRowFormat) {
     void *buf = heap->Allocate(sizeof(TableHeap));
-    return new(buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager);
+    return new(buf) TableHeap(buffer_pool_manager, first_page_id, schema, log_manager, lock_manager, format);
   }
 
-  ~TableHeap() {}
+  /**
+   * Table heaps are placed in a MemHeap by Create, so their owner destroys them explicitly with ~TableHeap()
+   * before the MemHeap is released. Pages of the table heap are kept, see FreeHeap.
+   */
+  ~TableHeap() = default;
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into the table. Long char values are moved to overflow pages until the row is short enough,
+   * if the row still does not fit in a page, return false. Tuples of a table in PAX format are appended to its
+   * last page, space freed in other pages is only reused by updates. Values of row stay in row.
    * @param[in/out] row Tuple Row to insert, the rid of the inserted tuple is wrapped in object row
    * @param[in] txn The transaction performing the insert
    * @return true iff the insert is successful
    */
   bool InsertTuple(Row &row, Transaction *txn);
 
+  /**
+   * Insert rows in order, filling each page under a single pin and latch. When no page has room, new pages are
+   * allocated in a run sized for the remaining rows.
+   * @param[in/out] rows Rows to insert, the rid of each inserted row is wrapped in it
+   * @param[in] txn The transaction performing the insert
+   * @return rids of the inserted rows, fewer than rows if a row is too large or no page can be allocated
+   */
+  std::vector<RowId> InsertTuples(std::vector<Row> &rows, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param[in] rid Resource id of the tuple of delete
    * @param[in] txn Transaction performing the delete
-   * @return true iff the delete is successful (i.e the tuple exists)
+   * @return true iff the tuple is marked (i.e the tuple exists and is not deleted yet)
    */
   bool MarkDelete(const RowId &rid, Transaction *txn);
 
   /**
-   * if the new tuple is too large to fit in the old page, return false (will delete and insert)
+   * Update a tuple in place. If the new tuple is too large to fit in the page of a table in row format, it is
+   * moved to another page and its slot keeps a forward record, so the rid of the tuple does not change. For a
+   * table in PAX format return false (will delete and insert).
    * @param[in] row Tuple of new row
    * @param[in] rid Rid of the old tuple
    * @param[in] txn Transaction performing the update
@@ -73,15 +136,48 @@ public:
   bool GetTuple(Row *row, Transaction *txn);
 
   /**
-   * Free table heap and release storage in disk file
+   * Read a tuple from the table, values stored out of line are only fetched for the projected columns.
+   * Values of other columns are left unfetched and can be fetched later by FetchField.
+   * @param[in] columns Indexes of the projected columns
    */
-  void FreeHeap();
+  bool GetTuple(Row *row, const std::vector<uint32_t> &columns, Transaction *txn);
+
+  /**
+   * Fetch a value stored out of line from its overflow pages
+   * @return false if the overflow pages can not be read
+   */
+  bool FetchField(Field *field);
+
+  /**
+   * Fetch a value of a column stored out of line, or decode it if it is encoded in the dictionary of the column
+   * @return false if the value can not be read
+   */
+  inline bool FetchField(Field *field, uint32_t column) {
+    if (!field->IsEncoded()) {
+      return FetchField(field);
+    }
+    ColumnDictionary *dictionary = GetDictionary(column);
+    return dictionary != nullptr && dictionary->Decode(field);
+  }
+
+  /**
+   * Free table heap and release storage in disk file, pages are deallocated in batches
+   * @return pages which are still pinned and not released
+   */
+  std::vector<page_id_t> FreeHeap();
 
   /**
    * @return the begin iterator of this table
    */
   TableIterator Begin(Transaction *txn);
 
+  /**
+   * @param predicate tuples not satisfying it are skipped on their pages, must outlive the iterator
+   * @param columns projected columns, the fields of other columns are null in the rows read by the iterator
+   * @return the begin iterator of the tuples of this table satisfying predicate
+   */
+  TableIterator Begin(Transaction *txn, const ScanPredicate *predicate, const std::vector<uint32_t> &columns);
+
   /**
    * @return the end iterator of this table
    */
@@ -92,34 +188,287 @@ public:
    */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /**
+   * @return number of table pages of this table
+   */
+  inline uint32_t GetPageCount() { return free_space_map_.GetPageCount(); }
+
+  inline TableFormat GetFormat() const { return format_; }
+
+  /**
+   * @return the tablespace file all pages of this table are allocated in
+   */
+  inline file_id_t GetFileId() const { return ::GetFileId(first_page_id_); }
+
+  /**
+   * Rebuild the free space map from the table pages, used when the map is missing or stale
+   */
+  void RebuildFreeSpaceMap();
+
+  /**
+   * Keep the min and max values of columns in every page, scans with a predicate on them skip the pages which
+   * can not satisfy it. Zones are built from the pages, the table must not be modified meanwhile.
+   */
+  void EnableZoneMap(const std::vector<uint32_t> &columns);
+
+  /**
+   * @return the zone map of this table, or nullptr if it is not enabled
+   */
+  inline ZoneMap *GetZoneMap() const { return zone_map_.get(); }
+
+  /**
+   * Store the values of a char column with few distinct values as codes of a dictionary of the column, values
+   * written before keep their bytes. Tuples read from the table heap have their values decoded, views of tuples,
+   * as passed to the consumers of scans, keep the codes until their fields are fetched. Equality predicates on
+   * the column compare codes. The column must not be enabled while tuples are inserted.
+   * @return the first page of the dictionary, to open it with when the table heap is loaded, TableInfo keeps it in
+   * the table metadata
+   */
+  page_id_t EnableDictionary(uint32_t column);
+
+  /**
+   * Open the dictionary of a column of a loaded table heap
+   */
+  void OpenDictionary(uint32_t column, page_id_t first_page_id);
+
+  /**
+   * @return the dictionary of a column, or nullptr if the column is not encoded
+   */
+  inline ColumnDictionary *GetDictionary(uint32_t column) const {
+    return column < dictionaries_.size() ? dictionaries_[column].get() : nullptr;
+  }
+
+  /**
+   * In append mode a tuple is inserted into the tail page of the inserting thread instead of a page found in the
+   * free space map. Threads are spread over a few tails, each caching its page id and free space, and the next
+   * tail pages are allocated in extents. For insert-only tables in row format, the mode must not be changed while
+   * tuples are inserted.
+   */
+  void SetAppendMode(bool append_mode);
+
+  inline bool IsAppendMode() const { return !append_tails_.empty(); }
+
+  /**
+   * Take the pages in which tuples were marked deleted since they were last taken. All pages of a loaded table
+   * heap are taken, as its deletes are not known. A page with a tuple marked deleted by a transaction which is
+   * not committed or aborted yet, i.e. ApplyDelete or RollbackDelete is not called for the tuple, is left to a
+   * later pass. A delete without a transaction is committed once it is marked.
+   * @param max max number of pages to take
+   */
+  std::vector<page_id_t> TakePagesWithDeletes(size_t max);
+
+  /**
+   * Apply the deletes of the tuples marked deleted in a page, compact the page and update its free space and
+   * zone. An empty page other than the first one is unlinked from the page chain and released once no reader
+   * may still move to it, see EnterEpoch.
+   * @param[in/out] stats the work done is added to it
+   */
+  void VacuumPage(page_id_t page_id, VacuumStats &stats, Transaction *txn);
+
 private:
   /**
    * create table heap and initialize first page
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
-                     LogManager *log_manager, LockManager *lock_manager) :
-          buffer_pool_manager_(buffer_pool_manager),
-          schema_(schema),
-          log_manager_(log_manager),
-          lock_manager_(lock_manager) {
-    ASSERT(false, "Not implemented yet.");
-  };
+                     LogManager *log_manager, LockManager *lock_manager, file_id_t file_id, TableFormat format);
 
   /**
    * load existing table heap by first_page_id
    */
   explicit TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
-                     LogManager *log_manager, LockManager *lock_manager)
-          : buffer_pool_manager_(buffer_pool_manager),
-            first_page_id_(first_page_id),
-            schema_(schema),
-            log_manager_(log_manager),
-            lock_manager_(lock_manager) {}
+                     LogManager *log_manager, LockManager *lock_manager, TableFormat format);
+
+  /**
+   * Call visitor with page as a PaxPage or a TablePage, according to the format of this table
+   */
+  template<typename Visitor>
+  inline auto VisitPage(Page *page, Visitor &&visitor) const {
+    if (format_ == kPaxFormat) {
+      return visitor(reinterpret_cast<PaxPage *>(page));
+    }
+    return visitor(reinterpret_cast<TablePage *>(page));
+  }
+
+  /**
+   * Initialize a new page of this table
+   * @param char_size expected size of the char values of a tuple, decides the capacity of a page in PAX format
+   */
+  void InitPage(Page *page, page_id_t page_id, page_id_t prev_id, uint32_t char_size, Transaction *txn);
+
+  /**
+   * Append a run of new pages to the end of the page chain and register them in the free space map
+   * @param char_size see InitPage
+   * @return ids of the new pages, fewer than count if the disk is full
+   */
+  std::vector<page_id_t> NewTablePages(size_t count, Transaction *txn, uint32_t char_size = 0);
+
+  /**
+   * Append tuples to the last page of a table in PAX format, new pages are sized for the char values of the
+   * tuples in the last one
+   * @return number of tuples inserted, tuples after one which does not fit in a new page are not inserted
+   */
+  size_t AppendTuples(Row *rows, size_t count, Transaction *txn);
+
+  /**
+   * Tail page which the inserting threads mapped to it append tuples to in append mode
+   */
+  struct AppendTail {
+    std::mutex latch_;   // serializes the inserts of the threads sharing the tail
+    page_id_t page_id_{INVALID_PAGE_ID};
+    uint32_t free_space_{0};   // free space of the page after the last insert into it
+    std::vector<page_id_t> spare_page_ids_;   // unused pages of the extent of the tail, last one first
+  };
+
+  /**
+   * Insert a tuple into the tail page of the calling thread
+   */
+  bool AppendTuple(Row &row, Transaction *txn);
+
+  /**
+   * Retire the page of a tail and take the next page of its extent, allocating a new extent if none is left
+   * @return false if no page can be allocated
+   */
+  bool AdvanceTail(AppendTail &tail, Transaction *txn);
+
+  /**
+   * Register the free space of the page of a tail in the free space map, so that it can be reused by updates
+   */
+  void RetireTail(AppendTail &tail);
+
+  /**
+   * Insert a tuple into a page with room for it, allocating a new page if there is none
+   * @param[in/out] row the rid of the inserted tuple is wrapped in it
+   * @param[in] home_rid home slot of a tuple moved by an update, or nullptr for a new tuple
+   */
+  bool PlaceTuple(Row &row, const RowId *home_rid, Transaction *txn);
+
+  /**
+   * Update a tuple in the page holding it
+   * @param[in/out] old_row its rid is the slot of the tuple, the old values are read into it
+   * @param[out] target_rid if the update fails, the location of the tuple if the slot holds a forward record,
+   * the slot itself if the tuple does not fit in the page, or an invalid rid if the tuple is deleted
+   */
+  bool UpdateTupleInPage(const Row &new_row, Row *old_row, RowId *target_rid, Transaction *txn);
+
+  /**
+   * Update a tuple which does not fit where it is. The tuple goes back to its home slot if it fits there,
+   * otherwise it is moved to another page and the forward record in its home slot is pointed at it.
+   * @param[in] target_rid location of the tuple
+   */
+  bool MoveTuple(const Row &new_row, const RowId &rid, const RowId &target_rid, Row *old_row, Transaction *txn);
+
+  /**
+   * Delete the tuple in slot rid from its page
+   * @param[out] old_row the values of the tuple are read into it if it is not nullptr
+   * @param[in] finished_rid home slot of the tuple whose delete is finished once the slot is freed, or nullptr
+   */
+  void FreeSlot(const RowId &rid, Row *old_row, Transaction *txn, const RowId *finished_rid = nullptr);
+
+  /**
+   * @return the location of the tuple whose home slot is rid, rid itself if the tuple was not moved
+   */
+  RowId GetTargetRid(const RowId &rid);
+
+  /**
+   * Unlink an empty page from the page chain and release it
+   * @return false if the page is no longer empty
+   */
+  bool UnlinkPage(page_id_t page_id);
+
+  /**
+   * @return whether a latched page was unlinked from the page chain, an unlinked page has no prev page
+   */
+  inline bool IsUnlinked(Page *page) const {
+    return page->GetPageId() != first_page_id_ &&
+           reinterpret_cast<TablePage *>(page)->GetPrevPageId() == INVALID_PAGE_ID;
+  }
+
+  /**
+   * Forget a tuple marked deleted by a transaction once the transaction commits or aborts
+   * @param rid home slot of the tuple
+   */
+  void FinishDelete(const RowId &rid);
+
+  /**
+   * Release the unlinked pages which are no longer pinned or reachable by a reader
+   */
+  void ReleaseUnlinkedPages();
+
+  /**
+   * Register a reader which moves between pages without holding a pin on them, e.g. an iterator between its
+   * steps. A page unlinked by the vacuum is released only once the readers registered before the unlink are
+   * gone, until then its next page id still leads back to the chain.
+   * @return epoch of the reader, to unregister it with
+   */
+  uint64_t EnterEpoch();
+
+  /**
+   * Register a copy of a reader, at the epoch of the reader
+   */
+  void EnterEpoch(uint64_t epoch);
+
+  void ExitEpoch(uint64_t epoch);
+
+  /**
+   * Replace the values of encoded columns in a row by their codes, codes of values read from another table are
+   * cleared first
+   */
+  void EncodeRow(Row &row);
+
+  /**
+   * Store the values of the toasted and encoded fields of a row in row again once it is written, so that the
+   * caller's row does not refer to the overflow pages of the stored tuple and can still be used, e.g. to build
+   * index keys
+   */
+  void RestoreRow(Row &row);
+
+  /**
+   * Move the longest char values of a row to overflow pages until the row is short enough
+   * @return false if the row does not fit in a page or overflow pages can not be allocated
+   */
+  bool ToastRow(Row &row, Transaction *txn);
+
+  /**
+   * Release the overflow pages of the values of a row stored out of line
+   */
+  void FreeExternalFields(Row &row);
+
+  /**
+   * @return the first page of a new chain of overflow pages holding data, or INVALID_PAGE_ID if the disk is full
+   */
+  page_id_t WriteOverflowPages(const char *data, uint32_t len);
+
+  void FreeOverflowPages(page_id_t page_id);
+
+  /**
+   * Append the pages of a chain of overflow pages to page_ids
+   */
+  void CollectOverflowPages(page_id_t page_id, std::vector<page_id_t> &page_ids);
 
 private:
   BufferPoolManager *buffer_pool_manager_;
   page_id_t first_page_id_;
   Schema *schema_;
+  TableFormat format_;
+  FreeSpaceMap free_space_map_;
+  std::mutex append_latch_;   // serialize appending pages to the chain
+  static constexpr size_t MAX_PAGE_RUN = 64;   // max number of pages allocated at once by a batch insert
+  static constexpr uint32_t TOAST_MIN_LENGTH = 64;   // shorter char values are always stored in row
+  static constexpr size_t FREE_BATCH_SIZE = 256;   // pages deallocated at once when the heap is freed
+  bool has_char_column_{false};   // only rows with char columns may have values stored out of line
+  std::unique_ptr<ZoneMap> zone_map_;   // min and max values of some columns in each page, if enabled
+  std::vector<std::unique_ptr<ColumnDictionary>> dictionaries_;   // dictionary of each column, null if not encoded
+  std::mutex vacuum_latch_;   // guards the members below up to the append tails
+  std::unordered_set<page_id_t> pages_with_deletes_;   // pages to vacuum
+  std::unordered_map<int64_t, page_id_t> running_deletes_;   // home slots of the tuples marked deleted by
+                                                            // transactions not finished yet, to their pages
+  uint64_t epoch_{0};   // advanced whenever a page is unlinked
+  std::multiset<uint64_t> reader_epochs_;   // epochs of the registered readers
+  std::vector<std::pair<page_id_t, uint64_t>> unlinked_pages_;   // unlinked pages not released yet, by epoch
+  std::vector<std::unique_ptr<AppendTail>> append_tails_;   // tails of the inserting threads in append mode
+  std::unordered_set<page_id_t> append_page_ids_;   // pages of the tails and their extents, guarded by append_latch_
+  static constexpr size_t APPEND_TAIL_COUNT = 16;   // threads are mapped to the tails by their ids
+  static constexpr size_t APPEND_EXTENT_SIZE = 16;   // pages allocated at once for a tail
   [[maybe_unused]] LogManager *log_manager_;
   [[maybe_unused]] LockManager *lock_manager_;
 };
@@ -3,6 +3,8 @@
 
 #include "common/rowid.h"
 #include "record/row.h"
+#include "record/row_batch.h"
+#include "storage/scan_predicate.h"
 #include "transaction/transaction.h"
 
 
@@ -11,16 +13,28 @@ class TableHeap;
 class TableIterator {
 
 public:
-  // you may define your own constructor based on your member variables
+  /**
+   * End iterator of any table
+   */
   explicit TableIterator();
 
-  explicit TableIterator(const TableIterator &other);
+  /**
+   * Iterator at the first tuple in page_id or any page after it
+   * @param predicate tuples not satisfying it are skipped, all tuples are visited if it is null
+   * @param columns only these columns, in ascending order, are deserialized, all columns if it is null
+   */
+  explicit TableIterator(TableHeap *table_heap, page_id_t page_id, Transaction *txn,
+                         const ScanPredicate *predicate = nullptr, const std::vector<uint32_t> *columns = nullptr);
+
+  TableIterator(const TableIterator &other);
+
+  TableIterator &operator=(const TableIterator &other);
 
   virtual ~TableIterator();
 
-  inline bool operator==(const TableIterator &itr) const;
+  bool operator==(const TableIterator &itr) const;
 
-  inline bool operator!=(const TableIterator &itr) const;
+  bool operator!=(const TableIterator &itr) const;
 
   const Row &operator*();
 
@@ -30,8 +44,52 @@ public:
 
   TableIterator operator++(int);
 
+  /**
+   * Deserialize the tuples from the current one to the end of its page into batch, at most max rows, with the
+   * page pinned and latched once. The iterator moves to the tuple after the last one in batch. Only the
+   * tuples satisfying the predicate and the projected columns of the iterator are deserialized.
+   * @return number of rows in batch, 0 at the end of the table
+   */
+  size_t NextBatch(RowBatch &batch, size_t max);
+
+  /**
+   * @return number of pages skipped so far because their zones can not satisfy the predicate
+   */
+  inline size_t GetSkippedPageCount() const { return skipped_page_count_; }
+
+private:
+  /**
+   * Move to the first tuple in page_id or any page after it, or to the end
+   */
+  void SeekPage(page_id_t page_id);
+
+  /**
+   * Read the current tuple, or its projected columns, into row_. The row of a moved tuple has the rid of its
+   * home slot.
+   */
+  void ReadRow();
+
+  /**
+   * Mark the current row unread, the row is kept and reset to read the next tuple without allocating
+   */
+  void ResetRow();
+
+  /**
+   * @return true if the iterator is registered at epoch_ in its table heap, i.e. it is not at the end
+   */
+  inline bool IsRegistered() const { return table_heap_ != nullptr && rid_.GetPageId() != INVALID_PAGE_ID; }
+
 private:
-  // add your own private member variables here
+  TableHeap *table_heap_{nullptr};
+  RowId rid_{INVALID_ROWID};
+  Row *row_{nullptr};   /** the current row, read when it is first accessed */
+  bool is_row_read_{false};
+  Transaction *txn_{nullptr};
+  const ScanPredicate *predicate_{nullptr};   /** not owned, outlives the iterator */
+  bool is_projected_{false};
+  std::vector<uint32_t> columns_;   /** projected columns if is_projected_ */
+  size_t skipped_page_count_{0};
+  uint64_t epoch_{0};   /** pages the iterator may move to are not released while it is registered */
 };
 
 #endif //MINISQL_TABLE_ITERATOR_H
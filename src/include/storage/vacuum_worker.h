@@ -0,0 +1,74 @@
+#ifndef MINISQL_VACUUM_WORKER_H
+#define MINISQL_VACUUM_WORKER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "storage/table_heap.h"
+#include "transaction/transaction.h"
+
+/**
+ * Throttling knobs of a vacuum worker
+ */
+struct VacuumOptions {
+  std::chrono::milliseconds interval_{100};    /** pause between passes */
+  size_t round_page_count_{64};                /** pages vacuumed in a round */
+  std::chrono::milliseconds round_delay_{0};   /** pause after each round */
+};
+
+/**
+ * Background worker vacuuming a table heap, so that tuples marked deleted do not pile up in its pages.
+ *
+ * Every pass vacuums the pages in which tuples were marked deleted, in rounds of a few pages. The worker pauses
+ * after each round and between passes, so that it does not compete with the foreground for the buffer pool.
+ */
+class VacuumWorker {
+public:
+  explicit VacuumWorker(TableHeap *table_heap, VacuumOptions options = VacuumOptions())
+          : table_heap_(table_heap), options_(options) {}
+
+  ~VacuumWorker() { Stop(); }
+
+  /**
+   * Start vacuuming in a background thread
+   */
+  void Start();
+
+  /**
+   * Stop the background thread after its current round
+   */
+  void Stop();
+
+  /**
+   * Vacuum the pages with deletes in the calling thread, until none is left or the worker is stopped
+   * @return number of pages vacuumed
+   */
+  size_t RunPass(Transaction *txn);
+
+  /**
+   * @return work done by all passes so far
+   */
+  VacuumStats GetStats();
+
+  /**
+   * @return number of passes finished
+   */
+  size_t GetPassCount();
+
+private:
+  void Run();
+
+private:
+  TableHeap *table_heap_;
+  VacuumOptions options_;
+  std::thread thread_;
+  std::mutex latch_;   // guards the members below
+  std::condition_variable stop_cv_;
+  bool stop_requested_{false};
+  VacuumStats stats_;
+  size_t pass_count_{0};
+};
+
+#endif //MINISQL_VACUUM_WORKER_H
@@ -0,0 +1,80 @@
+#ifndef MINISQL_ZONE_MAP_H
+#define MINISQL_ZONE_MAP_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/config.h"
+#include "record/row.h"
+#include "record/row_view.h"
+#include "record/schema.h"
+#include "storage/scan_predicate.h"
+
+/**
+ * ZoneMap keeps the min and max value of selected columns of every page of a table heap, so that a scan skips
+ * the pages none of whose tuples can satisfy a predicate.
+ *
+ * Zones are kept in memory. They are widened when a tuple is inserted or updated, and not narrowed on delete,
+ * so a zone may be wider than the values left in its page. A page without a zone has no tuples.
+ */
+class ZoneMap {
+public:
+  /**
+   * @param columns columns to keep min and max values of
+   */
+  explicit ZoneMap(Schema *schema, const std::vector<uint32_t> &columns);
+
+  inline const std::vector<uint32_t> &GetColumns() const { return columns_; }
+
+  /**
+   * Widen the zone of a page by a tuple stored in it
+   */
+  void Update(page_id_t page_id, const Row &row);
+
+  void Update(page_id_t page_id, const RowView &row);
+
+  /**
+   * @return false if no tuple in the page can satisfy predicate
+   */
+  bool MayMatch(page_id_t page_id, const ScanPredicate &predicate);
+
+  /**
+   * Drop the zones of a page, e.g. to rebuild them from the tuples left in it
+   */
+  void Remove(page_id_t page_id);
+
+  /**
+   * Drop the zones of all pages
+   */
+  void Clear();
+
+private:
+  /**
+   * Values of a column in a page
+   */
+  struct Zone {
+    Field min_{TypeId::kTypeInvalid};
+    Field max_{TypeId::kTypeInvalid};
+    bool has_value_{false};
+    bool has_null_{false};
+    bool is_bounded_{true};   /** false once a value not kept in the zone is added, e.g. stored out of line */
+  };
+
+  std::vector<Zone> &GetZones(page_id_t page_id);
+
+  static void Widen(Zone &zone, const Field &value);
+
+  /**
+   * @return false if no value in zone can satisfy comparison
+   */
+  static bool MayMatch(const Zone &zone, const ScanPredicate::Comparison &comparison);
+
+private:
+  std::vector<uint32_t> columns_;
+  std::vector<int> zone_of_;   /** index of the zone of each column of the schema, -1 if it has none */
+  std::unordered_map<page_id_t, std::vector<Zone>> zones_;
+  std::mutex latch_;
+};
+
+#endif //MINISQL_ZONE_MAP_H
@@ -1,9 +1,11 @@
 #ifndef MINISQL_MEM_HEAP_H
 #define MINISQL_MEM_HEAP_H
 
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <unordered_set>
+#include <vector>
 #include "common/macros.h"
 
 class MemHeap {
@@ -47,6 +49,7 @@ public:
     auto iter = allocated_.find(ptr);
     if (iter != allocated_.end()) {
       allocated_.erase(iter);
+      free(ptr);
     }
   }
 
@@ -54,4 +57,78 @@ private:
   std::unordered_set<void *> allocated_;
 };
 
+/**
+ * Bump pointer heap, memory is carved in order from blocks and only released all at once, Free does nothing.
+ * Suits objects which die together, like the fields of a row, of a batch of rows or of a query.
+ */
+class ArenaMemHeap : public MemHeap {
+public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+
+  explicit ArenaMemHeap(size_t block_size = DEFAULT_BLOCK_SIZE) : block_size_(block_size) {}
+
+  ~ArenaMemHeap() override {
+    Reset();
+    for (auto block : blocks_) {
+      free(block);
+    }
+  }
+
+  ArenaMemHeap(const ArenaMemHeap &other) = delete;
+
+  ArenaMemHeap &operator=(const ArenaMemHeap &other) = delete;
+
+  void *Allocate(size_t size) override {
+    size = (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    if (size > static_cast<size_t>(end_ - cur_)) {
+      // allocations larger than a block get a block of their own
+      if (size > block_size_) {
+        void *buf = malloc(size);
+        ASSERT(buf != nullptr, "Out of memory exception");
+        large_blocks_.push_back(buf);
+        return buf;
+      }
+      NextBlock();
+    }
+    void *buf = cur_;
+    cur_ += size;
+    return buf;
+  }
+
+  void Free(void *) override {}
+
+  /**
+   * Release all allocations at once, blocks are kept and reused by later allocations
+   */
+  void Reset() {
+    for (auto block : large_blocks_) {
+      free(block);
+    }
+    large_blocks_.clear();
+    next_block_ = 0;
+    cur_ = end_ = nullptr;
+  }
+
+private:
+  void NextBlock() {
+    if (next_block_ == blocks_.size()) {
+      void *block = malloc(block_size_);
+      ASSERT(block != nullptr, "Out of memory exception");
+      blocks_.push_back(block);
+    }
+    cur_ = static_cast<char *>(blocks_[next_block_++]);
+    end_ = cur_ + block_size_;
+  }
+
+private:
+  static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+
+  const size_t block_size_;
+  std::vector<void *> blocks_;   /** blocks in use are [0, next_block_), the rest are kept after a reset */
+  std::vector<void *> large_blocks_;
+  size_t next_block_{0};
+  char *cur_{nullptr};
+  char *end_{nullptr};
+};
+
 #endif //MINISQL_MEM_HEAP_H
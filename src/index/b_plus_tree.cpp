@@ -1,4 +1,6 @@
 #include <string>
+#include <type_traits>
+
 #include "glog/logging.h"
 #include "index/b_plus_tree.h"
 #include "index/basic_comparator.h"
@@ -9,16 +11,39 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_TYPE::BPlusTree(index_id_t index_id, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
                           int leaf_max_size, int internal_max_size)
         : index_id_(index_id),
+          root_page_id_(INVALID_PAGE_ID),
           buffer_pool_manager_(buffer_pool_manager),
           comparator_(comparator),
           leaf_max_size_(leaf_max_size),
           internal_max_size_(internal_max_size) {
-
+  auto roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  if (!roots_page->GetRootId(index_id_, &root_page_id_)) {
+    root_page_id_ = INVALID_PAGE_ID;
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, false);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Destroy() {
+  if (IsEmpty()) {
+    return;
+  }
+  Destroy(root_page_id_);
+  root_page_id_ = INVALID_PAGE_ID;
+  UpdateRootPageId();
+}
 
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Destroy(page_id_t page_id) {
+  auto page = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(page_id)->GetData());
+  if (!page->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(page);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      Destroy(internal->ValueAt(i));
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  buffer_pool_manager_->DeletePage(page_id);
 }
 
 /*
@@ -26,8 +51,7 @@ void BPLUSTREE_TYPE::Destroy() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::IsEmpty() const {
-  if(root_page_id_==INVALID_PAGE_ID) return true;
-  return false;
+  return root_page_id_ == INVALID_PAGE_ID;
 }
 
 /*****************************************************************************
@@ -40,12 +64,34 @@ bool BPLUSTREE_TYPE::IsEmpty() const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result, Transaction *transaction) {
-   B_PLUS_TREE_LEAF_PAGE_TYPE *target=FindLeafPage(key,false);
-   if(target==nullptr) return false;
-   result.resize(1);
-   bool suc=target->Lookup(key,result[0],comparator_);
-   buffer_pool_manager_->UnpinPage(target->GetPageId(),false);
-   return suc;
+  auto page = FindLeafPage(key);
+  if (page == nullptr) {
+    return false;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType value;
+  bool found = leaf->Lookup(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+  if (found) {
+    result.push_back(value);
+  }
+  return found;
+}
+
+/*
+ * Replace the value associated with input key in place
+ * @return : false means key does not exist
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::Update(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  auto page = FindLeafPage(key);
+  if (page == nullptr) {
+    return false;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  bool updated = leaf->Update(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), updated);
+  return updated;
 }
 
 /*****************************************************************************
@@ -60,13 +106,13 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> &result
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  if(IsEmpty()) {
-    StartNewTree(key,value);
+  if (IsEmpty()) {
+    StartNewTree(key, value);
     return true;
   }
-  bool suc=InsertIntoLeaf(key,value,transaction);
-  return res;
+  return InsertIntoLeaf(key, value, transaction);
 }
+
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
@@ -75,15 +121,15 @@ bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transact
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
-  page_id_t new_page_id;
-  Page *rootPage=buffer_pool_manager_->NewPage(new_page_id);
-  B_PLUS_TREE_LEAF_PAGE_TYPE *root=reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(rootPage->GetData());
-
-  root->Init(new_page_id,INVALID_PAGE_ID);
-  root_page_id_=new_page_id;
+  page_id_t page_id;
+  auto page = buffer_pool_manager_->NewPage(page_id);
+  ASSERT(page != nullptr, "Out of memory.");
+  auto root = reinterpret_cast<LeafPage *>(page->GetData());
+  root->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  root->Insert(key, value, comparator_);
+  root_page_id_ = page_id;
   UpdateRootPageId(1);
-  root->Insert(key,value,comparator_);
-  buffer_pool_manager_->UnpinPage(new_page_id,true);
+  buffer_pool_manager_->UnpinPage(page_id, true);
 }
 
 /*
@@ -96,19 +142,20 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf=FindLeafPage(key,false);
-  ValueType v;
-  bool exist_in_parent=leaf->Lookup(key,v,comparator_);
-  if(exist_in_parent) {
-    buffer_pool_manager_->UnpinPage(leaf->GetPageId(),false);
+  auto leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key)->GetData());
+  ValueType old_value;
+  if (leaf->Lookup(key, old_value, comparator_)) {
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
     return false;
   }
-  leaf->Insert(key,value,comparator_);
-  if(leaf->GetSize()>leaf->GetMaxSize()){
-    B_PLUS_TREE_LEAF_PAGE_TYPE *newleaf=Split(leaf);
-    InsertIntoParent(leaf,newleaf->KeyAt(0),newleaf,transaction);
+  if (leaf->Insert(key, value, comparator_) > leaf->GetMaxSize()) {
+    auto new_leaf = Split(leaf);
+    new_leaf->SetNextPageId(leaf->GetNextPageId());
+    leaf->SetNextPageId(new_leaf->GetPageId());
+    InsertIntoParent(leaf, new_leaf->KeyAt(0), new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
   }
-  buffer_pool_manager_->UnpinPage(leaf->GetPageId(),true);
+  buffer_pool_manager_->UnpinPage(leaf->GetPageId(), true);
   return true;
 }
 
@@ -122,13 +169,17 @@ bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
-  page_id_t newpageID;
-  Page* const newPage=buffer_pool_manager_->NewPage(newpageID);
-  newPage->WLatch();
-  N* newNode=reinterpret_cast<N*>(newPage->GetData());
-  newNode->Init(newpageID,node->GetParentPageId());
-  node->MoveHalfTo(newNode);
-  return newNode;
+  page_id_t page_id;
+  auto page = buffer_pool_manager_->NewPage(page_id);
+  ASSERT(page != nullptr, "Out of memory.");
+  auto new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(page_id, node->GetParentPageId(), node->GetMaxSize());
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    node->MoveHalfTo(new_node);
+  } else {
+    node->MoveHalfTo(new_node, buffer_pool_manager_);
+  }
+  return new_node;
 }
 
 /*
@@ -141,27 +192,30 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  * recursively if necessary.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,Transaction *transaction) {
-    if(old_node->IsRootPage()) {
-      Page * newPage=buffer_pool_manager_->NewPage(root_page_id_);
-      B_PLUS_TREE_INTERNAL_PAGE_TYPE *newRoot=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(newPage->GetData());
-      newRoot->Init(root_page_id_);
-      newRoot->PopulateNewRoot(old_node->GetPageId(),key,new_node->GetPageId())
-      old_node->SetParentPageId(root_page_id_);
-      new_node->SetParentPageId(root_page_id_);
-      UpdateRootPageId();
-      buffer_pool_manager_->UnpinPage(newRoot->GetPageId(),true);
-      return;
-    }
-    page_id_t parentID=old_node->GetParentPageId();
-    B_PLUS_TREE_INTERNAL_PAGE_TYPE *parent=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(buffer_pool_manager_->FetchPage(parentID)->GetData());
-    new_node->SetParentPageId(parentID);
-    parent->InsertNodeAfter(old_node->GetPageId(),key,new_node->GetPageId());
-    if(parent->GetSize()>parent->GetMaxSize()) {
-      B_PLUS_TREE_INTERNAL_PAGE_TYPE *newleaf
-      InsertIntoParent(parent,new_page->KeyAt(0),new_page,transaction);
-    }
-    buffer_pool_manager_->UnpinPage(parentID,true);
+void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(page_id);
+    ASSERT(page != nullptr, "Out of memory.");
+    auto root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(page_id);
+    new_node->SetParentPageId(page_id);
+    root_page_id_ = page_id;
+    UpdateRootPageId();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    return;
+  }
+  page_id_t parent_id = old_node->GetParentPageId();
+  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  if (parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId()) > parent->GetMaxSize()) {
+    auto new_parent = Split(parent);
+    InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+    buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+  }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
 }
 
 /*****************************************************************************
@@ -176,14 +230,21 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
-  if(this->IsEmpty()) return;
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_target=FindLeafPage(key,false);
-  int size_after_delete=leaf_target->RemoveAndDeleteRecord(key,comparator_);
-  if(size_after_delete<leaf_target->GetMinSize()) {
-    CoalesceOrRedistribute(leaf_target,transaction);
-  }
-  buffer_pool_manager_->UnpinPage(leaf_target->GetPageId());
-  return;
+  if (IsEmpty()) {
+    return;
+  }
+  auto leaf = reinterpret_cast<LeafPage *>(FindLeafPage(key)->GetData());
+  page_id_t page_id = leaf->GetPageId();
+  int size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, comparator_) == size) {
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return;
+  }
+  bool deleted = leaf->GetSize() < leaf->GetMinSize() && CoalesceOrRedistribute(leaf, transaction);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  if (deleted) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
 }
 
 /*
@@ -196,49 +257,35 @@ void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
-  if(node->IsRootPage()) {
-    bool if_deleted=AdjustRoot(node);
-    if(if_deleted) {transaction->AddIntoDeletedPageSet(node->GetPageId())}
-    return if_deleted;
-  }
-  N* brotherPage=FindbrotherPage(node,transaction);
-  // BPlusTreePage *parent=buffer_pool_manager_->FetchPage(node->GetParentPageId());
-  BPlusTreePage *parent=reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
-  B_PLUS_TREE_INTERNAL_PAGE_TYPE *parentPage=static_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(parent);
-  int index_in_parent=parentPage->ValueIndex(node->GetPageId());
-  if(node->GetSize()+brotherpage->GetSize()<=node->GetMaxSize()){
-    // ?????????
-    
-    Coalesce(&brotherPage,&node,&parentPage,index_in_parent,transaction);
-    buffer_pool_manager_->UnpinPage(parentPage->GetPageId(),true);
-    return true;
+  if (node->IsRootPage()) {
+    return AdjustRoot(node);
   }
-  Redistribute(brotherpage,node,index_in_parent);
-  buffer_pool_manager_->UnpinPage(parentPage->GetPageId(),false);
-  return false;
-}
-
-N* FindbrotherPage(N *node,Transaction *transaction)
-{
-  // auto * parentPage = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-  auto * parentPage =reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(node->GetParentPageId())->GetData());
-  B_PLUS_TREE_INTERNAL_PAGE_TYPE *parent=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE>(parentPage);
-  int index=parent->ValueIndex(node->GetPageId());
-  int brother_index;
-  if(index==0) brother_index=1;
-  else brother_index=index-1;
-  //??????????????????????????
-  BPlusTreePage *page=buffer_pool_manager->FetchPage(parent->ValueAt(brother_index));
-  BPlusTreePage *treepage=reinterpret_cast< BPlusTreePage *>(page->GetData());
-
-  N* brother=reinterpret_cast<N*>(treepage->GetData());
-  
-  buffer_pool_manager_->UnpinPage(page->GetPageId(),false);
-  buffer_pool_manager_->UnpinPage(parent->GetPageId(),false);
-  return brother;
+  page_id_t parent_id = node->GetParentPageId();
+  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  int index = parent->ValueIndex(node->GetPageId());
+  // the left sibling, or the right one of the first child
+  page_id_t neighbor_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  auto neighbor = reinterpret_cast<N *>(buffer_pool_manager_->FetchPage(neighbor_id)->GetData());
+  if (neighbor->GetSize() + node->GetSize() > node->GetMaxSize()) {
+    Redistribute(neighbor, node, index);
+    buffer_pool_manager_->UnpinPage(neighbor_id, true);
+    buffer_pool_manager_->UnpinPage(parent_id, true);
+    return false;
+  }
+  bool parent_deleted = Coalesce(&neighbor, &node, &parent, index, transaction);
+  buffer_pool_manager_->UnpinPage(neighbor_id, true);
+  buffer_pool_manager_->UnpinPage(parent_id, true);
+  if (parent_deleted) {
+    buffer_pool_manager_->DeletePage(parent_id);
+  }
+  // the right one of the two pages is merged into the left one
+  if (index == 0) {
+    buffer_pool_manager_->DeletePage(neighbor_id);
+    return false;
+  }
+  return true;
 }
 
-
 /*
  * Move all the key & value pairs from one page to its sibling page, and notify
  * buffer pool manager to delete this page. Parent page must be adjusted to
@@ -252,12 +299,22 @@ N* FindbrotherPage(N *node,Transaction *transaction)
  */
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
-bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index, Transaction *transaction) {
-  (*node)->MoveAllTo(*neighbor_node,index,buffer_pool_manager_);
-  transaction->AddIntoDeletedPageSet(node->GetPageId());
+bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
+                              BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
+                              Transaction *transaction) {
+  // always move the right page into the left one, the caller deletes the right page
+  if (index == 0) {
+    std::swap(*neighbor_node, *node);
+    index = 1;
+  }
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    (*node)->MoveAllTo(*neighbor_node);
+  } else {
+    (*node)->MoveAllTo(*neighbor_node, (*parent)->KeyAt(index), buffer_pool_manager_);
+  }
   (*parent)->Remove(index);
-  if((*parent)->GetSize()<=(*parent)->GetMinSize()) {
-    return CoalesceOrRedistribute(*parent,transaction);
+  if ((*parent)->GetSize() < (*parent)->GetMinSize()) {
+    return CoalesceOrRedistribute(*parent, transaction);
   }
   return false;
 }
@@ -274,11 +331,24 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,BPlusTreeInternalPage<
 INDEX_TEMPLATE_ARGUMENTS
 template<typename N>
 void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
-  if(index==0) {
-    neighbor_node->MoveFirstToEndOf(node,buffer_pool_manager_);
-  }else {
-    neighbor_node->MoveLastToFrontOf(node,index,buffer_pool_manager_);
+  page_id_t parent_id = node->GetParentPageId();
+  auto parent = reinterpret_cast<InternalPage *>(buffer_pool_manager_->FetchPage(parent_id)->GetData());
+  if (index == 0) {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveFirstToEndOf(node);
+    } else {
+      neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1), buffer_pool_manager_);
+    }
+    parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+  } else {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveLastToFrontOf(node);
+    } else {
+      neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index), buffer_pool_manager_);
+    }
+    parent->SetKeyAt(index, node->KeyAt(0));
   }
+  buffer_pool_manager_->UnpinPage(parent_id, true);
 }
 
 /*
@@ -293,23 +363,23 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
-  if(old_root_node->IsLeafPage()){
-    root_page_id_=INVALID_PAGE_ID;
+  if (old_root_node->IsLeafPage()) {
+    if (old_root_node->GetSize() > 0) {
+      return false;
+    }
+    root_page_id_ = INVALID_PAGE_ID;
     UpdateRootPageId();
     return true;
   }
-  if(old_root_node->GetSize()==1){
-    B_PLUS_TREE_INTERNAL_PAGE_TYPE *root=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(old_root_node);
-    page_id_t newRoot=root->RemoveAndReturnOnlyChild();
-    root_page_id_=newRoot;
-    UpdateRootPageId();
-    Page *page=buffer_pool_manager_->FetchPage(newRoot);
-    B_PLUS_TREE_INTERNAL_PAGE_TYPE *newRootPage=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE*>(page->GetData());
-    newRootPage->SetParentPageId(INVALID_PAGE_ID);
-    buffer_pool_manager_->UnpinPage(newRoot,true);
-    return true;
+  if (old_root_node->GetSize() > 1) {
+    return false;
   }
-  return false;
+  root_page_id_ = reinterpret_cast<InternalPage *>(old_root_node)->RemoveAndReturnOnlyChild();
+  auto root = reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
+  root->SetParentPageId(INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  UpdateRootPageId();
+  return true;
 }
 
 /*****************************************************************************
@@ -322,9 +392,10 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
-  KeyType nouse;
-  auto start=FindLeafPage(nouse,true);
-  return INDEXITERATOR_TYPE(start,0,buffer_pool_manager_);
+  if (IsEmpty()) {
+    return End();
+  }
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, FindLeafPage(KeyType{}, true), 0);
 }
 
 /*
@@ -334,12 +405,12 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
-  auto start=FindLeafPage(key);
-  if(start==nullptr) {
-    return INDEXITERATOR_TYPE(start,0,buffer_pool_manager_);
+  auto page = FindLeafPage(key);
+  if (page == nullptr) {
+    return End();
   }
-  int index=start->KeyIndex(key,comparator_);
-  return INDEXITERATOR_TYPE(start,index,buffer_pool_manager_);
+  int index = reinterpret_cast<LeafPage *>(page->GetData())->KeyIndex(key, comparator_);
+  return INDEXITERATOR_TYPE(buffer_pool_manager_, page, index);
 }
 
 /*
@@ -349,15 +420,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
-  KeyType key{};
-  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf= reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>( FindLeafPage(key, true));
-  page_id_t new_page;
-  while(leaf->GetNextPageId()!=INVALID_PAGE_ID){
-    new_page=leaf->GetNextPageId();
-    leaf=reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE*>(buffer_pool_manager_->FetchPage(new_page));
-  }
-  buffer_pool_manager_->UnpinPage(new_page,false);
-  return INDEXITERATOR_TYPE(leaf, leaf->GetSize(), buffer_pool_manager_);
+  return INDEXITERATOR_TYPE();
 }
 
 /*****************************************************************************
@@ -370,22 +433,19 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() {
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  if(IsEmpty()) return nullptr;
-  // auto pointer=buffer_pool_manager_->FetchPage(root_page_id_);
-  BPlusTreePage* pointer=reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(root_page_id_)->GetData());
-  page_id_t next;
-  for(page_id_t i=root_page_id_;!p->IsLeafPage();i=next,pointer=reinterpret_cast<BPlusTreePage *>(buffer_pool_manager_->FetchPage(i)->GetData());)
-  {
-    B_PLUS_TREE_INTERNAL_PAGE_TYPE *internalPage=static_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(pointer);
-    if(leftMost){
-      next=internalPage->ValueAt(0);
-    }
-    else {
-      next=internalPage->Lookup(key,comparator_);
-    }
-    buffer_pool_manager_->UnpinPage(i,false);
+  if (IsEmpty()) {
+    return nullptr;
+  }
+  auto page = buffer_pool_manager_->FetchPage(root_page_id_);
+  auto node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  while (!node->IsLeafPage()) {
+    auto internal = reinterpret_cast<InternalPage *>(node);
+    page_id_t child_id = leftMost ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+    buffer_pool_manager_->UnpinPage(internal->GetPageId(), false);
+    page = buffer_pool_manager_->FetchPage(child_id);
+    node = reinterpret_cast<BPlusTreePage *>(page->GetData());
   }
-  return nullptr;
+  return page;
 }
 
 /*
@@ -398,7 +458,18 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
-  IndexRootsPage 
+  auto roots_page = reinterpret_cast<IndexRootsPage *>(buffer_pool_manager_->FetchPage(INDEX_ROOTS_PAGE_ID)->GetData());
+  bool saved;
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    // an empty tree keeps no record, the next root is inserted again
+    saved = roots_page->Delete(index_id_);
+  } else if (insert_record) {
+    saved = roots_page->Insert(index_id_, root_page_id_, buffer_pool_manager_->GetPageSize());
+  } else {
+    saved = roots_page->Update(index_id_, root_page_id_);
+  }
+  buffer_pool_manager_->UnpinPage(INDEX_ROOTS_PAGE_ID, saved);
+  ASSERT(saved, "Failed to save the root page id.");
 }
 
 /**
@@ -407,7 +478,7 @@ void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::ToGraph(BPlusTreePage *page, BufferPoolManager *bpm, std::ofstream &out) const {
   std::string leaf_prefix("LEAF_");
-  std::string internas("INT_");
+  std::string internal_prefix("INT_");
   if (page->IsLeafPage()) {
     auto *leaf = reinterpret_cast<LeafPage *>(page);
     // Print node name
@@ -547,3 +618,10 @@ class BPlusTree<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
 class BPlusTree<GenericKey<64>, RowId, GenericComparator<64>>;
+
+// trees of clustered tables, see storage/clustered_table.h
+template
+class BPlusTree<GenericKey<32>, GenericKey<32>, GenericComparator<32>>;
+
+template
+class BPlusTree<GenericKey<32>, GenericKey<128>, GenericComparator<32>>;
@@ -6,7 +6,9 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(index_id_t index_id, IndexSchema *key_schem
                                      BufferPoolManager *buffer_pool_manager)
         : Index(index_id, key_schema),
           comparator_(key_schema_),
-          container_(index_id, buffer_pool_manager, comparator_) {
+          container_(index_id, buffer_pool_manager, comparator_,
+                     LEAF_PAGE_SIZE_OF(buffer_pool_manager->GetPageSize()),
+                     INTERNAL_PAGE_SIZE_OF(buffer_pool_manager->GetPageSize())) {
 
 }
 
@@ -2,30 +2,80 @@
 #include "index/generic_key.h"
 #include "index/index_iterator.h"
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator() {
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator() = default;
 
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(BufferPoolManager *buffer_pool_manager, Page *page,
+                                                           int index)
+        : buffer_pool_manager_(buffer_pool_manager), index_(index) {
+  if (page != nullptr) {
+    leaf_ = reinterpret_cast<LeafPage *>(page->GetData());
+    SkipPage();
+  }
 }
 
-INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::IndexIterator(const IndexIterator &other)
+        : buffer_pool_manager_(other.buffer_pool_manager_), leaf_(other.leaf_), index_(other.index_) {
+  if (leaf_ != nullptr) {
+    buffer_pool_manager_->FetchPage(leaf_->GetPageId());
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(const IndexIterator &other) {
+  if (this != &other) {
+    if (other.leaf_ != nullptr) {
+      other.buffer_pool_manager_->FetchPage(other.leaf_->GetPageId());
+    }
+    if (leaf_ != nullptr) {
+      buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+    }
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    leaf_ = other.leaf_;
+    index_ = other.index_;
+  }
+  return *this;
+}
 
+INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE::~IndexIterator() {
+  if (leaf_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS const MappingType &INDEXITERATOR_TYPE::operator*() {
-  ASSERT(false, "Not implemented yet.");
+  ASSERT(leaf_ != nullptr, "Access the end iterator.");
+  return leaf_->GetItem(index_);
 }
 
 INDEX_TEMPLATE_ARGUMENTS INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
-  ASSERT(false, "Not implemented yet.");
+  ASSERT(leaf_ != nullptr, "Increase the end iterator.");
+  index_++;
+  SkipPage();
+  return *this;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator==(const IndexIterator &itr) const {
-  return false;
+  return GetPageId() == itr.GetPageId() && index_ == itr.index_;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 bool INDEXITERATOR_TYPE::operator!=(const IndexIterator &itr) const {
-  return false;
+  return !(*this == itr);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipPage() {
+  while (leaf_ != nullptr && index_ >= leaf_->GetSize()) {
+    page_id_t next_page_id = leaf_->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
+    leaf_ = nullptr;
+    index_ = 0;
+    if (next_page_id != INVALID_PAGE_ID) {
+      auto page = buffer_pool_manager_->FetchPage(next_page_id);
+      ASSERT(page != nullptr, "Failed to fetch leaf page.");
+      leaf_ = reinterpret_cast<LeafPage *>(page->GetData());
+    }
+  }
 }
 
 template
@@ -45,3 +95,10 @@ class IndexIterator<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
 class IndexIterator<GenericKey<64>, RowId, GenericComparator<64>>;
+
+// trees of clustered tables, see storage/clustered_table.h
+template
+class IndexIterator<GenericKey<32>, GenericKey<32>, GenericComparator<32>>;
+
+template
+class IndexIterator<GenericKey<32>, GenericKey<128>, GenericComparator<32>>;
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
 #include "page/b_plus_tree_internal_page.h"
@@ -12,28 +14,25 @@
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
-    SetPageType(IndexPageType::INTERNAL_PAGE);
-    SetSize(0);
-    SetPageId(page_id);
-    SetParentPageId(parent_id);
-    SetMaxSize((PAGE_SIZE-sizeof(BPlusTreeInternalPage))/sizeof(MappingType)-1);
-
-    this->array_=new MappingType[max_size];
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetSize(0);
+  SetPageId(page_id);
+  SetParentPageId(parent_id);
+  SetMaxSize(max_size);
 }
+
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code
-  KeyType key=this->array_[index].first;
-  return key;
+  return array_[index].first;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
-  this->array_[index].first=key;
+  array_[index].first = key;
 }
 
 /*
@@ -42,20 +41,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
-  int size=GetSize();
-  for(int i=1;i<size;i++){
-    if(this->array_[i].second==value) {
-      return i;
-    }
-  }
-  return -1;
-}
-
-INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key) const {
-  int size=GetSize();
-  for(int i=0;i<size;i++){
-    if(this->array_[i].first==key) {
+  for (int i = 0; i < GetSize(); i++) {
+    if (array_[i].second == value) {
       return i;
     }
   }
@@ -68,8 +55,7 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyIndex(const KeyType &key) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
-  ValueType val=this->array_[index].second;
-  return val;
+  return array_[index].second;
 }
 
 /*****************************************************************************
@@ -82,32 +68,18 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  assert(GetSize()>1);
-  if(comparator(key,array_[1].first)<0){
-    return array_[0].second;
-  }
-  if(comparator(key,array_[GetSize()-1].first)>=0){
-    return array_[GetSize()-1].second;
-  }
-  int left=1,right=GetSize()-1;
-  int targetIndex=-1;
-  while(left<=right){
-    int mid=left+(right-left)/2;
-    int compareResult=comparator(array_[mid].first,key);
-    if(compareResult==0){
-      targetIndex=mid;
-      break;
+  // the last child whose key is not greater than the key
+  int left = 1;
+  int right = GetSize();
+  while (left < right) {
+    int mid = (left + right) / 2;
+    if (comparator(array_[mid].first, key) <= 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
     }
-    if(compareResult<0){
-      left=mid+1;
-    }else{
-      right=mid+1;
-    }
-  }
-  if(targetIndex!=-1){
-    return array_[targetIndex].second;
   }
-  return array_[left-1].second;
+  return array_[left - 1].second;
 }
 
 /*****************************************************************************
@@ -120,11 +92,11 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCo
  * NOTE: This method is only called within InsertIntoParent()(b_plus_tree.cpp)
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,const ValueType &new_value) {
-          array_[0].second=old_value;
-          array_[1].first=new_key;
-          array_[1].second=new_value;
-          SetSize(2);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                                                     const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1] = MappingType(new_key, new_value);
+  SetSize(2);
 }
 
 /*
@@ -133,14 +105,11 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value,
  * @return:  new size after insertion
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,const ValueType &new_value) {
-  int index=ValueIndex(old_value);
-  assert(index!=-1);
-  for(int i=GetSize()-1;i>index;i--){
-    array_[i+1]=array_[i];
-  }
-  array_[index+1].first=new_key;
-  array_[index+1].second=new_value;
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
+                                                    const ValueType &new_value) {
+  int index = ValueIndex(old_value) + 1;
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = MappingType(new_key, new_value);
   IncreaseSize(1);
   return GetSize();
 }
@@ -152,14 +121,12 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value,
  * Remove half of key & value pairs from this page to "recipient" page
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,BufferPoolManager *buffer_pool_manager) {
-    int size=GetSize();
-    int half_size=size/2;
-    MappingType *st=array_+size-half_size;
-    recipient->CopyFirstFrom(st,half_size);
-    this->IncreaseSize(-1*half_size);
-    recipient->IncreaseSize(half_size);
-    return;
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
+                                                BufferPoolManager *buffer_pool_manager) {
+  // the first key moved is the key of the recipient in the parent
+  int moved = GetSize() / 2;
+  recipient->CopyNFrom(array_ + GetSize() - moved, moved, buffer_pool_manager);
+  IncreaseSize(-moved);
 }
 
 /* Copy entries into me, starting from {items} and copy {size} entries.
@@ -168,12 +135,11 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
-    for(int i=0;i<size;i++){
-      this->array_[i]=item[i];
-      auto new_page=reinterpret_cast<BPlusTreePage *>(buffer_pool_manager->FetchPage(this->array_[i].second)->GetData());
-      new_page->SetParentPageId(this->GetPageId());
-      buffer_pool_manager->UnpinPage(this->array_[i].second,true);
-    }
+  std::copy(items, items + size, array_ + GetSize());
+  for (int i = GetSize(); i < GetSize() + size; i++) {
+    Adopt(array_[i].second, buffer_pool_manager);
+  }
+  IncreaseSize(size);
 }
 
 /*****************************************************************************
@@ -186,9 +152,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, Buf
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
-    memmove(array_+index,array_+index+1,(GetSize()-index-1)*sizeof(MappingType)));
-    IncreaseSize(-1);
-    return;
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
+  IncreaseSize(-1);
 }
 
 /*
@@ -197,10 +162,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
-  ValueType val=this->ValueAt(0);
-  IncreaseSize(-1);
-  assert(GetSize()!=0)
-  return val;
+  SetSize(0);
+  return array_[0].second;
 }
 
 /*****************************************************************************
@@ -214,18 +177,11 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
  * pages that are moved to the recipient
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,BufferPoolManager *buffer_pool_manager) {
-    int re_size=recipient->GetSize();
-    page_id_t re_page_id=recipient->page_id_;
-    Page *page=buffer_pool_manager->FetchPage(this->GetParentPageId());
-    BPlusTreeInternalPage *father=reinterpret_cast<BPlusTreeInternalPage *>(page->GetData());
-    int index=father->ValueIndex(this->GetPageId);
-    KeyType tmp=father->KeyAt(index);
-    this->SetKeyAt(0,tmp);
-    father->Remove(index);
-    buffer_pool_manager->UnpinPage(father->GetPageId(),true);
-    recipient->CopyNFrom(array_,GetSize(),buffer_pool_manager);
-    SetSize(0);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                               BufferPoolManager *buffer_pool_manager) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyNFrom(array_, GetSize(), buffer_pool_manager);
+  SetSize(0);
 }
 
 /*****************************************************************************
@@ -240,18 +196,12 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient,
  * pages that are moved to the recipient
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,BufferPoolManager *buffer_pool_manager) {
-  auto *fatherData=buffer_pool_manager->FetchPage(GetParentPageId)->GetData();
-  B_PLUS_TREE_INTERNAL_PAGE_TYPE *fatherpage=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE*>(fatherData)
-  int index=fatherpage->ValueIndex(GetPageId());
-  KeyType tmp=fatherpage->KeyAt(index);
-  buffer_pool_manager->UnpinPage(GetParentPageId(),true);
-  MappingType new_pair={tmp,ValueAt(0)};
-  (this->array_[0]).second=this->ValueAt(1);
-  this->Remove(1);
-  recipient->CopyLastFrom(new_pair,buffer_pool_manager);
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                      BufferPoolManager *buffer_pool_manager) {
+  recipient->CopyLastFrom(MappingType(middle_key, array_[0].second), buffer_pool_manager);
+  // the key left first is the new separation key in the parent
+  std::move(array_ + 1, array_ + GetSize(), array_);
   IncreaseSize(-1);
-  return;
 }
 
 /* Append an entry at the end.
@@ -260,11 +210,8 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *rec
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-  auto *childData=buffer_pool_manager->FetchPage(pair.second)->GetData();
-  B_PLUS_TREE_INTERNAL_PAGE_TYPE *childPage=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(childData);
-  childPage->SetPageId(GetPageId());
-  buffer_pool_manager->UnpinPage(pair.second,true);
-  array[GetSize()]=pair;
+  array_[GetSize()] = pair;
+  Adopt(pair.second, buffer_pool_manager);
   IncreaseSize(1);
 }
 
@@ -276,10 +223,12 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, Buffe
  * moved to the recipient
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,BufferPoolManager *buffer_pool_manager) {
-  MappingType movepair=array_[GetSize()-1];
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                                                       BufferPoolManager *buffer_pool_manager) {
+  // the key of the moved entry is the new separation key in the parent
+  recipient->SetKeyAt(0, middle_key);
+  recipient->CopyFirstFrom(array_[GetSize() - 1], buffer_pool_manager);
   IncreaseSize(-1);
-  recipient->CopyFirstFrom(movepair,buffer_pool_manager);
 }
 
 /* Append an entry at the beginning.
@@ -288,20 +237,18 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *re
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
-    auto *fatherdata=buffer_pool_manager->FetchPage(GetParentPageId())->GetData();
-    B_PLUS_TREE_INTERNAL_PAGE_TYPE * fatherpage=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(fatherdata);
-    int index=fatherpage->ValueIndex(GetPageId);
-    SetKeyAt(0,fatherpage->KeyAt(index));
-    fatherpage->SetKeyAt(0,pair.first);
-    buffer_pool_manager->UnpinPage(fatherpage->GetPageId(),true);
-    for(int i=GetSize()-1;i>=0;i--){
-      array_[i+1]=array_[i];
-    }
-    array_[0].second=pair.second;
-    auto * childdata=buffer_pool_manager->FetchPage(pair.second)->GetData();
-    B_PLUS_TREE_INTERNAL_PAGE_TYPE *childpage=reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(childdata);
-    childpage->SetParentPageId(GetPageId());
-    buffer_pool_manager->UnpinPage(childpage->GetPageId(),true);
+  std::move_backward(array_, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[0] = pair;
+  Adopt(pair.second, buffer_pool_manager);
+  IncreaseSize(1);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager) {
+  auto page = buffer_pool_manager->FetchPage(child_page_id);
+  ASSERT(page != nullptr, "Failed to fetch child page.");
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(child_page_id, true);
 }
 
 template
@@ -320,4 +267,4 @@ template
 class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 
 template
-class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
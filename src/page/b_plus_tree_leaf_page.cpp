@@ -1,8 +1,8 @@
 #include <algorithm>
+
 #include "index/basic_comparator.h"
 #include "index/generic_key.h"
 #include "page/b_plus_tree_leaf_page.h"
-#include "include/page/b_plus_tree_internal_page.h"
 
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
@@ -16,17 +16,13 @@
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
   SetPageType(IndexPageType::LEAF_PAGE);
-  SetNextPageId(INVALID_PAGE_ID);
   SetSize(0);
-  SetMaxSize((PAGE_SIZE-sizeof(BPlusTreeLeafPage))/sizeof(MappingType)-1);
+  SetMaxSize(max_size);
   SetPageId(page_id);
   SetParentPageId(parent_id);
-  this->array_=new MappingType[max_size_+1];
-  return;
+  SetNextPageId(INVALID_PAGE_ID);
 }
 
-
-
 /**
  * Helper methods to set/get next page id
  */
@@ -37,7 +33,7 @@ page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const {
 
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
-  next_page_id_=next_page_id;
+  next_page_id_ = next_page_id;
 }
 
 /**
@@ -46,13 +42,17 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
-  int l=0,r=GetSize()-1;
-  while(l<=r){
-    int mid=(l+r)/2;
-    if(comparator(array_[mid].first,key)>=0) r=mid-1;
-    else l=mid+1;
+  int left = 0;
+  int right = GetSize();
+  while (left < right) {
+    int mid = (left + right) / 2;
+    if (comparator(array_[mid].first, key) < 0) {
+      left = mid + 1;
+    } else {
+      right = mid;
+    }
   }
-  return r+1;
+  return left;
 }
 
 /*
@@ -70,7 +70,6 @@ KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
  */
 INDEX_TEMPLATE_ARGUMENTS
 const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
-  // replace with your own code
   return array_[index];
 }
 
@@ -83,15 +82,11 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
-  int index=keyindex(key,comparator);
+  int index = KeyIndex(key, comparator);
+  std::move_backward(array_ + index, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[index] = MappingType(key, value);
   IncreaseSize(1);
-  int now_size=GetSize();
-  for(int i=now_size-1;i>index;i--){
-    array_[i]=array_[i-1];
-  }
-  array_[index].first=key;
-  array_[index].second=value;
-  return now_size;
+  return GetSize();
 }
 
 /*****************************************************************************
@@ -102,27 +97,18 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &valu
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
-  int now_size=GetMaxSize()+1;
-  int break_index=now_size/2;
-  for(int i=break_index;i<now_size;i++){
-    recipient->array_[i-break_index]=array_[i];
-  }
-  recipient->SetNextPageId(GetNextPageId());
-  SetNextPageId(recipient->GetPageId());
-  SetSize(break_index);
-  recipient->SetSize(now_size-break_index);
+  int moved = GetSize() / 2;
+  recipient->CopyNFrom(array_ + GetSize() - moved, moved);
+  IncreaseSize(-moved);
 }
 
-
-
 /*
  * Copy starting from items, and copy {size} number of elements into me.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
-  for(int i=0;i<size;i++){
-    this->array_[i]=items[i];
-  }
+  std::copy(items, items + size, array_ + GetSize());
+  IncreaseSize(size);
 }
 
 /*****************************************************************************
@@ -135,12 +121,26 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, const KeyComparator &comparator) const {
-  int index=KeyIndex(key,comparator);
-  if(index<GetSize()&&comparator(array_[index].first,key)==0){
-    value=array_[index].second;
-    return true;
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return false;
   }
-  return false;
+  value = array_[index].second;
+  return true;
+}
+
+/*
+ * For the given key, replace its value in place if it exists in the leaf page.
+ * If the key does not exist, then return false
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::Update(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
+    return false;
+  }
+  array_[index].second = value;
+  return true;
 }
 
 /*****************************************************************************
@@ -154,12 +154,11 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value, co
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
-  int dayudengyu_index=KeyIndex(key,comparator);
-  if(dayudengyu_index>=GetSize()||comparator(key,KeyAt(dayudengyu_index))!=0){
+  int index = KeyIndex(key, comparator);
+  if (index == GetSize() || comparator(array_[index].first, key) != 0) {
     return GetSize();
   }
-  memmove(array_+dayudengyu_index,array_+dayudengyu_index+1,
-          static_cast<size_t>((GetSize()-dayudengyu_index-1)*sizeof(MappingType)));
+  std::move(array_ + index + 1, array_ + GetSize(), array_ + index);
   IncreaseSize(-1);
   return GetSize();
 }
@@ -173,13 +172,8 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
-  int startIdx = recipient->GetSize();
-  for (int i = 0; i < GetSize(); i++) {
-    recipient->array_[startIdx + i].first = array_[i].first;
-    recipient->array_[startIdx + i].second = array_[i].second;
-  }
+  recipient->CopyNFrom(array_, GetSize());
   recipient->SetNextPageId(GetNextPageId());
-  recipient->IncreaseSize(GetSize());
   SetSize(0);
 }
 
@@ -188,19 +182,12 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
  *****************************************************************************/
 /*
  * Remove the first key & value pair from this page to "recipient" page.
- *
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
-  MappingType pair = GetItem(0);
+  recipient->CopyLastFrom(array_[0]);
+  std::move(array_ + 1, array_ + GetSize(), array_);
   IncreaseSize(-1);
-  memmove(array_, array_ + 1, static_cast<size_t>(GetSize()*sizeof(MappingType)));
-  recipient->CopyLastFrom(pair);
-  //update relavent key & value pair in its parent page.
-  Page *page = buffer_pool_manager->FetchPage(GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(page->GetData());
-  parent->SetKeyAt(parent->ValueIndex(GetPageId()), array_[0].first);
-  buffer_pool_manager->UnpinPage(GetParentPageId(), true);
 }
 
 /*
@@ -216,26 +203,19 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
  * Remove the last key & value pair from this page to "recipient" page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) { {
-  MappingType pair = GetItem(GetSize() - 1);
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  recipient->CopyFirstFrom(array_[GetSize() - 1]);
   IncreaseSize(-1);
-  recipient->CopyFirstFrom(pair, parentIndex, buffer_pool_manager);
 }
 
 /*
  * Insert item at the front of my items. Move items accordingly.
- *
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
-  memmove(array + 1, array, GetSize()*sizeof(MappingType));
+  std::move_backward(array_, array_ + GetSize(), array_ + GetSize() + 1);
+  array_[0] = item;
   IncreaseSize(1);
-  array[0] = item;
-
-  Page *page = buffer_pool_manager->FetchPage(GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE_TYPE *parent = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE_TYPE *>(page->GetData());
-  parent->SetKeyAt(parent->KeyIndex(array_[1].first), array_[0].first);
-  buffer_pool_manager->UnpinPage(GetParentPageId(), true);
 }
 
 template
@@ -254,4 +234,11 @@ template
 class BPlusTreeLeafPage<GenericKey<32>, RowId, GenericComparator<32>>;
 
 template
-class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
\ No newline at end of file
+class BPlusTreeLeafPage<GenericKey<64>, RowId, GenericComparator<64>>;
+
+// trees of clustered tables, see storage/clustered_table.h
+template
+class BPlusTreeLeafPage<GenericKey<32>, GenericKey<32>, GenericComparator<32>>;
+
+template
+class BPlusTreeLeafPage<GenericKey<32>, GenericKey<128>, GenericComparator<32>>;
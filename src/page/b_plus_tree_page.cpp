@@ -5,17 +5,15 @@
  * Page type enum class is defined in b_plus_tree_page.h
  */
 bool BPlusTreePage::IsLeafPage() const {
-
-  return (page_type_==IndexPageType::LEAF_PAGE);
+  return page_type_ == IndexPageType::LEAF_PAGE;
 }
 
 bool BPlusTreePage::IsRootPage() const {
-  return (this->parent_page_id_)==-1;
+  return parent_page_id_ == INVALID_PAGE_ID;
 }
 
-
 void BPlusTreePage::SetPageType(IndexPageType page_type) {
-    this->page_type_=page_type;
+  page_type_ = page_type;
 }
 
 /*
@@ -23,26 +21,26 @@ void BPlusTreePage::SetPageType(IndexPageType page_type) {
  * page)
  */
 int BPlusTreePage::GetSize() const {
-  return this->size_;
+  return size_;
 }
 
 void BPlusTreePage::SetSize(int size) {
-  this->size_=size;
+  size_ = size;
 }
 
 void BPlusTreePage::IncreaseSize(int amount) {
-  this->size_+=amount;
+  size_ += amount;
 }
 
 /*
  * Helper methods to get/set max size (capacity) of the page
  */
 int BPlusTreePage::GetMaxSize() const {
-  return this->max_size_;
+  return max_size_;
 }
 
 void BPlusTreePage::SetMaxSize(int size) {
-  this->max_size_=size;
+  max_size_ = size;
 }
 
 /*
@@ -50,38 +48,39 @@ void BPlusTreePage::SetMaxSize(int size) {
  * Generally, min page size == max page size / 2
  */
 int BPlusTreePage::GetMinSize() const {
-  if(IsRootPage()) {
-     if(IsLeafPage()) return 1;
-     else return 2;
+  // a root leaf may hold a single pair, a root internal page needs two children
+  if (IsRootPage()) {
+    return IsLeafPage() ? 1 : 2;
   }
-  return max_size_/2;
+  // round up for internal pages so that every child has a sibling
+  return IsLeafPage() ? max_size_ / 2 : (max_size_ + 1) / 2;
 }
 
 /*
  * Helper methods to get/set parent page id
  */
 page_id_t BPlusTreePage::GetParentPageId() const {
-  return this->parent_page_id_;
+  return parent_page_id_;
 }
 
 void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) {
-    this->parent_page_id_=parent_page_id;
+  parent_page_id_ = parent_page_id;
 }
 
 /*
  * Helper methods to get/set self page id
  */
 page_id_t BPlusTreePage::GetPageId() const {
-  return this->page_id_;
+  return page_id_;
 }
 
 void BPlusTreePage::SetPageId(page_id_t page_id) {
-  this->page_id_=page_id;
+  page_id_ = page_id;
 }
 
 /*
  * Helper methods to set lsn
  */
 void BPlusTreePage::SetLSN(lsn_t lsn) {
-  this->lsn_ = lsn;
+  lsn_ = lsn;
 }
\ No newline at end of file
@@ -2,22 +2,58 @@
 
 template<size_t PageSize>
 bool BitmapPage<PageSize>::AllocatePage(uint32_t &page_offset) {
-  return false;
+  if (page_allocated_ >= GetMaxSupportedSize()) {
+    return false;
+  }
+  // next_free_page_ always points to a free page while the extent is not full
+  page_offset = next_free_page_;
+  bytes[page_offset / 8] |= static_cast<unsigned char>(1 << (page_offset % 8));
+  page_allocated_++;
+  if (page_allocated_ < GetMaxSupportedSize()) {
+    next_free_page_ = FindNextFreePage(page_offset);
+  }
+  return true;
 }
 
 template<size_t PageSize>
 bool BitmapPage<PageSize>::DeAllocatePage(uint32_t page_offset) {
-  return false;
+  if (page_offset >= GetMaxSupportedSize() || IsPageFree(page_offset)) {
+    return false;
+  }
+  bytes[page_offset / 8] &= static_cast<unsigned char>(~(1 << (page_offset % 8)));
+  page_allocated_--;
+  next_free_page_ = page_offset;
+  return true;
 }
 
 template<size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFree(uint32_t page_offset) const {
-  return false;
+  if (page_offset >= GetMaxSupportedSize()) {
+    return false;
+  }
+  return IsPageFreeLow(page_offset / 8, page_offset % 8);
 }
 
 template<size_t PageSize>
 bool BitmapPage<PageSize>::IsPageFreeLow(uint32_t byte_index, uint8_t bit_index) const {
-  return false;
+  return (bytes[byte_index] & (1 << bit_index)) == 0;
+}
+
+template<size_t PageSize>
+uint32_t BitmapPage<PageSize>::FindNextFreePage(uint32_t page_offset) const {
+  // scan byte by byte from the given offset and wrap around, full bytes are skipped at once
+  uint32_t byte_index = page_offset / 8;
+  for (size_t i = 0; i <= MAX_CHARS; i++, byte_index = (byte_index + 1) % MAX_CHARS) {
+    if (bytes[byte_index] == 0xFF) {
+      continue;
+    }
+    for (uint8_t bit_index = 0; bit_index < 8; bit_index++) {
+      if (IsPageFreeLow(byte_index, bit_index)) {
+        return byte_index * 8 + bit_index;
+      }
+    }
+  }
+  return GetMaxSupportedSize();
 }
 
 template
@@ -39,4 +75,13 @@ template
 class BitmapPage<2048>;
 
 template
-class BitmapPage<4096>;
\ No newline at end of file
+class BitmapPage<4096>;
+
+template
+class BitmapPage<8192>;
+
+template
+class BitmapPage<16384>;
+
+template
+class BitmapPage<32768>;
\ No newline at end of file
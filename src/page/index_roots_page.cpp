@@ -1,9 +1,9 @@
 #include "page/index_roots_page.h"
 
-bool IndexRootsPage::Insert(const index_id_t index_id, const page_id_t root_id) {
+bool IndexRootsPage::Insert(const index_id_t index_id, const page_id_t root_id, uint32_t page_size) {
   auto index = FindIndex(index_id);
   // check for duplicate index id
-  if (index != -1) {
+  if (index != -1 || count_ >= GetMaxIndexCount(page_size)) {
     return false;
   }
   roots_[count_].first = index_id;
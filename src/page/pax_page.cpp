@@ -0,0 +1,307 @@
+#include <algorithm>
+#include <memory>
+
+#include "page/pax_page.h"
+#include "record/row_view.h"
+#include "storage/scan_predicate.h"
+
+uint32_t PaxPage::GetCapacity(uint32_t page_size, Schema *schema, uint32_t char_size) {
+  uint32_t column_count = schema->GetColumnCount();
+  // header and the padding of the used, deleted and null bitmaps
+  uint32_t reserved = OFFSET_MINIPAGE_OFFSETS + sizeof(uint32_t) * column_count + 4 * (column_count + 2);
+  // bits taken by each tuple
+  uint64_t tuple_bits = 2 + column_count + 8 * char_size;
+  for (auto column : schema->GetColumns()) {
+    TypeId type = column->GetType();
+    tuple_bits += 8 * (type == TypeId::kTypeChar ? sizeof(uint32_t) : Type::GetTypeSize(type));
+  }
+  if (reserved + (tuple_bits + 7) / 8 > page_size) {
+    return 0;
+  }
+  return static_cast<uint32_t>(8 * (page_size - reserved) / tuple_bits);
+}
+
+void PaxPage::Init(page_id_t page_id, page_id_t prev_id, Schema *schema, uint32_t capacity, LogManager *log_mgr,
+                   Transaction *txn) {
+  ASSERT(capacity > 0, "Can not have empty page.");
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetPrevPageId(prev_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  SetCharDataPointer(GetPageSize());
+  SetTupleCount(0);
+  SetFreeSpaceMapPageId(INVALID_PAGE_ID);
+  uint32_t column_count = schema->GetColumnCount();
+  memcpy(GetData() + OFFSET_CAPACITY, &capacity, sizeof(uint32_t));
+  memcpy(GetData() + OFFSET_COLUMN_COUNT, &column_count, sizeof(uint32_t));
+  uint32_t bitmap_size = GetBitmapSize(capacity);
+  memset(GetUsedBitmap(), 0, 2 * bitmap_size);
+  uint32_t offset = OFFSET_MINIPAGE_OFFSETS + sizeof(uint32_t) * column_count + 2 * bitmap_size;
+  for (uint32_t i = 0; i < column_count; i++) {
+    memcpy(GetData() + OFFSET_MINIPAGE_OFFSETS + sizeof(uint32_t) * i, &offset, sizeof(uint32_t));
+    TypeId type = schema->GetColumn(i)->GetType();
+    offset += bitmap_size + capacity * (type == TypeId::kTypeChar ? sizeof(uint32_t) : Type::GetTypeSize(type));
+  }
+  ASSERT(offset <= GetPageSize(), "Page capacity is too large.");
+  memcpy(GetData() + OFFSET_FIXED_AREA_END, &offset, sizeof(uint32_t));
+}
+
+bool PaxPage::InsertTuple(Row &row, Schema *schema, Transaction *txn, LockManager *lock_manager,
+                          LogManager *log_manager) {
+  ASSERT(row.GetFieldCount() == GetColumnCount(), "Fields size do not match schema's column size.");
+  uint32_t slot = FindFreeSlot();
+  if (slot == INVALID_SLOT) {
+    return false;
+  }
+  uint32_t char_size = GetCharSize(row, schema);
+  if (GetFreeCharSpace() < char_size && CompactCharData(schema) < char_size) {
+    return false;
+  }
+  WriteTuple(slot, row, schema);
+  row.SetRowId(RowId(GetTablePageId(), slot));
+  return true;
+}
+
+size_t PaxPage::InsertTuples(std::vector<Row> &rows, size_t begin, size_t end, Schema *schema, Transaction *txn,
+                             LockManager *lock_manager, LogManager *log_manager) {
+  size_t i = begin;
+  while (i < end && InsertTuple(rows[i], schema, txn, lock_manager, log_manager)) {
+    i++;
+  }
+  return i - begin;
+}
+
+bool PaxPage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsLive(slot_num)) {
+    return false;
+  }
+  SetBit(GetDeletedBitmap(), slot_num, true);
+  return true;
+}
+
+bool PaxPage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
+                          Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  ASSERT(old_row != nullptr && old_row->GetRowId().Get() != INVALID_ROWID.Get(), "invalid old row.");
+  uint32_t slot_num = old_row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsLive(slot_num)) {
+    return false;
+  }
+  // the old char values are garbage once the new ones are written, so they count as free space
+  uint32_t char_size = GetCharSize(new_row, schema);
+  if (GetFreeCharSpace() < char_size && GetFreeCharSpace() + GetCharSize(slot_num, schema) < char_size) {
+    return false;
+  }
+  RowView(this, old_row->GetRowId(), schema).Materialize(old_row);
+  SetBit(GetUsedBitmap(), slot_num, false);
+  if (GetFreeCharSpace() < char_size) {
+    CompactCharData(schema);
+  }
+  WriteTuple(slot_num, new_row, schema);
+  return true;
+}
+
+void PaxPage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount(), "Cannot have more slots than tuples.");
+  // char values are left as garbage until compaction
+  SetBit(GetUsedBitmap(), slot_num, false);
+  SetBit(GetDeletedBitmap(), slot_num, false);
+  uint32_t tuple_count = GetTupleCount();
+  while (tuple_count > 0 && !GetBit(GetUsedBitmap(), tuple_count - 1)) {
+    tuple_count--;
+  }
+  SetTupleCount(tuple_count);
+}
+
+void PaxPage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount(), "We can't have more slots than tuples.");
+  SetBit(GetDeletedBitmap(), slot_num, false);
+}
+
+bool PaxPage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager *lock_manager) {
+  ASSERT(row != nullptr && row->GetRowId().Get() != INVALID_ROWID.Get(), "Invalid row.");
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsLive(slot_num)) {
+    return false;
+  }
+  RowView(this, row->GetRowId(), schema).Materialize(row);
+  return true;
+}
+
+bool PaxPage::GetStoredTuple(Row *row, Schema *schema) {
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount() || !GetBit(GetUsedBitmap(), slot_num)) {
+    return false;
+  }
+  RowView(this, row->GetRowId(), schema).Materialize(row);
+  return true;
+}
+
+bool PaxPage::GetTupleView(const RowId &rid, RowView &view) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsLive(slot_num)) {
+    return false;
+  }
+  view.Reset(this, rid);
+  return true;
+}
+
+bool PaxPage::GetFirstTupleRid(RowId *first_rid) {
+  return FindTupleRid(0, nullptr, nullptr, first_rid);
+}
+
+std::vector<RowId> PaxPage::GetDeletedRids() {
+  std::vector<RowId> rids;
+  const char *used = GetUsedBitmap();
+  const char *deleted = GetDeletedBitmap();
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetBit(used, i) && GetBit(deleted, i)) {
+      rids.emplace_back(GetTablePageId(), i);
+    }
+  }
+  return rids;
+}
+
+bool PaxPage::IsEmpty() {
+  const char *used = GetUsedBitmap();
+  for (uint32_t i = 0; i < GetBitmapSize(GetTupleCount()); i++) {
+    if (used[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool PaxPage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
+  ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
+  return FindTupleRid(cur_rid.GetSlotNum() + 1, nullptr, nullptr, next_rid);
+}
+
+bool PaxPage::FindTupleRid(uint32_t slot, const ScanPredicate *predicate, Schema *schema, RowId *rid) {
+  const char *used = GetUsedBitmap();
+  const char *deleted = GetDeletedBitmap();
+  uint32_t tuple_count = GetTupleCount();
+  std::unique_ptr<RowView> view;
+  for (auto i = slot; i < tuple_count; i++) {
+    if (!GetBit(used, i) || GetBit(deleted, i)) {
+      continue;
+    }
+    rid->Set(GetTablePageId(), i);
+    if (predicate == nullptr) {
+      return true;
+    }
+    if (view == nullptr) {
+      view = std::make_unique<RowView>(schema);
+    }
+    view->Reset(this, *rid);
+    if (predicate->Evaluate(*view)) {
+      return true;
+    }
+  }
+  rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
+
+uint32_t PaxPage::GetTotalFreeSpace() {
+  return FindFreeSlot() == INVALID_SLOT ? 0 : GetFreeCharSpace();
+}
+
+uint32_t PaxPage::GetAverageCharSize() {
+  uint32_t tuple_count = 0;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    tuple_count += GetBit(GetUsedBitmap(), i);
+  }
+  if (tuple_count == 0) {
+    return 0;
+  }
+  return (GetPageSize() - GetCharDataPointer() + tuple_count - 1) / tuple_count;
+}
+
+uint32_t PaxPage::FindFreeSlot() {
+  // slots after the tuple count are all free
+  const auto *used = reinterpret_cast<const uint32_t *>(GetUsedBitmap());
+  uint32_t word_count = (GetTupleCount() + 31) / 32;
+  for (uint32_t i = 0; i < word_count; i++) {
+    if (used[i] != UINT32_MAX) {
+      for (uint32_t slot = i * 32; slot < (i + 1) * 32; slot++) {
+        if (!GetBit(GetUsedBitmap(), slot)) {
+          return slot < GetCapacity() ? slot : INVALID_SLOT;
+        }
+      }
+    }
+  }
+  return GetTupleCount() < GetCapacity() ? GetTupleCount() : INVALID_SLOT;
+}
+
+uint32_t PaxPage::GetCharSize(const Row &row, Schema *schema) {
+  uint32_t char_size = 0;
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar) {
+      char_size += row.GetField(i)->GetSerializedSize();
+    }
+  }
+  return char_size;
+}
+
+uint32_t PaxPage::GetCharSize(uint32_t slot, Schema *schema) {
+  uint32_t char_size = 0;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    if (schema->GetColumn(i)->GetType() == TypeId::kTypeChar && !IsNull(slot, i)) {
+      char_size += Type::GetInstance(TypeId::kTypeChar)->GetSerializedSize(GetFieldData(slot, i, TypeId::kTypeChar));
+    }
+  }
+  return char_size;
+}
+
+void PaxPage::WriteTuple(uint32_t slot, const Row &row, Schema *schema) {
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    const Field *field = row.GetField(i);
+    SetBit(GetNullBitmap(i), slot, field->IsNull());
+    if (field->IsNull()) {
+      continue;
+    }
+    TypeId type = schema->GetColumn(i)->GetType();
+    if (type == TypeId::kTypeChar) {
+      uint32_t offset = GetCharDataPointer() - field->GetSerializedSize();
+      field->SerializeTo(GetData() + offset);
+      SetCharDataPointer(offset);
+      reinterpret_cast<uint32_t *>(GetColumnValues(i))[slot] = offset;
+    } else {
+      field->SerializeTo(GetColumnValues(i) + slot * Type::GetTypeSize(type));
+    }
+  }
+  SetBit(GetUsedBitmap(), slot, true);
+  SetBit(GetDeletedBitmap(), slot, false);
+  if (slot >= GetTupleCount()) {
+    SetTupleCount(slot + 1);
+  }
+}
+
+uint32_t PaxPage::CompactCharData(Schema *schema) {
+  // slide values to the end of the page, starting from the one closest to it, so no value is overwritten
+  // before it is moved
+  std::vector<uint32_t *> offsets;
+  for (uint32_t i = 0; i < GetColumnCount(); i++) {
+    if (schema->GetColumn(i)->GetType() != TypeId::kTypeChar) {
+      continue;
+    }
+    auto column_offsets = reinterpret_cast<uint32_t *>(GetColumnValues(i));
+    for (uint32_t slot = 0; slot < GetTupleCount(); slot++) {
+      if (GetBit(GetUsedBitmap(), slot) && !IsNull(slot, i)) {
+        offsets.push_back(column_offsets + slot);
+      }
+    }
+  }
+  std::sort(offsets.begin(), offsets.end(), [](uint32_t *a, uint32_t *b) { return *a > *b; });
+  Type *type = Type::GetInstance(TypeId::kTypeChar);
+  uint32_t write_offset = GetPageSize();
+  for (auto offset : offsets) {
+    uint32_t size = type->GetSerializedSize(GetData() + *offset);
+    write_offset -= size;
+    memmove(GetData() + write_offset, GetData() + *offset, size);
+    *offset = write_offset;
+  }
+  SetCharDataPointer(write_offset);
+  return GetFreeCharSpace();
+}
@@ -1,48 +1,110 @@
+#include <algorithm>
+
 #include "page/table_page.h"
+#include "record/row_view.h"
+#include "storage/scan_predicate.h"
 
 void TablePage::Init(page_id_t page_id, page_id_t prev_id, LogManager *log_mgr, Transaction *txn) {
   memcpy(GetData(), &page_id, sizeof(page_id));
   SetPrevPageId(prev_id);
   SetNextPageId(INVALID_PAGE_ID);
-  SetFreeSpacePointer(PAGE_SIZE);
+  SetFreeSpacePointer(GetPageSize());
   SetTupleCount(0);
+  SetFreeSpaceMapPageId(INVALID_PAGE_ID);
+  SetFreeSlotHead(INVALID_SLOT);
+  SetFragmentedSpace(0);
 }
 
 bool TablePage::InsertTuple(Row &row, Schema *schema, Transaction *txn,
                             LockManager *lock_manager, LogManager *log_manager) {
   uint32_t serialized_size = row.GetSerializedSize(schema);
   ASSERT(serialized_size > 0, "Can not have empty row.");
-  if (GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
+  uint32_t i = AllocateTuple(serialized_size);
+  if (i == INVALID_SLOT) {
     return false;
   }
-  // Try to find a free slot to reuse.
-  uint32_t i;
-  for (i = 0; i < GetTupleCount(); i++) {
-    // If the slot is empty, i.e. its tuple has size 0,
-    if (GetTupleSize(i) == 0) {
-      // Then we break out of the loop at index i.
-      break;
+  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetTupleOffsetAtSlot(i), schema);
+  ASSERT(write_bytes == serialized_size, "Unexpected behavior in row serialize.");
+  // Set rid
+  row.SetRowId(RowId(GetTablePageId(), i));
+  return true;
+}
+
+bool TablePage::InsertMovedTuple(Row &row, const RowId &home_rid, Schema *schema) {
+  uint32_t serialized_size = row.GetSerializedSize(schema);
+  uint32_t i = AllocateTuple(SIZE_RID + serialized_size);
+  if (i == INVALID_SLOT) {
+    return false;
+  }
+  char *data = GetData() + GetTupleOffsetAtSlot(i);
+  int64_t home = home_rid.Get();
+  memcpy(data, &home, SIZE_RID);
+  row.SerializeTo(data + SIZE_RID, schema);
+  SetTupleSize(i, MOVED_MASK | (SIZE_RID + serialized_size));
+  row.SetRowId(RowId(GetTablePageId(), i));
+  return true;
+}
+
+uint32_t TablePage::AllocateTuple(uint32_t size) {
+  // Reuse the first slot in the free slot chain, or append a new slot.
+  uint32_t i = GetFreeSlotHead();
+  uint32_t space_needed = size + (i == INVALID_SLOT ? SIZE_TUPLE : 0);
+  if (GetFreeSpaceRemaining() < space_needed) {
+    if (GetTotalFreeSpace() < space_needed) {
+      return INVALID_SLOT;
     }
+    Compact();
   }
-  if (i == GetTupleCount() && GetFreeSpaceRemaining() < serialized_size + SIZE_TUPLE) {
-    return false;
+  if (i == INVALID_SLOT) {
+    i = GetTupleCount();
+  } else {
+    SetFreeSlotHead(GetTupleOffsetAtSlot(i));
   }
   // Otherwise we claim available free space..
-  SetFreeSpacePointer(GetFreeSpacePointer() - serialized_size);
-  uint32_t __attribute__((unused)) write_bytes = row.SerializeTo(GetData() + GetFreeSpacePointer(), schema);
-  ASSERT(write_bytes = serialized_size, "Unexpected behavior in row serialize.");
-
-  // Set the tuple.
+  SetFreeSpacePointer(GetFreeSpacePointer() - size);
   SetTupleOffsetAtSlot(i, GetFreeSpacePointer());
-  SetTupleSize(i, serialized_size);
-  // Set rid
-  row.SetRowId(RowId(GetTablePageId(), i));
+  SetTupleSize(i, size);
   if (i == GetTupleCount()) {
     SetTupleCount(GetTupleCount() + 1);
   }
+  return i;
+}
+
+bool TablePage::ResizeTuple(uint32_t slot_num, uint32_t size) {
+  uint32_t tuple_size = GetStoredSize(GetTupleSize(slot_num));
+  if (GetFreeSpaceRemaining() + tuple_size < size) {
+    if (GetTotalFreeSpace() + tuple_size < size) {
+      return false;
+    }
+    Compact();
+  }
+  // Slide the tuples stored before this one, so that its storage still ends where it did.
+  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
+  memmove(GetData() + free_space_pointer + tuple_size - size, GetData() + free_space_pointer,
+          tuple_offset - free_space_pointer);
+  SetFreeSpacePointer(free_space_pointer + tuple_size - size);
+  // Update all tuple offsets, including the one of this slot.
+  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
+    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
+    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
+      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - size);
+    }
+  }
+  SetTupleSize(slot_num, size);
   return true;
 }
 
+size_t TablePage::InsertTuples(std::vector<Row> &rows, size_t begin, size_t end, Schema *schema, Transaction *txn,
+                               LockManager *lock_manager, LogManager *log_manager) {
+  size_t i = begin;
+  while (i < end && InsertTuple(rows[i], schema, txn, lock_manager, log_manager)) {
+    i++;
+  }
+  return i - begin;
+}
+
 bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort.
@@ -54,10 +116,12 @@ bool TablePage::MarkDelete(const RowId &rid, Transaction *txn, LockManager *lock
   if (IsDeleted(tuple_size)) {
     return false;
   }
-  // Mark the tuple as deleted.
-  if (tuple_size > 0) {
-    SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
+  // A moved tuple is marked in its new location.
+  if (IsForward(tuple_size)) {
+    return false;
   }
+  // Mark the tuple as deleted.
+  SetTupleSize(slot_num, SetDeletedFlag(tuple_size));
   return true;
 }
 
@@ -72,33 +136,70 @@ bool TablePage::UpdateTuple(const Row &new_row, Row *old_row, Schema *schema,
     return false;
   }
   uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort.
-  if (IsDeleted(tuple_size)) {
+  // If the tuple is deleted or moved to another page, abort.
+  if (!IsVisible(tuple_size)) {
     return false;
   }
-  // If there is not enough space to update, we need to update via delete followed by an insert (not enough space).
-  if (GetFreeSpaceRemaining() + tuple_size < serialized_size) {
+  // A moved tuple keeps the rid of its home slot in front of it.
+  uint32_t prefix_size = IsMoved(tuple_size) ? SIZE_RID : 0;
+  // If there is not enough space to update, the tuple is moved to another page by the table heap.
+  if (GetTotalFreeSpace() + GetStoredSize(tuple_size) < prefix_size + serialized_size) {
     return false;
   }
   // Copy out the old value.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(GetData() + tuple_offset, schema);
-  ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
-  uint32_t free_space_pointer = GetFreeSpacePointer();
-  ASSERT(tuple_offset >= free_space_pointer, "Offset should appear after current free space position.");
-  memmove(GetData() + free_space_pointer + tuple_size - serialized_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size - serialized_size);
-  new_row.SerializeTo(GetData() + tuple_offset + tuple_size - serialized_size, schema);
-  SetTupleSize(slot_num, serialized_size);
+  char *data = GetData() + GetTupleOffsetAtSlot(slot_num);
+  int64_t home_rid = 0;
+  memcpy(&home_rid, data, prefix_size);
+  uint32_t __attribute__((unused)) read_bytes = old_row->DeserializeFrom(data + prefix_size, schema);
+  ASSERT(GetStoredSize(tuple_size) == prefix_size + read_bytes, "Unexpected behavior in tuple deserialize.");
+  ResizeTuple(slot_num, prefix_size + serialized_size);
+  data = GetData() + GetTupleOffsetAtSlot(slot_num);
+  memcpy(data, &home_rid, prefix_size);
+  new_row.SerializeTo(data + prefix_size, schema);
+  SetTupleSize(slot_num, (tuple_size & MOVED_MASK) | (prefix_size + serialized_size));
+  return true;
+}
 
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) > 0 && tuple_offset_i < tuple_offset + tuple_size) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size - new_row.GetSerializedSize(schema));
+bool TablePage::GetForwardRid(const RowId &rid, RowId *target_rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsForward(GetTupleSize(slot_num))) {
+    return false;
+  }
+  *target_rid = GetHomeRid(slot_num);
+  return true;
+}
+
+bool TablePage::ForwardTuple(const RowId &rid, const RowId &target_rid, Row *old_row, Schema *schema) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount()) {
+    return false;
+  }
+  uint32_t tuple_size = GetTupleSize(slot_num);
+  if (IsDeleted(tuple_size)) {
+    return false;
+  }
+  ASSERT(!IsMoved(tuple_size), "Only a tuple in its home slot is forwarded.");
+  if (!IsForward(tuple_size)) {
+    if (GetTotalFreeSpace() + tuple_size < SIZE_RID) {
+      return false;
     }
+    old_row->DeserializeFrom(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
+    ResizeTuple(slot_num, SIZE_RID);
+    SetTupleSize(slot_num, FORWARD_MASK | SIZE_RID);
+  }
+  int64_t target = target_rid.Get();
+  memcpy(GetData() + GetTupleOffsetAtSlot(slot_num), &target, SIZE_RID);
+  return true;
+}
+
+bool TablePage::RestoreTuple(const RowId &rid, const Row &row, Schema *schema) {
+  uint32_t slot_num = rid.GetSlotNum();
+  ASSERT(slot_num < GetTupleCount() && IsForward(GetTupleSize(slot_num)), "No forward record in slot.");
+  uint32_t serialized_size = row.GetSerializedSize(schema);
+  if (!ResizeTuple(slot_num, serialized_size)) {
+    return false;
   }
+  row.SerializeTo(GetData() + GetTupleOffsetAtSlot(slot_num), schema);
   return true;
 }
 
@@ -108,27 +209,51 @@ void TablePage::ApplyDelete(const RowId &rid, Transaction *txn, LogManager *log_
 
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
   uint32_t tuple_size = GetTupleSize(slot_num);
-  // Check if this is a delete operation, i.e. commit a delete.
-  if (IsDeleted(tuple_size)) {
-    tuple_size = UnsetDeletedFlag(tuple_size);
+  // The slot is already free.
+  if (tuple_size == 0) {
+    return;
   }
+  // Drop the flags of a deleted, forwarded or moved tuple.
+  tuple_size = GetStoredSize(tuple_size);
 
   uint32_t free_space_pointer = GetFreeSpacePointer();
   ASSERT(tuple_offset >= free_space_pointer, "Free space appears before tuples.");
-
-  memmove(GetData() + free_space_pointer + tuple_size, GetData() + free_space_pointer,
-          tuple_offset - free_space_pointer);
-  SetFreeSpacePointer(free_space_pointer + tuple_size);
+  // The storage joins the free space if it borders on it, otherwise it is left as a hole until compaction.
+  if (tuple_offset == free_space_pointer) {
+    SetFreeSpacePointer(free_space_pointer + tuple_size);
+  } else {
+    SetFragmentedSpace(GetFragmentedSpace() + tuple_size);
+  }
   SetTupleSize(slot_num, 0);
-  SetTupleOffsetAtSlot(slot_num, 0);
+  SetTupleOffsetAtSlot(slot_num, GetFreeSlotHead());
+  SetFreeSlotHead(slot_num);
+}
 
-  // Update all tuple offsets.
-  for (uint32_t i = 0; i < GetTupleCount(); ++i) {
-    uint32_t tuple_offset_i = GetTupleOffsetAtSlot(i);
-    if (GetTupleSize(i) != 0 && tuple_offset_i < tuple_offset) {
-      SetTupleOffsetAtSlot(i, tuple_offset_i + tuple_size);
+void TablePage::Compact() {
+  if (GetFragmentedSpace() == 0) {
+    return;
+  }
+  // Slide tuples to the end of the page, starting from the one closest to it, so no tuple is overwritten
+  // before it is moved.
+  std::vector<uint32_t> slots;
+  slots.reserve(GetTupleCount());
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) != 0) {
+      slots.push_back(i);
     }
   }
+  std::sort(slots.begin(), slots.end(), [this](uint32_t a, uint32_t b) {
+    return GetTupleOffsetAtSlot(a) > GetTupleOffsetAtSlot(b);
+  });
+  uint32_t write_offset = GetPageSize();
+  for (auto slot : slots) {
+    uint32_t tuple_size = GetStoredSize(GetTupleSize(slot));
+    write_offset -= tuple_size;
+    memmove(GetData() + write_offset, GetData() + GetTupleOffsetAtSlot(slot), tuple_size);
+    SetTupleOffsetAtSlot(slot, write_offset);
+  }
+  SetFreeSpacePointer(write_offset);
+  SetFragmentedSpace(0);
 }
 
 void TablePage::RollbackDelete(const RowId &rid, Transaction *txn, LogManager *log_manager) {
@@ -152,21 +277,49 @@ bool TablePage::GetTuple(Row *row, Schema *schema, Transaction *txn, LockManager
   }
   // Otherwise get the current tuple size too.
   uint32_t tuple_size = GetTupleSize(slot_num);
-  // If the tuple is deleted, abort the transaction.
-  if (IsDeleted(tuple_size)) {
+  // If the tuple is deleted or moved to another page, abort the transaction.
+  if (!IsVisible(tuple_size)) {
     return false;
   }
   // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
+  uint32_t prefix_size = IsMoved(tuple_size) ? SIZE_RID : 0;
   uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset, schema);
-  ASSERT(tuple_size == read_bytes, "Unexpected behavior in tuple deserialize.");
+  uint32_t __attribute__((unused)) read_bytes = row->DeserializeFrom(GetData() + tuple_offset + prefix_size, schema);
+  ASSERT(GetStoredSize(tuple_size) == prefix_size + read_bytes, "Unexpected behavior in tuple deserialize.");
+  return true;
+}
+
+bool TablePage::GetStoredTuple(Row *row, Schema *schema) {
+  uint32_t slot_num = row->GetRowId().GetSlotNum();
+  if (slot_num >= GetTupleCount() || GetTupleSize(slot_num) == 0 || IsForward(GetTupleSize(slot_num))) {
+    return false;
+  }
+  uint32_t prefix_size = IsMoved(GetTupleSize(slot_num)) ? SIZE_RID : 0;
+  row->DeserializeFrom(GetData() + GetTupleOffsetAtSlot(slot_num) + prefix_size, schema);
+  return true;
+}
+
+char *TablePage::GetTupleData(const RowId &rid) {
+  uint32_t slot_num = rid.GetSlotNum();
+  if (slot_num >= GetTupleCount() || !IsVisible(GetTupleSize(slot_num))) {
+    return nullptr;
+  }
+  return GetData() + GetTupleOffsetAtSlot(slot_num) + (IsMoved(GetTupleSize(slot_num)) ? SIZE_RID : 0);
+}
+
+bool TablePage::GetTupleView(const RowId &rid, RowView &view) {
+  char *data = GetTupleData(rid);
+  if (data == nullptr) {
+    return false;
+  }
+  view.Reset(data, IsMoved(GetTupleSize(rid.GetSlotNum())) ? GetHomeRid(rid.GetSlotNum()) : rid);
   return true;
 }
 
 bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   // Find and return the first valid tuple.
   for (uint32_t i = 0; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (IsVisible(GetTupleSize(i))) {
       first_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -175,11 +328,31 @@ bool TablePage::GetFirstTupleRid(RowId *first_rid) {
   return false;
 }
 
+std::vector<RowId> TablePage::GetDeletedRids() {
+  std::vector<RowId> rids;
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    uint32_t tuple_size = GetTupleSize(i);
+    if (tuple_size != 0 && IsDeleted(tuple_size)) {
+      rids.push_back(IsMoved(tuple_size) ? GetHomeRid(i) : RowId(GetTablePageId(), i));
+    }
+  }
+  return rids;
+}
+
+bool TablePage::IsEmpty() {
+  for (uint32_t i = 0; i < GetTupleCount(); i++) {
+    if (GetTupleSize(i) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
 bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   ASSERT(cur_rid.GetPageId() == GetTablePageId(), "Wrong table!");
   // Find and return the first valid tuple after our current slot number.
   for (auto i = cur_rid.GetSlotNum() + 1; i < GetTupleCount(); i++) {
-    if (!IsDeleted(GetTupleSize(i))) {
+    if (IsVisible(GetTupleSize(i))) {
       next_rid->Set(GetTablePageId(), i);
       return true;
     }
@@ -188,3 +361,22 @@ bool TablePage::GetNextTupleRid(const RowId &cur_rid, RowId *next_rid) {
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+bool TablePage::FindTupleRid(uint32_t slot, const ScanPredicate *predicate, Schema *schema, RowId *rid) {
+  RowView view(schema);
+  for (auto i = slot; i < GetTupleCount(); i++) {
+    if (!IsVisible(GetTupleSize(i))) {
+      continue;
+    }
+    rid->Set(GetTablePageId(), i);
+    if (predicate == nullptr) {
+      return true;
+    }
+    view.Reset(GetTupleData(*rid), *rid);
+    if (predicate->Evaluate(view)) {
+      return true;
+    }
+  }
+  rid->Set(INVALID_PAGE_ID, 0);
+  return false;
+}
@@ -0,0 +1,36 @@
+#include <cstring>
+
+#include "page/tablespaces_page.h"
+
+bool TablespacesPage::Insert(const file_id_t file_id, const std::string &name, const std::string &path) {
+  if (name.size() > MAX_NAME_LEN || path.size() > MAX_PATH_LEN) {
+    return false;
+  }
+  // check for duplicate tablespace name
+  if (FindTablespace(name) != -1) {
+    return false;
+  }
+  records_[count_].file_id_ = file_id;
+  strcpy(records_[count_].name_, name.c_str());
+  strcpy(records_[count_].path_, path.c_str());
+  count_++;
+  return true;
+}
+
+bool TablespacesPage::GetFileId(const std::string &name, file_id_t *file_id) {
+  auto index = FindTablespace(name);
+  if (index == -1) {
+    return false;
+  }
+  *file_id = records_[index].file_id_;
+  return true;
+}
+
+int TablespacesPage::FindTablespace(const std::string &name) {
+  for (auto i = 0; i < count_; i++) {
+    if (name == records_[i].name_) {
+      return i;
+    }
+  }
+  return -1;
+}
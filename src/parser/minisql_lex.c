@@ -592,12 +592,15 @@ char *yytext;
 #line 2 "minisql.l"
 
 #include <stdio.h>
+#include <string.h>
 #include "parser/parser.h"
 #include "parser/minisql_yacc.h"
 
 int yywrap();
 
 extern YYSTYPE yylval;
+
+static int MinisqlKeyword(const char *text);
 #line 585 "../../parser/minisql_lex.c"
 
 #define INITIAL 0
@@ -784,7 +787,7 @@ YY_DECL {
   register char *yy_cp, *yy_bp;
   register int yy_act;
 
-#line 15 "minisql.l"
+#line 17 "minisql.l"
 
 
 #line 770 "../../parser/minisql_lex.c"
@@ -874,7 +877,7 @@ YY_DECL {
       case 1:
 /* rule 1 can match eol */
         YY_RULE_SETUP
-#line 17 "minisql.l"
+#line 19 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeString, yytext);
@@ -883,7 +886,7 @@ YY_DECL {
         YY_BREAK
       case 2:
         YY_RULE_SETUP
-#line 23 "minisql.l"
+#line 25 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return CREATE;
@@ -891,7 +894,7 @@ YY_DECL {
         YY_BREAK
       case 3:
         YY_RULE_SETUP
-#line 28 "minisql.l"
+#line 30 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return DROP;
@@ -899,7 +902,7 @@ YY_DECL {
         YY_BREAK
       case 4:
         YY_RULE_SETUP
-#line 33 "minisql.l"
+#line 35 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return SELECT;
@@ -907,7 +910,7 @@ YY_DECL {
         YY_BREAK
       case 5:
         YY_RULE_SETUP
-#line 38 "minisql.l"
+#line 40 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return INSERT;
@@ -915,7 +918,7 @@ YY_DECL {
         YY_BREAK
       case 6:
         YY_RULE_SETUP
-#line 43 "minisql.l"
+#line 45 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return DELETE;
@@ -923,7 +926,7 @@ YY_DECL {
         YY_BREAK
       case 7:
         YY_RULE_SETUP
-#line 48 "minisql.l"
+#line 50 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return UPDATE;
@@ -931,7 +934,7 @@ YY_DECL {
         YY_BREAK
       case 8:
         YY_RULE_SETUP
-#line 53 "minisql.l"
+#line 55 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return TRXBEGIN;
@@ -939,7 +942,7 @@ YY_DECL {
         YY_BREAK
       case 9:
         YY_RULE_SETUP
-#line 58 "minisql.l"
+#line 60 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return TRXCOMMIT;
@@ -947,7 +950,7 @@ YY_DECL {
         YY_BREAK
       case 10:
         YY_RULE_SETUP
-#line 63 "minisql.l"
+#line 65 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return TRXROLLBACK;
@@ -955,7 +958,7 @@ YY_DECL {
         YY_BREAK
       case 11:
         YY_RULE_SETUP
-#line 68 "minisql.l"
+#line 70 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return QUIT;
@@ -963,7 +966,7 @@ YY_DECL {
         YY_BREAK
       case 12:
         YY_RULE_SETUP
-#line 73 "minisql.l"
+#line 75 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return EXECFILE;
@@ -971,7 +974,7 @@ YY_DECL {
         YY_BREAK
       case 13:
         YY_RULE_SETUP
-#line 78 "minisql.l"
+#line 80 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return SHOW;
@@ -979,7 +982,7 @@ YY_DECL {
         YY_BREAK
       case 14:
         YY_RULE_SETUP
-#line 83 "minisql.l"
+#line 85 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return USE;
@@ -987,7 +990,7 @@ YY_DECL {
         YY_BREAK
       case 15:
         YY_RULE_SETUP
-#line 88 "minisql.l"
+#line 90 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return USING;
@@ -995,7 +998,7 @@ YY_DECL {
         YY_BREAK
       case 16:
         YY_RULE_SETUP
-#line 93 "minisql.l"
+#line 95 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return DATABASE;
@@ -1003,7 +1006,7 @@ YY_DECL {
         YY_BREAK
       case 17:
         YY_RULE_SETUP
-#line 98 "minisql.l"
+#line 100 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return DATABASES;
@@ -1011,7 +1014,7 @@ YY_DECL {
         YY_BREAK
       case 18:
         YY_RULE_SETUP
-#line 103 "minisql.l"
+#line 105 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return TABLE;
@@ -1019,7 +1022,7 @@ YY_DECL {
         YY_BREAK
       case 19:
         YY_RULE_SETUP
-#line 108 "minisql.l"
+#line 110 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return TABLES;
@@ -1027,7 +1030,7 @@ YY_DECL {
         YY_BREAK
       case 20:
         YY_RULE_SETUP
-#line 113 "minisql.l"
+#line 115 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return INDEX;
@@ -1035,7 +1038,7 @@ YY_DECL {
         YY_BREAK
       case 21:
         YY_RULE_SETUP
-#line 118 "minisql.l"
+#line 120 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return INDEXES;
@@ -1043,7 +1046,7 @@ YY_DECL {
         YY_BREAK
       case 22:
         YY_RULE_SETUP
-#line 123 "minisql.l"
+#line 125 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ON;
@@ -1051,7 +1054,7 @@ YY_DECL {
         YY_BREAK
       case 23:
         YY_RULE_SETUP
-#line 128 "minisql.l"
+#line 130 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return FROM;
@@ -1059,7 +1062,7 @@ YY_DECL {
         YY_BREAK
       case 24:
         YY_RULE_SETUP
-#line 133 "minisql.l"
+#line 135 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return WHERE;
@@ -1067,7 +1070,7 @@ YY_DECL {
         YY_BREAK
       case 25:
         YY_RULE_SETUP
-#line 138 "minisql.l"
+#line 140 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return INTO;
@@ -1075,7 +1078,7 @@ YY_DECL {
         YY_BREAK
       case 26:
         YY_RULE_SETUP
-#line 143 "minisql.l"
+#line 145 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return SET;
@@ -1083,7 +1086,7 @@ YY_DECL {
         YY_BREAK
       case 27:
         YY_RULE_SETUP
-#line 148 "minisql.l"
+#line 150 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return VALUES;
@@ -1091,7 +1094,7 @@ YY_DECL {
         YY_BREAK
       case 28:
         YY_RULE_SETUP
-#line 153 "minisql.l"
+#line 155 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return PRIMARY;
@@ -1099,7 +1102,7 @@ YY_DECL {
         YY_BREAK
       case 29:
         YY_RULE_SETUP
-#line 158 "minisql.l"
+#line 160 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return KEY;
@@ -1107,7 +1110,7 @@ YY_DECL {
         YY_BREAK
       case 30:
         YY_RULE_SETUP
-#line 163 "minisql.l"
+#line 165 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return UNIQUE;
@@ -1115,7 +1118,7 @@ YY_DECL {
         YY_BREAK
       case 31:
         YY_RULE_SETUP
-#line 168 "minisql.l"
+#line 170 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return CHAR;
@@ -1123,7 +1126,7 @@ YY_DECL {
         YY_BREAK
       case 32:
         YY_RULE_SETUP
-#line 173 "minisql.l"
+#line 175 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return INT;
@@ -1131,7 +1134,7 @@ YY_DECL {
         YY_BREAK
       case 33:
         YY_RULE_SETUP
-#line 178 "minisql.l"
+#line 180 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return FLOAT;
@@ -1139,7 +1142,7 @@ YY_DECL {
         YY_BREAK
       case 34:
         YY_RULE_SETUP
-#line 183 "minisql.l"
+#line 185 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return AND;
@@ -1147,7 +1150,7 @@ YY_DECL {
         YY_BREAK
       case 35:
         YY_RULE_SETUP
-#line 188 "minisql.l"
+#line 190 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return OR;
@@ -1155,7 +1158,7 @@ YY_DECL {
         YY_BREAK
       case 36:
         YY_RULE_SETUP
-#line 193 "minisql.l"
+#line 195 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return NOT;
@@ -1163,7 +1166,7 @@ YY_DECL {
         YY_BREAK
       case 37:
         YY_RULE_SETUP
-#line 198 "minisql.l"
+#line 200 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return IS;
@@ -1171,7 +1174,7 @@ YY_DECL {
         YY_BREAK
       case 38:
         YY_RULE_SETUP
-#line 203 "minisql.l"
+#line 205 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return FLAGNULL;
@@ -1179,16 +1182,20 @@ YY_DECL {
         YY_BREAK
       case 39:
         YY_RULE_SETUP
-#line 208 "minisql.l"
+#line 210 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
+        int keyword = MinisqlKeyword(yytext);
+        if (keyword != 0) {
+          return keyword;
+        }
         yylval.syntax_node = CreateSyntaxNode(kNodeIdentifier, yytext);
         return IDENTIFIER;
       }
         YY_BREAK
       case 40:
         YY_RULE_SETUP
-#line 214 "minisql.l"
+#line 220 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1197,7 +1204,7 @@ YY_DECL {
         YY_BREAK
       case 41:
         YY_RULE_SETUP
-#line 220 "minisql.l"
+#line 226 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         yylval.syntax_node = CreateSyntaxNode(kNodeNumber, yytext);
@@ -1206,7 +1213,7 @@ YY_DECL {
         YY_BREAK
       case 42:
         YY_RULE_SETUP
-#line 226 "minisql.l"
+#line 232 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return EQ;
@@ -1214,7 +1221,7 @@ YY_DECL {
         YY_BREAK
       case 43:
         YY_RULE_SETUP
-#line 231 "minisql.l"
+#line 237 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return NE;
@@ -1222,7 +1229,7 @@ YY_DECL {
         YY_BREAK
       case 44:
         YY_RULE_SETUP
-#line 236 "minisql.l"
+#line 242 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return LE;
@@ -1230,7 +1237,7 @@ YY_DECL {
         YY_BREAK
       case 45:
         YY_RULE_SETUP
-#line 241 "minisql.l"
+#line 247 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return GE;
@@ -1238,7 +1245,7 @@ YY_DECL {
         YY_BREAK
       case 46:
         YY_RULE_SETUP
-#line 246 "minisql.l"
+#line 252 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (',');
@@ -1246,7 +1253,7 @@ YY_DECL {
         YY_BREAK
       case 47:
         YY_RULE_SETUP
-#line 251 "minisql.l"
+#line 257 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('*');
@@ -1254,7 +1261,7 @@ YY_DECL {
         YY_BREAK
       case 48:
         YY_RULE_SETUP
-#line 256 "minisql.l"
+#line 262 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (';');
@@ -1262,7 +1269,7 @@ YY_DECL {
         YY_BREAK
       case 49:
         YY_RULE_SETUP
-#line 261 "minisql.l"
+#line 267 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('\'');
@@ -1270,7 +1277,7 @@ YY_DECL {
         YY_BREAK
       case 50:
         YY_RULE_SETUP
-#line 266 "minisql.l"
+#line 272 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('<');
@@ -1278,7 +1285,7 @@ YY_DECL {
         YY_BREAK
       case 51:
         YY_RULE_SETUP
-#line 271 "minisql.l"
+#line 277 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('>');
@@ -1286,7 +1293,7 @@ YY_DECL {
         YY_BREAK
       case 52:
         YY_RULE_SETUP
-#line 276 "minisql.l"
+#line 282 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return ('(');
@@ -1294,7 +1301,7 @@ YY_DECL {
         YY_BREAK
       case 53:
         YY_RULE_SETUP
-#line 281 "minisql.l"
+#line 287 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
         return (')');
@@ -1303,14 +1310,14 @@ YY_DECL {
       case 54:
 /* rule 54 can match eol */
         YY_RULE_SETUP
-#line 286 "minisql.l"
+#line 292 "minisql.l"
       {
         MinisqlParserMovePos(yylineno, yytext);
       }
         YY_BREAK
       case 55:
         YY_RULE_SETUP
-#line 290 "minisql.l"
+#line 296 "minisql.l"
       {
         char str[128] = {0};
         sprintf(str, "Unrecognized token [%s] in input sql.", yytext);
@@ -1319,7 +1326,7 @@ YY_DECL {
         YY_BREAK
       case 56:
         YY_RULE_SETUP
-#line 296 "minisql.l"
+#line 302 "minisql.l"
         ECHO;
         YY_BREAK
 #line 1314 "../../parser/minisql_lex.c"
@@ -2258,9 +2265,26 @@ void yyfree(void *ptr) {
 
 #define YYTABLES_NAME "yytables"
 
-#line 296 "minisql.l"
+#line 302 "minisql.l"
 
 
 int yywrap() {
   return 1;
 }
+
+/**
+ * Keywords matched by the identifier rule
+ * @return token of the keyword, 0 if text is not one of them
+ */
+static int MinisqlKeyword(const char *text) {
+  if (strcmp(text, "truncate") == 0) {
+    return TRUNCATE;
+  }
+  if (strcmp(text, "tablespace") == 0) {
+    return TABLESPACE;
+  }
+  if (strcmp(text, "iostats") == 0) {
+    return IOSTATS;
+  }
+  return 0;
+}
@@ -169,6 +169,14 @@ const char *GetSyntaxNodeTypeStr(SyntaxNodeType type) {
       return "kNodeTrxCommit";
     case kNodeTrxRollback:
       return "kNodeTrxRollback";
+    case kNodeTablespace:
+      return "kNodeTablespace";
+    case kNodeTableFormat:
+      return "kNodeTableFormat";
+    case kNodeShowIOStats:
+      return "kNodeShowIOStats";
+    case kNodeTruncateTable:
+      return "kNodeTruncateTable";
     default:
       return "error type";
   }
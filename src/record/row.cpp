@@ -1,16 +1,67 @@
 #include "record/row.h"
 
-uint32_t Row::SerializeTo(char *buf, Schema *schema) const {
-  // replace with your code here
-  return 0;
+uint32_t Row::SerializeTo(char *buf, Schema *schema, uint32_t format_version) const {
+  ASSERT(schema->GetColumnCount() == fields_.size(), "Fields size do not match schema's column size.");
+  if (format_version != 1) {
+    return schema->GetRowCodec().SerializeTo(fields_, buf);
+  }
+  if (fields_.empty()) {
+    return 0;
+  }
+  char *p = buf;
+  uint32_t field_nums = fields_.size();
+  MACH_WRITE_UINT32(p, field_nums);
+  p += sizeof(uint32_t);
+  // null bitmap
+  uint32_t bitmap_size = (field_nums + 7) / 8;
+  memset(p, 0, bitmap_size);
+  for (uint32_t i = 0; i < field_nums; i++) {
+    if (fields_[i]->IsNull()) {
+      p[i / 8] |= static_cast<char>(1 << (i % 8));
+    }
+  }
+  p += bitmap_size;
+  for (auto field : fields_) {
+    p += field->SerializeTo(p);
+  }
+  return p - buf;
 }
 
 uint32_t Row::DeserializeFrom(char *buf, Schema *schema) {
-  // replace with your code here
-  return 0;
+  ASSERT(fields_.empty(), "Non empty field in row.");
+  return DeserializeFields(buf, schema, fields_, heap_);
 }
 
-uint32_t Row::GetSerializedSize(Schema *schema) const {
-  // replace with your code here
-  return 0;
+uint32_t Row::DeserializeFields(char *buf, Schema *schema, std::vector<Field *> &fields, MemHeap *heap) {
+  char *p = buf;
+  uint32_t field_nums = MACH_READ_UINT32(p);
+  if ((field_nums & ROW_FORMAT_V2) != 0) {
+    return schema->GetRowCodec().DeserializeFields(buf, fields, heap);
+  }
+  ASSERT(field_nums == schema->GetColumnCount(), "Fields size do not match schema's column size.");
+  p += sizeof(uint32_t);
+  char *bitmap = p;
+  p += (field_nums + 7) / 8;
+  fields.reserve(fields.size() + field_nums);
+  for (uint32_t i = 0; i < field_nums; i++) {
+    Field *field = nullptr;
+    bool is_null = (bitmap[i / 8] >> (i % 8)) & 1;
+    p += Field::DeserializeFrom(p, schema->GetColumn(i)->GetType(), &field, is_null, heap);
+    fields.push_back(field);
+  }
+  return p - buf;
+}
+
+uint32_t Row::GetSerializedSize(Schema *schema, uint32_t format_version) const {
+  if (format_version != 1) {
+    return schema->GetRowCodec().GetSerializedSize(fields_);
+  }
+  if (fields_.empty()) {
+    return 0;
+  }
+  uint32_t size = sizeof(uint32_t) + (fields_.size() + 7) / 8;
+  for (auto field : fields_) {
+    size += field->GetSerializedSize();
+  }
+  return size;
 }
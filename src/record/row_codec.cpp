@@ -0,0 +1,154 @@
+#include <algorithm>
+
+#include "record/field.h"
+#include "record/row.h"
+#include "record/row_codec.h"
+#include "record/schema.h"
+
+void RowCodec::Compile(const Schema *schema) {
+  // the null bitmap follows the field nums
+  uint32_t bitmap_offset = sizeof(uint32_t);
+  columns_.clear();
+  char_columns_.clear();
+  columns_.reserve(schema->GetColumnCount());
+  for (uint32_t i = 0; i < schema->GetColumnCount(); i++) {
+    ColumnPlan column{schema->GetColumn(i)->GetType(), schema->GetFieldOffset(i), bitmap_offset + i / 8,
+                      static_cast<uint8_t>(1 << (i % 8))};
+    columns_.push_back(column);
+    if (!schema->IsFixedWidth(i)) {
+      char_columns_.push_back(i);
+    }
+  }
+  fixed_row_size_ = schema->GetFixedRowSize();
+}
+
+uint32_t RowCodec::GetSerializedSize(const std::vector<Field *> &fields) const {
+  ASSERT(fields.size() == columns_.size(), "Fields size do not match schema's column size.");
+  if (fields.empty()) {
+    return 0;
+  }
+  uint32_t size = fixed_row_size_;
+  for (auto i : char_columns_) {
+    const Field *field = fields[i];
+    if (field->is_null_) {
+      continue;
+    }
+    if (field->is_encoded_) {
+      size += sizeof(uint32_t);
+    } else {
+      size += sizeof(uint32_t) + (field->IsExternal() ? sizeof(page_id_t) : field->len_);
+    }
+  }
+  return size;
+}
+
+uint32_t RowCodec::SerializeTo(const std::vector<Field *> &fields, char *buf) const {
+  ASSERT(fields.size() == columns_.size(), "Fields size do not match schema's column size.");
+  if (fields.empty()) {
+    return 0;
+  }
+  // null values, null bits and offset entries of null char values are all zero
+  memset(buf, 0, fixed_row_size_);
+  MACH_WRITE_UINT32(buf, GetColumnCount() | Row::ROW_FORMAT_V2);
+  char *p = buf + fixed_row_size_;
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    const ColumnPlan &column = columns_[i];
+    const Field *field = fields[i];
+    if (field->is_null_) {
+      buf[column.null_byte_] |= static_cast<char>(column.null_mask_);
+      continue;
+    }
+    switch (column.type_) {
+      case TypeId::kTypeInt:
+        MACH_WRITE_TO(int32_t, buf + column.offset_, field->value_.integer_);
+        break;
+      case TypeId::kTypeFloat:
+        MACH_WRITE_TO(float, buf + column.offset_, field->value_.float_);
+        break;
+      case TypeId::kTypeChar:
+        MACH_WRITE_UINT32(buf + column.offset_, static_cast<uint32_t>(p - buf));
+        if (field->is_encoded_) {
+          MACH_WRITE_UINT32(p, field->code_ | TypeChar::DICTIONARY_FLAG);
+          p += sizeof(uint32_t);
+        } else if (field->IsExternal()) {
+          MACH_WRITE_UINT32(p, field->len_ | TypeChar::EXTERNAL_FLAG);
+          MACH_WRITE_INT32(p + sizeof(uint32_t), field->external_page_id_);
+          p += sizeof(uint32_t) + sizeof(page_id_t);
+        } else {
+          MACH_WRITE_UINT32(p, field->len_);
+          memcpy(p + sizeof(uint32_t), field->GetChars(), field->len_);
+          p += sizeof(uint32_t) + field->len_;
+        }
+        break;
+      default:
+        ASSERT(false, "Unsupported type.");
+    }
+  }
+  return p - buf;
+}
+
+uint32_t RowCodec::DeserializeFields(char *buf, std::vector<Field *> &fields, MemHeap *heap) const {
+  ASSERT(MACH_READ_UINT32(buf) == (GetColumnCount() | Row::ROW_FORMAT_V2), "Row is not of the schema.");
+  // fields die with the heap together, so they are allocated a group at a time
+  Field *slots = nullptr;
+  fields.reserve(fields.size() + columns_.size());
+  for (uint32_t i = 0; i < columns_.size(); i++) {
+    uint32_t group_index = i % FIELD_GROUP_SIZE;
+    if (group_index == 0) {
+      uint32_t group_size = std::min(FIELD_GROUP_SIZE, GetColumnCount() - i);
+      slots = static_cast<Field *>(heap->Allocate(sizeof(Field) * group_size));
+    }
+    fields.push_back(DecodeField(buf, columns_[i], slots + group_index, heap));
+  }
+  // char values are stored in column order after the fixed part, the last non-null one ends the row
+  for (auto it = char_columns_.rbegin(); it != char_columns_.rend(); ++it) {
+    const ColumnPlan &column = columns_[*it];
+    if (!IsNull(buf, column)) {
+      uint32_t offset = GetCharOffset(buf, column);
+      uint32_t len = MACH_READ_UINT32(buf + offset);
+      if (len & TypeChar::EXTERNAL_FLAG) {
+        return offset + sizeof(uint32_t) + sizeof(page_id_t);
+      }
+      return offset + sizeof(uint32_t) + ((len & TypeChar::DICTIONARY_FLAG) ? 0 : len);
+    }
+  }
+  return fixed_row_size_;
+}
+
+Field *RowCodec::DeserializeField(char *buf, uint32_t column, MemHeap *heap) const {
+  return DecodeField(buf, columns_[column], heap->Allocate(sizeof(Field)), heap);
+}
+
+Field *RowCodec::DecodeField(char *buf, const ColumnPlan &column, void *slot, MemHeap *heap) {
+  if (IsNull(buf, column)) {
+    return new(slot) Field(column.type_);
+  }
+  switch (column.type_) {
+    case TypeId::kTypeInt:
+      return new(slot) Field(TypeId::kTypeInt, MACH_READ_FROM(int32_t, buf + column.offset_));
+    case TypeId::kTypeFloat:
+      return new(slot) Field(TypeId::kTypeFloat, MACH_READ_FROM(float, buf + column.offset_));
+    case TypeId::kTypeChar:
+      return DecodeChar(buf + GetCharOffset(buf, column), slot, heap);
+    default:
+      ASSERT(false, "Unsupported type.");
+      return nullptr;
+  }
+}
+
+Field *RowCodec::DecodeChar(char *storage, void *slot, MemHeap *heap) {
+  uint32_t len = MACH_READ_UINT32(storage);
+  if (len & TypeChar::EXTERNAL_FLAG) {
+    return new(slot) Field(TypeId::kTypeChar, len & ~TypeChar::EXTERNAL_FLAG,
+                           MACH_READ_INT32(storage + sizeof(uint32_t)));
+  }
+  if (len & TypeChar::DICTIONARY_FLAG) {
+    return new(slot) Field(Field::Encoded(len & ~TypeChar::DICTIONARY_FLAG));
+  }
+  if (len <= Field::INLINE_SIZE) {
+    return new(slot) Field(TypeId::kTypeChar, storage + sizeof(uint32_t), len, true);
+  }
+  auto data = static_cast<char *>(heap->Allocate(len));
+  memcpy(data, storage + sizeof(uint32_t), len);
+  return new(slot) Field(TypeId::kTypeChar, data, len, false);
+}
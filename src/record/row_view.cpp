@@ -0,0 +1,110 @@
+#include "record/row_view.h"
+
+void RowView::Reset(char *data, const RowId &rid) {
+  uint32_t field_nums = MACH_READ_UINT32(data);
+  ASSERT((field_nums & ~Row::ROW_FORMAT_V2) == schema_->GetColumnCount(),
+         "Fields size do not match schema's column size.");
+  data_ = data;
+  pax_page_ = nullptr;
+  rid_ = rid;
+  is_v2_ = (field_nums & Row::ROW_FORMAT_V2) != 0;
+  offsets_.clear();
+  if (!is_v2_) {
+    // in format version 1, the first field follows the field count and the null bitmap
+    offsets_.push_back(sizeof(uint32_t) + (schema_->GetColumnCount() + 7) / 8);
+  }
+}
+
+void RowView::Reset(PaxPage *page, const RowId &rid) {
+  data_ = nullptr;
+  pax_page_ = page;
+  rid_ = rid;
+}
+
+Field RowView::GetField(uint32_t column) const {
+  TypeId type_id = schema_->GetColumn(column)->GetType();
+  if (IsNull(column)) {
+    return Field(type_id);
+  }
+  return Type::GetInstance(type_id)->DeserializeView(GetFieldData(column));
+}
+
+void RowView::GetKeyFields(const std::vector<uint32_t> &key_map, std::vector<Field> &key) const {
+  key.reserve(key.size() + key_map.size());
+  for (auto column : key_map) {
+    key.emplace_back(GetField(column));
+  }
+}
+
+void RowView::Materialize(Row *row) const {
+  row->SetRowId(rid_);
+  if (pax_page_ == nullptr) {
+    row->DeserializeFrom(data_, schema_);
+    return;
+  }
+  ASSERT(row->fields_.empty(), "Non empty field in row.");
+  DeserializeFields(row->fields_, row->heap_);
+}
+
+void RowView::Materialize(Row *row, const std::vector<uint32_t> &columns) const {
+  ASSERT(row->fields_.empty(), "Non empty field in row.");
+  row->SetRowId(rid_);
+  DeserializeFields(columns, row->fields_, row->heap_);
+}
+
+void RowView::DeserializeFields(const std::vector<uint32_t> &columns, std::vector<Field *> &fields,
+                                MemHeap *heap) const {
+  fields.reserve(fields.size() + GetFieldCount());
+  const RowCodec *codec = pax_page_ == nullptr && is_v2_ ? &schema_->GetRowCodec() : nullptr;
+  auto projected = columns.begin();
+  for (uint32_t i = 0; i < GetFieldCount(); i++) {
+    bool is_projected = projected != columns.end() && *projected == i;
+    if (is_projected) {
+      ++projected;
+    }
+    Field *field = nullptr;
+    if (is_projected && codec != nullptr) {
+      field = codec->DeserializeField(data_, i, heap);
+    } else {
+      bool is_null = !is_projected || IsNull(i);
+      Field::DeserializeFrom(is_null ? nullptr : GetFieldData(i), schema_->GetColumn(i)->GetType(),
+                             &field, is_null, heap);
+    }
+    fields.push_back(field);
+  }
+  ASSERT(projected == columns.end(), "Projected columns are not in ascending order.");
+}
+
+void RowView::DeserializeFields(std::vector<Field *> &fields, MemHeap *heap) const {
+  if (pax_page_ == nullptr) {
+    Row::DeserializeFields(data_, schema_, fields, heap);
+    return;
+  }
+  fields.reserve(fields.size() + GetFieldCount());
+  for (uint32_t i = 0; i < GetFieldCount(); i++) {
+    bool is_null = IsNull(i);
+    Field *field = nullptr;
+    Field::DeserializeFrom(is_null ? nullptr : GetFieldData(i), schema_->GetColumn(i)->GetType(), &field, is_null,
+                           heap);
+    fields.push_back(field);
+  }
+}
+
+char *RowView::GetFieldData(uint32_t column) const {
+  if (pax_page_ != nullptr) {
+    return pax_page_->GetFieldData(rid_.GetSlotNum(), column, schema_->GetColumn(column)->GetType());
+  }
+  if (is_v2_) {
+    uint32_t offset = schema_->GetFieldOffset(column);
+    return data_ + (schema_->IsFixedWidth(column) ? offset : MACH_READ_UINT32(data_ + offset));
+  }
+  while (offsets_.size() <= column) {
+    uint32_t i = offsets_.size() - 1;
+    uint32_t offset = offsets_.back();
+    if (!IsNull(i)) {
+      offset += Type::GetInstance(schema_->GetColumn(i)->GetType())->GetSerializedSize(data_ + offset);
+    }
+    offsets_.push_back(offset);
+  }
+  return data_ + offsets_[column];
+}
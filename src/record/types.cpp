@@ -2,18 +2,6 @@
 #include "record/types.h"
 #include "record/field.h"
 
-inline int CompareStrings(const char *str1, int len1, const char *str2, int len2) {
-  assert(str1 != nullptr);
-  assert(len1 >= 0);
-  assert(str2 != nullptr);
-  assert(len2 >= 0);
-  int ret = memcmp(str1, str2, static_cast<size_t>(std::min(len1, len2)));
-  if (ret == 0 && len1 != len2) {
-    ret = len1 - len2;
-  }
-  return ret;
-}
-
 // ==============================Type=============================
 
 Type *Type::type_singletons_[] = {
@@ -38,6 +26,16 @@ uint32_t Type::GetSerializedSize(const Field &field, bool is_null) const {
   return 0;
 }
 
+Field Type::DeserializeView(char *storage) const {
+  ASSERT(false, "DeserializeView not implemented.");
+  return Field(type_id_);
+}
+
+uint32_t Type::GetSerializedSize(const char *storage) const {
+  ASSERT(false, "GetSerializedSize not implemented.");
+  return 0;
+}
+
 const char *Type::GetData(const Field &val) const {
   ASSERT(false, "GetData not implemented.");
   return nullptr;
@@ -105,6 +103,14 @@ uint32_t TypeInt::GetSerializedSize(const Field &field, bool is_null) const {
   return GetTypeSize(type_id_);
 }
 
+Field TypeInt::DeserializeView(char *storage) const {
+  return Field(TypeId::kTypeInt, MACH_READ_INT32(storage));
+}
+
+uint32_t TypeInt::GetSerializedSize(const char *storage) const {
+  return GetTypeSize(type_id_);
+}
+
 CmpBool TypeInt::CompareEquals(const Field &left, const Field &right) const {
   ASSERT(left.CheckComparable(right), "Not comparable.");
   if (left.IsNull() || right.IsNull()) {
@@ -180,6 +186,14 @@ uint32_t TypeFloat::GetSerializedSize(const Field &field, bool is_null) const {
   return GetTypeSize(type_id_);
 }
 
+Field TypeFloat::DeserializeView(char *storage) const {
+  return Field(TypeId::kTypeFloat, MACH_READ_FROM(float, storage));
+}
+
+uint32_t TypeFloat::GetSerializedSize(const char *storage) const {
+  return GetTypeSize(type_id_);
+}
+
 CmpBool TypeFloat::CompareEquals(const Field &left, const Field &right) const {
   ASSERT(left.CheckComparable(right), "Not comparable.");
   if (left.IsNull() || right.IsNull()) {
@@ -232,8 +246,17 @@ CmpBool TypeFloat::CompareGreaterThanEquals(const Field &left, const Field &righ
 uint32_t TypeChar::SerializeTo(const Field &field, char *buf) const {
   if (!field.IsNull()) {
     uint32_t len = GetLength(field);
+    if (field.IsEncoded()) {
+      MACH_WRITE_UINT32(buf, field.GetCode() | DICTIONARY_FLAG);
+      return sizeof(uint32_t);
+    }
+    if (field.IsExternal()) {
+      MACH_WRITE_UINT32(buf, len | EXTERNAL_FLAG);
+      MACH_WRITE_INT32(buf + sizeof(uint32_t), field.GetExternalPageId());
+      return sizeof(uint32_t) + sizeof(page_id_t);
+    }
     memcpy(buf, &len, sizeof(uint32_t));
-    memcpy(buf + sizeof(uint32_t), field.value_.chars_, len);
+    memcpy(buf + sizeof(uint32_t), field.GetChars(), len);
     return len + sizeof(uint32_t);
   }
   return 0;
@@ -245,7 +268,23 @@ uint32_t TypeChar::DeserializeFrom(char *storage, Field **field, bool is_null, M
     return 0;
   }
   uint32_t len = MACH_READ_UINT32(storage);
-  *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, storage + sizeof(uint32_t), len, true);
+  if (len & EXTERNAL_FLAG) {
+    page_id_t external_page_id = MACH_READ_INT32(storage + sizeof(uint32_t));
+    *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, len & ~EXTERNAL_FLAG, external_page_id);
+    return sizeof(uint32_t) + sizeof(page_id_t);
+  }
+  if (len & DICTIONARY_FLAG) {
+    *field = ALLOC_P(heap, Field)(Field::Encoded(len & ~DICTIONARY_FLAG));
+    return sizeof(uint32_t);
+  }
+  if (len <= Field::INLINE_SIZE) {
+    *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, storage + sizeof(uint32_t), len, true);
+    return len + sizeof(uint32_t);
+  }
+  // a longer value is copied into the heap of the field, so that it is released with the heap
+  auto data = static_cast<char *>(heap->Allocate(len));
+  memcpy(data, storage + sizeof(uint32_t), len);
+  *field = ALLOC_P(heap, Field)(TypeId::kTypeChar, data, len, false);
   return len + sizeof(uint32_t);
 }
 
@@ -253,12 +292,41 @@ uint32_t TypeChar::GetSerializedSize(const Field &field, bool is_null) const {
   if (is_null) {
     return 0;
   }
+  if (field.IsEncoded()) {
+    return sizeof(uint32_t);
+  }
+  if (field.IsExternal()) {
+    return sizeof(uint32_t) + sizeof(page_id_t);
+  }
   uint32_t len = GetLength(field);
   return len + sizeof(uint32_t);
 }
 
+Field TypeChar::DeserializeView(char *storage) const {
+  uint32_t len = MACH_READ_UINT32(storage);
+  if (len & EXTERNAL_FLAG) {
+    return Field(TypeId::kTypeChar, len & ~EXTERNAL_FLAG, MACH_READ_INT32(storage + sizeof(uint32_t)));
+  }
+  if (len & DICTIONARY_FLAG) {
+    return Field::Encoded(len & ~DICTIONARY_FLAG);
+  }
+  return Field(TypeId::kTypeChar, storage + sizeof(uint32_t), len, false);
+}
+
+uint32_t TypeChar::GetSerializedSize(const char *storage) const {
+  uint32_t len = MACH_READ_UINT32(storage);
+  if (len & EXTERNAL_FLAG) {
+    return sizeof(uint32_t) + sizeof(page_id_t);
+  }
+  if (len & DICTIONARY_FLAG) {
+    return sizeof(uint32_t);
+  }
+  return len + sizeof(uint32_t);
+}
+
 const char *TypeChar::GetData(const Field &val) const {
-  return val.value_.chars_;
+  ASSERT(val.IsFetched(), "Value stored out of line is not fetched.");
+  return val.GetChars();
 }
 
 uint32_t TypeChar::GetLength(const Field &val) const {
@@ -270,7 +338,8 @@ CmpBool TypeChar::CompareEquals(const Field &left, const Field &right) const {
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) == 0);
+  // values of different lengths differ without comparing their bytes
+  return GetCmpBool(left.len_ == right.len_ && left.CompareAs<TypeId::kTypeChar>(right) == 0);
 }
 
 CmpBool TypeChar::CompareNotEquals(const Field &left, const Field &right) const {
@@ -278,7 +347,7 @@ CmpBool TypeChar::CompareNotEquals(const Field &left, const Field &right) const
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) != 0);
+  return GetCmpBool(left.len_ != right.len_ || left.CompareAs<TypeId::kTypeChar>(right) != 0);
 }
 
 CmpBool TypeChar::CompareLessThan(const Field &left, const Field &right) const {
@@ -286,7 +355,7 @@ CmpBool TypeChar::CompareLessThan(const Field &left, const Field &right) const {
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) < 0);
+  return GetCmpBool(left.CompareAs<TypeId::kTypeChar>(right) < 0);
 }
 
 CmpBool TypeChar::CompareLessThanEquals(const Field &left, const Field &right) const {
@@ -294,7 +363,7 @@ CmpBool TypeChar::CompareLessThanEquals(const Field &left, const Field &right) c
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) <= 0);
+  return GetCmpBool(left.CompareAs<TypeId::kTypeChar>(right) <= 0);
 }
 
 CmpBool TypeChar::CompareGreaterThan(const Field &left, const Field &right) const {
@@ -302,7 +371,7 @@ CmpBool TypeChar::CompareGreaterThan(const Field &left, const Field &right) cons
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) > 0);
+  return GetCmpBool(left.CompareAs<TypeId::kTypeChar>(right) > 0);
 }
 
 CmpBool TypeChar::CompareGreaterThanEquals(const Field &left, const Field &right) const {
@@ -310,5 +379,5 @@ CmpBool TypeChar::CompareGreaterThanEquals(const Field &left, const Field &right
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::kNull;
   }
-  return GetCmpBool(CompareStrings(left.GetData(), left.GetLength(), right.GetData(), right.GetLength()) >= 0);
+  return GetCmpBool(left.CompareAs<TypeId::kTypeChar>(right) >= 0);
 }
\ No newline at end of file
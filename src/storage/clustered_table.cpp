@@ -0,0 +1,391 @@
+#include <cstring>
+
+#include "page/overflow_page.h"
+#include "storage/clustered_table.h"
+
+using ClusteredKey = GenericKey<CLUSTERED_KEY_SIZE>;
+using ClusteredRow = GenericKey<CLUSTERED_ROW_SIZE>;
+
+/** Bytes of a row stored in its slot, after the size of the row */
+static constexpr uint32_t SLOT_DATA_SIZE = CLUSTERED_ROW_SIZE - sizeof(uint32_t);
+
+/**
+ * Max sizes of the pages of a tree, one entry is left for the split as in LEAF_PAGE_SIZE_OF and
+ * INTERNAL_PAGE_SIZE_OF
+ */
+template<typename KeyType, typename ValueType>
+static int LeafMaxSize(BufferPoolManager *buffer_pool_manager) {
+  return static_cast<int>((buffer_pool_manager->GetPageSize() - LEAF_PAGE_HEADER_SIZE) /
+                          sizeof(std::pair<KeyType, ValueType>)) - 1;
+}
+
+template<typename KeyType>
+static int InternalMaxSize(BufferPoolManager *buffer_pool_manager) {
+  return static_cast<int>((buffer_pool_manager->GetPageSize() - INTERNAL_PAGE_HEADER_SIZE) /
+                          sizeof(std::pair<KeyType, page_id_t>)) - 1;
+}
+
+ClusteredTable::ClusteredTable(BufferPoolManager *buffer_pool_manager, index_id_t index_id, Schema *schema,
+                               std::vector<uint32_t> key_map, LogManager *log_manager, LockManager *lock_manager,
+                               MemHeap *heap)
+        : buffer_pool_manager_(buffer_pool_manager),
+          schema_(schema),
+          key_map_(std::move(key_map)),
+          key_schema_(Schema::ShallowCopySchema(schema, key_map_, heap)),
+          comparator_(key_schema_),
+          tree_(index_id, buffer_pool_manager, comparator_,
+                LeafMaxSize<ClusteredKey, ClusteredRow>(buffer_pool_manager),
+                InternalMaxSize<ClusteredKey>(buffer_pool_manager)),
+          heap_(heap),
+          log_manager_(log_manager),
+          lock_manager_(lock_manager) {}
+
+ClusteredTable::~ClusteredTable() {
+  for (auto &index : secondary_indexes_) {
+    index.key_schema_->~Schema();
+  }
+  key_schema_->~Schema();
+}
+
+bool ClusteredTable::CreateSecondaryIndex(index_id_t index_id, std::vector<uint32_t> key_map, Transaction *txn) {
+  Schema *key_schema = Schema::ShallowCopySchema(schema_, key_map, heap_);
+  SecondaryTree tree(index_id, buffer_pool_manager_, GenericComparator<CLUSTERED_KEY_SIZE>(key_schema),
+                     LeafMaxSize<ClusteredKey, ClusteredKey>(buffer_pool_manager_),
+                     InternalMaxSize<ClusteredKey>(buffer_pool_manager_));
+  latch_.WLock();
+  bool created = true;
+  if (tree.IsEmpty()) {
+    RowView view(schema_);
+    ClusteredKey key;
+    std::vector<char> buffer;
+    for (auto iter = tree_.Begin(); created && iter != tree_.End(); ++iter) {
+      view.Reset(ReadSlot((*iter).second, buffer), INVALID_ROWID);
+      created = SerializeKey(view, key_map, key_schema, &key) && tree.Insert(key, (*iter).first, txn);
+    }
+  }
+  if (created) {
+    secondary_indexes_.push_back(SecondaryIndex{std::move(key_map), key_schema, tree});
+  } else {
+    tree.Destroy();
+    key_schema->~Schema();
+  }
+  latch_.WUnlock();
+  return created;
+}
+
+bool ClusteredTable::InsertTuple(const Row &row, Transaction *txn) {
+  std::vector<char> data(row.GetSerializedSize(schema_));
+  row.SerializeTo(data.data(), schema_);
+  RowView view(data.data(), INVALID_ROWID, schema_);
+  ClusteredKey key;
+  if (!SerializeKey(view, key_map_, key_schema_, &key)) {
+    return false;
+  }
+  latch_.WLock();
+  std::vector<ClusteredKey> secondary_keys;
+  std::vector<ClusteredRow> old_slots;
+  ClusteredRow slot;
+  bool inserted = !tree_.GetValue(key, old_slots, txn) && SerializeSecondaryKeys(view, key, &secondary_keys, txn) &&
+                  WriteSlot(data, &slot);
+  if (inserted) {
+    tree_.Insert(key, slot, txn);
+    for (size_t i = 0; i < secondary_indexes_.size(); i++) {
+      secondary_indexes_[i].tree_.Insert(secondary_keys[i], key, txn);
+    }
+  }
+  latch_.WUnlock();
+  return inserted;
+}
+
+bool ClusteredTable::GetTuple(const Row &key, Row *row, Transaction *txn) {
+  ClusteredKey index_key;
+  if (!SerializeKey(key, key_schema_, &index_key)) {
+    return false;
+  }
+  latch_.RLock();
+  std::vector<ClusteredRow> slots;
+  bool found = tree_.GetValue(index_key, slots, txn);
+  if (found) {
+    std::vector<char> buffer;
+    row->DeserializeFrom(ReadSlot(slots[0], buffer), schema_);
+  }
+  latch_.RUnlock();
+  return found;
+}
+
+bool ClusteredTable::GetTupleBySecondaryKey(uint32_t index, const Row &key, Row *row, Transaction *txn) {
+  ASSERT(index < secondary_indexes_.size(), "Invalid secondary index.");
+  SecondaryIndex &secondary_index = secondary_indexes_[index];
+  ClusteredKey index_key;
+  if (!SerializeKey(key, secondary_index.key_schema_, &index_key)) {
+    return false;
+  }
+  latch_.RLock();
+  std::vector<ClusteredKey> primary_keys;
+  std::vector<ClusteredRow> slots;
+  bool found = secondary_index.tree_.GetValue(index_key, primary_keys, txn) &&
+               tree_.GetValue(primary_keys[0], slots, txn);
+  if (found) {
+    std::vector<char> buffer;
+    row->DeserializeFrom(ReadSlot(slots[0], buffer), schema_);
+  }
+  latch_.RUnlock();
+  return found;
+}
+
+bool ClusteredTable::UpdateTuple(const Row &row, Transaction *txn) {
+  std::vector<char> data(row.GetSerializedSize(schema_));
+  row.SerializeTo(data.data(), schema_);
+  RowView view(data.data(), INVALID_ROWID, schema_);
+  ClusteredKey key;
+  if (!SerializeKey(view, key_map_, key_schema_, &key)) {
+    return false;
+  }
+  latch_.WLock();
+  std::vector<ClusteredKey> secondary_keys;
+  std::vector<ClusteredRow> old_slots;
+  ClusteredRow slot;
+  bool updated = tree_.GetValue(key, old_slots, txn) && SerializeSecondaryKeys(view, key, &secondary_keys, txn) &&
+                 WriteSlot(data, &slot);
+  if (updated) {
+    std::vector<char> old_buffer;
+    RowView old_view(ReadSlot(old_slots[0], old_buffer), INVALID_ROWID, schema_);
+    ClusteredKey old_key;
+    for (size_t i = 0; i < secondary_indexes_.size(); i++) {
+      SecondaryIndex &index = secondary_indexes_[i];
+      SerializeKey(old_view, index.key_map_, index.key_schema_, &old_key);
+      if (!(old_key == secondary_keys[i])) {
+        index.tree_.Remove(old_key, txn);
+        index.tree_.Insert(secondary_keys[i], key, txn);
+      }
+    }
+    // the key is the same, so the row is replaced in its slot without restructuring the tree
+    tree_.Update(key, slot, txn);
+    FreeSlot(old_slots[0]);
+  }
+  latch_.WUnlock();
+  return updated;
+}
+
+bool ClusteredTable::DeleteTuple(const Row &key, Transaction *txn) {
+  ClusteredKey index_key;
+  if (!SerializeKey(key, key_schema_, &index_key)) {
+    return false;
+  }
+  latch_.WLock();
+  std::vector<ClusteredRow> slots;
+  bool found = tree_.GetValue(index_key, slots, txn);
+  if (found) {
+    std::vector<char> buffer;
+    RowView view(ReadSlot(slots[0], buffer), INVALID_ROWID, schema_);
+    ClusteredKey secondary_key;
+    for (auto &index : secondary_indexes_) {
+      SerializeKey(view, index.key_map_, index.key_schema_, &secondary_key);
+      index.tree_.Remove(secondary_key, txn);
+    }
+    tree_.Remove(index_key, txn);
+    FreeSlot(slots[0]);
+  }
+  latch_.WUnlock();
+  return found;
+}
+
+void ClusteredTable::Scan(const Row *begin_key, const Row *end_key, const Consumer &consumer, Transaction *txn) {
+  ClusteredKey begin_index_key;
+  ClusteredKey end_index_key;
+  if ((begin_key != nullptr && !SerializeKey(*begin_key, key_schema_, &begin_index_key)) ||
+      (end_key != nullptr && !SerializeKey(*end_key, key_schema_, &end_index_key))) {
+    return;
+  }
+  latch_.RLock();
+  {
+    RowView view(schema_);
+    std::vector<char> buffer;
+    // the leaves are read in key order, following their links
+    auto iter = begin_key != nullptr ? tree_.Begin(begin_index_key) : tree_.Begin();
+    for (; iter != tree_.End(); ++iter) {
+      if (end_key != nullptr && comparator_((*iter).first, end_index_key) >= 0) {
+        break;
+      }
+      view.Reset(ReadSlot((*iter).second, buffer), INVALID_ROWID);
+      if (!consumer(view)) {
+        break;
+      }
+    }
+  }
+  latch_.RUnlock();
+}
+
+void ClusteredTable::FreeTable() {
+  latch_.WLock();
+  for (auto iter = tree_.Begin(); iter != tree_.End(); ++iter) {
+    FreeSlot((*iter).second);
+  }
+  tree_.Destroy();
+  for (auto &index : secondary_indexes_) {
+    index.tree_.Destroy();
+  }
+  latch_.WUnlock();
+}
+
+size_t ClusteredTable::GetPageCount() {
+  latch_.RLock();
+  size_t page_count = 0;
+  Page *page = tree_.FindLeafPage(ClusteredKey{}, true);
+  while (page != nullptr) {
+    page_count++;
+    page_id_t page_id = page->GetPageId();
+    page_id_t next_page_id =
+            reinterpret_cast<BPlusTreeLeafPage<ClusteredKey, ClusteredRow, GenericComparator<CLUSTERED_KEY_SIZE>> *>(
+                    page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page = next_page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(next_page_id);
+  }
+  latch_.RUnlock();
+  return page_count;
+}
+
+bool ClusteredTable::SerializeKey(const Row &key, Schema *key_schema, ClusteredKey *index_key) {
+  if (key.GetFieldCount() != key_schema->GetColumnCount()) {
+    return false;
+  }
+  for (auto field : key.GetFields()) {
+    if (field->IsNull()) {
+      return false;
+    }
+  }
+  if (key.GetSerializedSize(key_schema) > CLUSTERED_KEY_SIZE) {
+    return false;
+  }
+  index_key->SerializeFromKey(key, key_schema);
+  return true;
+}
+
+bool ClusteredTable::SerializeKey(const RowView &row, const std::vector<uint32_t> &key_map, Schema *key_schema,
+                                  ClusteredKey *index_key) {
+  for (auto column : key_map) {
+    if (row.IsNull(column)) {
+      return false;
+    }
+  }
+  std::vector<Field> fields;
+  row.GetKeyFields(key_map, fields);
+  Row key(fields);
+  return SerializeKey(key, key_schema, index_key);
+}
+
+bool ClusteredTable::SerializeSecondaryKeys(const RowView &row, const ClusteredKey &primary_key,
+                                            std::vector<ClusteredKey> *keys, Transaction *txn) {
+  keys->resize(secondary_indexes_.size());
+  std::vector<ClusteredKey> primary_keys;
+  for (size_t i = 0; i < secondary_indexes_.size(); i++) {
+    SecondaryIndex &index = secondary_indexes_[i];
+    if (!SerializeKey(row, index.key_map_, index.key_schema_, &(*keys)[i])) {
+      return false;
+    }
+    primary_keys.clear();
+    if (index.tree_.GetValue((*keys)[i], primary_keys, txn) && comparator_(primary_keys[0], primary_key) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool ClusteredTable::WriteSlot(const std::vector<char> &data, ClusteredRow *slot) {
+  auto size = static_cast<uint32_t>(data.size());
+  memset(slot->data, 0, CLUSTERED_ROW_SIZE);
+  memcpy(slot->data, &size, sizeof(uint32_t));
+  if (size <= SLOT_DATA_SIZE) {
+    memcpy(slot->data + sizeof(uint32_t), data.data(), size);
+    return true;
+  }
+  page_id_t page_id = WriteOverflowPages(data.data(), size);
+  memcpy(slot->data + sizeof(uint32_t), &page_id, sizeof(page_id_t));
+  return page_id != INVALID_PAGE_ID;
+}
+
+char *ClusteredTable::ReadSlot(const ClusteredRow &slot, std::vector<char> &buffer) {
+  uint32_t size;
+  memcpy(&size, slot.data, sizeof(uint32_t));
+  if (size <= SLOT_DATA_SIZE) {
+    return const_cast<char *>(slot.data) + sizeof(uint32_t);
+  }
+  page_id_t page_id;
+  memcpy(&page_id, slot.data + sizeof(uint32_t), sizeof(page_id_t));
+  buffer.resize(size);
+  uint32_t offset = 0;
+  while (page_id != INVALID_PAGE_ID && offset < size) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch overflow page.");
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    memcpy(buffer.data() + offset, overflow_page->GetData(), overflow_page->GetDataSize());
+    offset += overflow_page->GetDataSize();
+    page_id_t next_page_id = overflow_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  return buffer.data();
+}
+
+void ClusteredTable::FreeSlot(const ClusteredRow &slot) {
+  uint32_t size;
+  memcpy(&size, slot.data, sizeof(uint32_t));
+  if (size <= SLOT_DATA_SIZE) {
+    return;
+  }
+  page_id_t page_id;
+  memcpy(&page_id, slot.data + sizeof(uint32_t), sizeof(page_id_t));
+  FreeOverflowPages(page_id);
+}
+
+page_id_t ClusteredTable::WriteOverflowPages(const char *data, uint32_t len) {
+  uint32_t max_data_size = OverflowPage::GetMaxDataSize(buffer_pool_manager_->GetPageSize());
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  uint32_t offset = 0;
+  while (offset < len) {
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(page_id);
+    if (page == nullptr) {
+      break;
+    }
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    overflow_page->Init();
+    uint32_t size = std::min(max_data_size, len - offset);
+    memcpy(overflow_page->GetData(), data + offset, size);
+    overflow_page->SetDataSize(size);
+    offset += size;
+    if (prev_page == nullptr) {
+      first_page_id = page_id;
+    } else {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    }
+    prev_page = overflow_page;
+    prev_page_id = page_id;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  }
+  if (offset < len) {
+    FreeOverflowPages(first_page_id);
+    return INVALID_PAGE_ID;
+  }
+  return first_page_id;
+}
+
+void ClusteredTable::FreeOverflowPages(page_id_t page_id) {
+  std::vector<page_id_t> page_ids;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      break;
+    }
+    page_id_t next_page_id = reinterpret_cast<OverflowPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_ids.push_back(page_id);
+    page_id = next_page_id;
+  }
+  buffer_pool_manager_->DeletePages(page_ids);
+}
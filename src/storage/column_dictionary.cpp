@@ -0,0 +1,113 @@
+#include <cstring>
+
+#include "storage/column_dictionary.h"
+
+page_id_t ColumnDictionary::Create(file_id_t file_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_id_t page_id;
+  auto page = buffer_pool_manager_->NewPage(page_id, file_id);
+  ASSERT(page != nullptr, "Failed to allocate dictionary page.");
+  reinterpret_cast<DictionaryPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  page_ids_ = {page_id};
+  Clear();
+  return page_id;
+}
+
+void ColumnDictionary::Open(page_id_t first_page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_ids_.clear();
+  Clear();
+  for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch dictionary page.");
+    auto dictionary_page = reinterpret_cast<DictionaryPage *>(page->GetData());
+    for (uint32_t i = 0; i < dictionary_page->GetEntryCount(); i++) {
+      AddValue(std::string(dictionary_page->GetValue(i), dictionary_page->GetLength(i)));
+    }
+    page_ids_.push_back(page_id);
+    page_id_t next_page_id = dictionary_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+}
+
+void ColumnDictionary::Free() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  buffer_pool_manager_->DeletePages(page_ids_);
+  page_ids_.clear();
+  Clear();
+}
+
+uint32_t ColumnDictionary::Encode(const char *data, uint32_t len) {
+  if (len > MAX_VALUE_LENGTH) {
+    return INVALID_CODE;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  std::string value(data, len);
+  auto iter = codes_.find(value);
+  if (iter != codes_.end()) {
+    return iter->second;
+  }
+  uint32_t code = size_.load(std::memory_order_relaxed);
+  if (code == MAX_SIZE) {
+    return INVALID_CODE;
+  }
+  Persist(value);
+  AddValue(value);
+  return code;
+}
+
+uint32_t ColumnDictionary::Lookup(const char *data, uint32_t len) {
+  if (len > MAX_VALUE_LENGTH) {
+    return INVALID_CODE;
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto iter = codes_.find(std::string(data, len));
+  return iter == codes_.end() ? INVALID_CODE : iter->second;
+}
+
+void ColumnDictionary::Persist(const std::string &value) {
+  ASSERT(!page_ids_.empty(), "Dictionary is not created.");
+  uint32_t page_index = size_.load(std::memory_order_relaxed) / entries_per_page_;
+  if (page_index == page_ids_.size()) {
+    // chain a new dictionary page after the last one
+    page_id_t prev_page_id = page_ids_.back();
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(page_id, GetFileId(prev_page_id));
+    ASSERT(page != nullptr, "Failed to allocate dictionary page.");
+    reinterpret_cast<DictionaryPage *>(page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    auto prev_page = buffer_pool_manager_->FetchPage(prev_page_id);
+    reinterpret_cast<DictionaryPage *>(prev_page->GetData())->SetNextPageId(page_id);
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    page_ids_.push_back(page_id);
+  }
+  page_id_t page_id = page_ids_[page_index];
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  ASSERT(page != nullptr, "Failed to fetch dictionary page.");
+  reinterpret_cast<DictionaryPage *>(page->GetData())->Append(value.data(), value.size());
+  buffer_pool_manager_->UnpinPage(page_id, true);
+}
+
+void ColumnDictionary::AddValue(const std::string &value) {
+  uint32_t code = size_.load(std::memory_order_relaxed);
+  auto &chunk = chunks_[code / CHUNK_SIZE];
+  if (chunk == nullptr) {
+    chunk = std::make_unique<Entry[]>(CHUNK_SIZE);
+  }
+  Entry &entry = chunk[code % CHUNK_SIZE];
+  entry.len_ = value.size();
+  memcpy(entry.data_, value.data(), value.size());
+  codes_.emplace(value, code);
+  // readers see the value once they see the size
+  size_.store(code + 1, std::memory_order_release);
+}
+
+void ColumnDictionary::Clear() {
+  for (auto &chunk : chunks_) {
+    chunk.reset();
+  }
+  size_.store(0, std::memory_order_release);
+  codes_.clear();
+}
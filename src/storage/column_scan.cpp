@@ -0,0 +1,101 @@
+#include "storage/column_scan.h"
+
+Field ColumnBatch::GetField(size_t row, uint32_t i) const {
+  const ColumnVector &vector = vectors_[i];
+  if (IsNull(row, i)) {
+    return Field(vector.type_);
+  }
+  if (vector.type_ == TypeId::kTypeChar) {
+    return Type::GetInstance(vector.type_)->DeserializeView(
+            page_data_ + reinterpret_cast<const uint32_t *>(vector.values_)[row]);
+  }
+  return Type::GetInstance(vector.type_)->DeserializeView(
+          const_cast<char *>(vector.values_) + row * Type::GetTypeSize(vector.type_));
+}
+
+ColumnScan::ColumnScan(TableHeap *table_heap, std::vector<uint32_t> columns)
+        : table_heap_(table_heap), columns_(std::move(columns)) {}
+
+void ColumnScan::Scan(const Consumer &consumer, Transaction *txn) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  ColumnBatch batch;
+  batch.vectors_.resize(columns_.size());
+  for (size_t i = 0; i < columns_.size(); i++) {
+    batch.vectors_[i].type_ = table_heap_->schema_->GetColumn(columns_[i])->GetType();
+  }
+  // the next page may be unlinked once the current one is unpinned, it is kept until the scan ends
+  uint64_t epoch = table_heap_->EnterEpoch();
+  page_id_t page_id = table_heap_->GetFirstPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch table page.");
+    page->RLatch();
+    batch.page_id_ = page_id;
+    batch.page_data_ = page->GetData();
+    page_id_t next_page_id = table_heap_->VisitPage(page, [this, &batch](auto table_page) {
+      ReadPage(table_page, batch);
+      return table_page->GetNextPageId();
+    });
+    if (batch.row_count_ > 0) {
+      consumer(batch);
+    }
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  table_heap_->ExitEpoch(epoch);
+}
+
+void ColumnScan::ReadPage(PaxPage *page, ColumnBatch &batch) {
+  batch.row_count_ = page->GetTupleCount();
+  uint32_t bitmap_size = PaxPage::GetBitmapSize(batch.row_count_);
+  batch.selection_.resize(bitmap_size);
+  batch.rids_.clear();
+  const char *used = page->GetUsedBitmap();
+  const char *deleted = page->GetDeletedBitmap();
+  for (uint32_t i = 0; i < bitmap_size; i++) {
+    batch.selection_[i] = used[i] & ~deleted[i];
+  }
+  for (size_t i = 0; i < columns_.size(); i++) {
+    batch.vectors_[i].nulls_ = page->GetNullBitmap(columns_[i]);
+    batch.vectors_[i].values_ = page->GetColumnValues(columns_[i]);
+  }
+}
+
+void ColumnScan::ReadPage(TablePage *page, ColumnBatch &batch) {
+  batch.row_count_ = page->GetTupleCount();
+  uint32_t bitmap_size = PaxPage::GetBitmapSize(batch.row_count_);
+  batch.selection_.assign(bitmap_size, 0);
+  batch.rids_.resize(batch.row_count_);
+  for (auto &vector : batch.vectors_) {
+    // char values are left in the page, their offsets are copied like the values of other columns
+    uint32_t value_size = vector.type_ == TypeId::kTypeChar ? sizeof(uint32_t) : Type::GetTypeSize(vector.type_);
+    vector.null_buffer_.assign(bitmap_size, 0);
+    vector.value_buffer_.resize(batch.row_count_ * value_size);
+    vector.nulls_ = vector.null_buffer_.data();
+    vector.values_ = vector.value_buffer_.data();
+  }
+  RowView row(table_heap_->schema_);
+  for (uint32_t slot = 0; slot < batch.row_count_; slot++) {
+    RowId rid(batch.page_id_, slot);
+    if (!page->GetTupleView(rid, row)) {
+      continue;
+    }
+    batch.selection_[slot / 8] |= static_cast<char>(1 << (slot % 8));
+    batch.rids_[slot] = row.GetRowId();
+    for (size_t i = 0; i < columns_.size(); i++) {
+      auto &vector = batch.vectors_[i];
+      if (row.IsNull(columns_[i])) {
+        vector.null_buffer_[slot / 8] |= static_cast<char>(1 << (slot % 8));
+        continue;
+      }
+      char *data = row.GetFieldData(columns_[i]);
+      if (vector.type_ == TypeId::kTypeChar) {
+        reinterpret_cast<uint32_t *>(vector.value_buffer_.data())[slot] = data - batch.page_data_;
+      } else {
+        uint32_t value_size = Type::GetTypeSize(vector.type_);
+        memcpy(vector.value_buffer_.data() + slot * value_size, data, value_size);
+      }
+    }
+  }
+}
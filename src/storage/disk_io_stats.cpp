@@ -0,0 +1,99 @@
+#include <fstream>
+#include <iomanip>
+
+#include "storage/disk_io_stats.h"
+
+void LatencyHistogram::Record(uint64_t latency_ns) {
+  buckets_[GetBucketIndex(latency_ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  total_ns_.fetch_add(latency_ns, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double quantile) const {
+  uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+  // rank of the quantile, rounded up so that p100 is the max
+  auto rank = static_cast<uint64_t>(quantile * count);
+  if (rank < quantile * count || rank == 0) {
+    rank++;
+  }
+  uint64_t seen = 0;
+  for (uint32_t i = 0; i < BUCKET_NUM; i++) {
+    seen += buckets_[i].load(std::memory_order_relaxed);
+    if (seen >= rank) {
+      return GetBucketUpperBound(i);
+    }
+  }
+  return GetBucketUpperBound(BUCKET_NUM - 1);
+}
+
+void LatencyHistogram::Reset() {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
+  count_.store(0, std::memory_order_relaxed);
+  total_ns_.store(0, std::memory_order_relaxed);
+}
+
+uint32_t LatencyHistogram::GetBucketIndex(uint64_t latency_ns) {
+  if (latency_ns < 4) {
+    return static_cast<uint32_t>(latency_ns);
+  }
+  // bucket of [2^msb, 2^(msb+1)) is chosen by the highest bit, the sub bucket by the next two bits
+  uint32_t msb = 63 - __builtin_clzll(latency_ns);
+  uint32_t sub = (latency_ns >> (msb - 2)) & 3;
+  uint32_t index = (msb - 1) * 4 + sub;
+  return index < BUCKET_NUM ? index : BUCKET_NUM - 1;
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(uint32_t index) {
+  if (index < 4) {
+    return index;
+  }
+  uint32_t msb = index / 4 + 1;
+  uint64_t sub = index % 4;
+  return ((4 + sub + 1) << (msb - 2)) - 1;
+}
+
+void DiskIOStats::Dump(std::ostream &os) const {
+  static const char *page_type_names[PAGE_TYPE_NUM] = {"meta", "bitmap", "data"};
+  static const char *io_type_names[IO_TYPE_NUM] = {"read", "write"};
+  os << std::left << std::setw(8) << "page" << std::setw(7) << "io" << std::right
+     << std::setw(12) << "ops" << std::setw(16) << "bytes" << std::setw(12) << "MB/s"
+     << std::setw(12) << "p50(us)" << std::setw(12) << "p99(us)" << std::setw(12) << "p999(us)" << std::endl;
+  for (uint32_t i = 0; i < PAGE_TYPE_NUM; i++) {
+    for (uint32_t j = 0; j < IO_TYPE_NUM; j++) {
+      const IOCounter &counter = counters_[i][j];
+      uint64_t bytes = counter.bytes_.load(std::memory_order_relaxed);
+      uint64_t total_ns = counter.latency_.GetTotalLatency();
+      // throughput of the time spent in I/O, bytes per nanosecond is 1000 MB/s
+      double throughput = total_ns == 0 ? 0 : 1000.0 * bytes / total_ns;
+      os << std::left << std::setw(8) << page_type_names[i] << std::setw(7) << io_type_names[j] << std::right
+         << std::setw(12) << counter.latency_.GetCount() << std::setw(16) << bytes
+         << std::setw(12) << std::fixed << std::setprecision(1) << throughput
+         << std::setw(12) << std::setprecision(1) << counter.latency_.GetPercentile(0.5) / 1000.0
+         << std::setw(12) << counter.latency_.GetPercentile(0.99) / 1000.0
+         << std::setw(12) << counter.latency_.GetPercentile(0.999) / 1000.0 << std::endl;
+    }
+  }
+}
+
+bool DiskIOStats::DumpToFile(const std::string &file_name) const {
+  std::ofstream out(file_name, std::ios::app);
+  if (!out.is_open()) {
+    return false;
+  }
+  Dump(out);
+  return out.good();
+}
+
+void DiskIOStats::Reset() {
+  for (auto &page_counters : counters_) {
+    for (auto &counter : page_counters) {
+      counter.bytes_.store(0, std::memory_order_relaxed);
+      counter.latency_.Reset();
+    }
+  }
+}
@@ -1,11 +1,32 @@
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
 #include <sys/stat.h>
+#include <type_traits>
 
 #include "glog/logging.h"
 #include "page/bitmap_page.h"
 #include "storage/disk_manager.h"
 
-DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
+/**
+ * Bitmap page layout is a template of page size, dispatch to the instance matching the page size of the file.
+ */
+template<typename Func>
+static auto WithBitmapPage(uint32_t page_size, char *data, Func &&func) {
+  switch (page_size) {
+    case 8192:
+      return func(reinterpret_cast<BitmapPage<8192> *>(data));
+    case 16384:
+      return func(reinterpret_cast<BitmapPage<16384> *>(data));
+    case 32768:
+      return func(reinterpret_cast<BitmapPage<32768> *>(data));
+    default:
+      ASSERT(page_size == 4096, "Unsupported page size.");
+      return func(reinterpret_cast<BitmapPage<4096> *>(data));
+  }
+}
+
+DiskManager::DiskManager(const std::string &db_file, uint32_t page_size) : file_name_(db_file) {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
@@ -20,12 +41,29 @@ DiskManager::DiskManager(const std::string &db_file) : file_name_(db_file) {
       throw std::exception();
     }
   }
+  // an existing file keeps the page size it was created with
+  uint32_t recorded_page_size = ReadRecordedPageSize();
+  page_size_ = recorded_page_size != 0 ? recorded_page_size : page_size;
+  if (!IsValidPageSize(page_size_)) {
+    LOG(ERROR) << "Invalid page size " << page_size_ << " of file " << db_file;
+    throw std::exception();
+  }
+  bitmap_size_ = WithBitmapPage(page_size_, nullptr, [](auto *bitmap) {
+    return std::remove_pointer_t<decltype(bitmap)>::GetMaxSupportedSize();
+  });
+  meta_data_ = new char[page_size_];
+  bitmap_data_ = new char[page_size_];
   ReadPhysicalPage(META_PAGE_ID, meta_data_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  if (meta_page->page_size_ == 0) {
+    meta_page->page_size_ = page_size_;
+  }
 }
 
 void DiskManager::Close() {
   std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   if (!closed) {
+    WritePhysicalPage(META_PAGE_ID, meta_data_);
     db_io_.close();
     closed = true;
   }
@@ -33,29 +71,124 @@ void DiskManager::Close() {
 
 void DiskManager::ReadPage(page_id_t logical_page_id, char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   ReadPhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 void DiskManager::WritePage(page_id_t logical_page_id, const char *page_data) {
   ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
   WritePhysicalPage(MapPageId(logical_page_id), page_data);
 }
 
 page_id_t DiskManager::AllocatePage() {
-  ASSERT(false, "Not implemented yet.");
-  return INVALID_PAGE_ID;
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  // find the first extent which still has free pages
+  uint32_t extent_id = 0;
+  while (extent_id < meta_page->num_extents_ && meta_page->extent_used_page_[extent_id] >= bitmap_size_) {
+    extent_id++;
+  }
+  // logical page ids must fit in the page id bits left by the file id
+  uint32_t max_extent_nums = std::min<uint32_t>(DiskFileMetaPage::GetMaxExtentNums(page_size_),
+                                                (MAX_LOCAL_PAGE_ID + 1) / bitmap_size_);
+  if (extent_id >= max_extent_nums) {
+    LOG(ERROR) << "Disk file " << file_name_ << " is full.";
+    return INVALID_PAGE_ID;
+  }
+  // a bitmap page of a new extent lies beyond the file end and is read as zeros
+  page_id_t bitmap_physical_id = GetBitmapPhysicalId(extent_id);
+  ReadPhysicalPage(bitmap_physical_id, bitmap_data_);
+  uint32_t page_offset = 0;
+  bool allocated = WithBitmapPage(page_size_, bitmap_data_, [&page_offset](auto *bitmap) {
+    return bitmap->AllocatePage(page_offset);
+  });
+  if (!allocated) {
+    LOG(ERROR) << "Bitmap of extent " << extent_id << " is inconsistent with meta page.";
+    return INVALID_PAGE_ID;
+  }
+  WritePhysicalPage(bitmap_physical_id, bitmap_data_);
+  if (extent_id == meta_page->num_extents_) {
+    meta_page->extent_used_page_[meta_page->num_extents_++] = 0;
+  }
+  meta_page->extent_used_page_[extent_id]++;
+  meta_page->num_allocated_pages_++;
+  return static_cast<page_id_t>(extent_id * bitmap_size_ + page_offset);
 }
 
 void DiskManager::DeAllocatePage(page_id_t logical_page_id) {
-  ASSERT(false, "Not implemented yet.");
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_id = logical_page_id / bitmap_size_;
+  uint32_t page_offset = logical_page_id % bitmap_size_;
+  if (extent_id >= meta_page->num_extents_) {
+    return;
+  }
+  page_id_t bitmap_physical_id = GetBitmapPhysicalId(extent_id);
+  ReadPhysicalPage(bitmap_physical_id, bitmap_data_);
+  bool freed = WithBitmapPage(page_size_, bitmap_data_, [page_offset](auto *bitmap) {
+    return bitmap->DeAllocatePage(page_offset);
+  });
+  if (!freed) {
+    return;
+  }
+  WritePhysicalPage(bitmap_physical_id, bitmap_data_);
+  meta_page->extent_used_page_[extent_id]--;
+  meta_page->num_allocated_pages_--;
+}
+
+void DiskManager::DeAllocatePages(std::vector<page_id_t> logical_page_ids) {
+  std::sort(logical_page_ids.begin(), logical_page_ids.end());
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  size_t i = 0;
+  while (i < logical_page_ids.size()) {
+    ASSERT(logical_page_ids[i] >= 0, "Invalid page id.");
+    uint32_t extent_id = logical_page_ids[i] / bitmap_size_;
+    size_t end = i;
+    while (end < logical_page_ids.size() && logical_page_ids[end] / bitmap_size_ == extent_id) {
+      end++;
+    }
+    if (extent_id >= meta_page->num_extents_) {
+      break;
+    }
+    page_id_t bitmap_physical_id = GetBitmapPhysicalId(extent_id);
+    ReadPhysicalPage(bitmap_physical_id, bitmap_data_);
+    uint32_t freed_count = WithBitmapPage(page_size_, bitmap_data_, [&](auto *bitmap) {
+      uint32_t count = 0;
+      for (size_t j = i; j < end; j++) {
+        count += bitmap->DeAllocatePage(logical_page_ids[j] % bitmap_size_) ? 1 : 0;
+      }
+      return count;
+    });
+    if (freed_count > 0) {
+      WritePhysicalPage(bitmap_physical_id, bitmap_data_);
+      meta_page->extent_used_page_[extent_id] -= freed_count;
+      meta_page->num_allocated_pages_ -= freed_count;
+    }
+    i = end;
+  }
 }
 
 bool DiskManager::IsPageFree(page_id_t logical_page_id) {
-  return false;
+  ASSERT(logical_page_id >= 0, "Invalid page id.");
+  std::scoped_lock<std::recursive_mutex> lock(db_io_latch_);
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(meta_data_);
+  uint32_t extent_id = logical_page_id / bitmap_size_;
+  if (extent_id >= meta_page->num_extents_) {
+    return true;
+  }
+  ReadPhysicalPage(GetBitmapPhysicalId(extent_id), bitmap_data_);
+  uint32_t page_offset = logical_page_id % bitmap_size_;
+  return WithBitmapPage(page_size_, bitmap_data_, [page_offset](auto *bitmap) {
+    return bitmap->IsPageFree(page_offset);
+  });
 }
 
 page_id_t DiskManager::MapPageId(page_id_t logical_page_id) {
-  return 0;
+  // skip the meta page and the bitmap pages of all extents up to and including the one of this page
+  return static_cast<page_id_t>(logical_page_id + logical_page_id / bitmap_size_ + 2);
 }
 
 int DiskManager::GetFileSize(const std::string &file_name) {
@@ -64,34 +197,51 @@ int DiskManager::GetFileSize(const std::string &file_name) {
   return rc == 0 ? stat_buf.st_size : -1;
 }
 
+uint32_t DiskManager::ReadRecordedPageSize() {
+  if (GetFileSize(file_name_) < static_cast<int>(DiskFileMetaPage::SIZE_META_PAGE_HEADER)) {
+    return 0;
+  }
+  DiskFileMetaPage header;
+  db_io_.seekp(META_PAGE_ID);
+  db_io_.read(reinterpret_cast<char *>(&header), DiskFileMetaPage::SIZE_META_PAGE_HEADER);
+  db_io_.clear();
+  return header.GetPageSize();
+}
+
 void DiskManager::ReadPhysicalPage(page_id_t physical_page_id, char *page_data) {
-  int offset = physical_page_id * PAGE_SIZE;
+  int64_t offset = static_cast<int64_t>(physical_page_id) * page_size_;
   // check if read beyond file length
   if (offset >= GetFileSize(file_name_)) {
 #ifdef ENABLE_BPM_DEBUG
     LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-    memset(page_data, 0, PAGE_SIZE);
+    memset(page_data, 0, page_size_);
   } else {
+    auto start = std::chrono::steady_clock::now();
     // set read cursor to offset
     db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    db_io_.read(page_data, page_size_);
+    // if file ends before reading page_size_
+    uint32_t read_count = db_io_.gcount();
+    io_stats_.Record(GetPageType(physical_page_id), DiskIOType::READ, read_count,
+                     std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                             .count());
+    if (read_count < page_size_) {
 #ifdef ENABLE_BPM_DEBUG
       LOG(INFO) << "Read less than a page" << std::endl;
 #endif
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+      db_io_.clear();
+      memset(page_data + read_count, 0, page_size_ - read_count);
     }
   }
 }
 
 void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page_data) {
-  size_t offset = static_cast<size_t>(physical_page_id) * PAGE_SIZE;
+  auto start = std::chrono::steady_clock::now();
+  size_t offset = static_cast<size_t>(physical_page_id) * page_size_;
   // set write cursor to offset
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(page_data, page_size_);
   // check for I/O error
   if (db_io_.bad()) {
     LOG(ERROR) << "I/O error while writing";
@@ -99,4 +249,7 @@ void DiskManager::WritePhysicalPage(page_id_t physical_page_id, const char *page
   }
   // needs to flush to keep disk file in sync
   db_io_.flush();
-}
\ No newline at end of file
+  io_stats_.Record(GetPageType(physical_page_id), DiskIOType::WRITE, page_size_,
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start)
+                           .count());
+}
@@ -0,0 +1,248 @@
+#include <iterator>
+
+#include "storage/free_space_map.h"
+
+page_id_t FreeSpaceMap::Create(file_id_t file_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_id_t map_page_id;
+  auto page = buffer_pool_manager_->NewPage(map_page_id, file_id);
+  ASSERT(page != nullptr, "Failed to allocate free space map page.");
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+  buffer_pool_manager_->UnpinPage(map_page_id, true);
+  map_page_ids_ = {map_page_id};
+  return map_page_id;
+}
+
+void FreeSpaceMap::Open(page_id_t first_map_page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  map_page_ids_.clear();
+  ClearEntries();
+  for (page_id_t map_page_id = first_map_page_id; map_page_id != INVALID_PAGE_ID;) {
+    auto page = buffer_pool_manager_->FetchPage(map_page_id);
+    ASSERT(page != nullptr, "Failed to fetch free space map page.");
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    for (uint32_t i = 0; i < map_page->GetEntryCount(); i++) {
+      AddEntry(map_page->GetPageId(i), map_page->GetBucket(i));
+    }
+    map_page_ids_.push_back(map_page_id);
+    page_id_t next_page_id = map_page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(map_page_id, false);
+    map_page_id = next_page_id;
+  }
+}
+
+void FreeSpaceMap::Clear() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  for (auto map_page_id : map_page_ids_) {
+    auto page = buffer_pool_manager_->FetchPage(map_page_id);
+    ASSERT(page != nullptr, "Failed to fetch free space map page.");
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Clear();
+    buffer_pool_manager_->UnpinPage(map_page_id, true);
+  }
+  ClearEntries();
+}
+
+void FreeSpaceMap::Free() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  buffer_pool_manager_->DeletePages(map_page_ids_);
+  map_page_ids_.clear();
+  ClearEntries();
+}
+
+Page *FreeSpaceMap::FetchPage(uint32_t size) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  // smallest bucket whose pages are guaranteed to have size bytes free
+  uint32_t min_bucket = (size + bucket_width_ - 1) / bucket_width_;
+  if (min_bucket >= BUCKET_NUM) {
+    return nullptr;
+  }
+  uint64_t candidates = non_empty_buckets_ & (~0ULL << min_bucket);
+  if (candidates == 0) {
+    return nullptr;
+  }
+  uint32_t bucket = __builtin_ctzll(candidates);
+  return buffer_pool_manager_->FetchPage(page_ids_[bucket_entries_[bucket].back()]);
+}
+
+Page *FreeSpaceMap::FetchLastPage() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  page_id_t page_id = GetLastEntryPageId();
+  return page_id == INVALID_PAGE_ID ? nullptr : buffer_pool_manager_->FetchPage(page_id);
+}
+
+void FreeSpaceMap::Add(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto iter = entry_of_.find(page_id);
+  if (iter == entry_of_.end()) {
+    Persist(AddEntry(page_id, GetBucket(free_space)));
+    return;
+  }
+  UpdateEntry(iter->second, GetBucket(free_space));
+}
+
+void FreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto iter = entry_of_.find(page_id);
+  if (iter != entry_of_.end()) {
+    UpdateEntry(iter->second, GetBucket(free_space));
+  }
+}
+
+void FreeSpaceMap::UpdateEntry(uint32_t entry, uint32_t bucket) {
+  // map pages are only written when a page moves to another bucket
+  if (buckets_[entry] != bucket) {
+    RemoveFromBucket(entry);
+    AddToBucket(entry, bucket);
+    Persist(entry);
+  }
+}
+
+void FreeSpaceMap::Remove(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto iter = entry_of_.find(page_id);
+  if (iter == entry_of_.end()) {
+    return;
+  }
+  // the entry is left in place, so that other entries do not move until the removed ones are many
+  uint32_t entry = iter->second;
+  RemoveFromBucket(entry);
+  entry_of_.erase(iter);
+  page_ids_[entry] = INVALID_PAGE_ID;
+  removed_count_++;
+  auto page = buffer_pool_manager_->FetchPage(map_page_ids_[entry / entries_per_page_]);
+  ASSERT(page != nullptr, "Failed to fetch free space map page.");
+  reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->SetPageId(entry % entries_per_page_, INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(map_page_ids_[entry / entries_per_page_], true);
+  if (removed_count_ * 2 > page_ids_.size()) {
+    Compact();
+  }
+}
+
+page_id_t FreeSpaceMap::GetLastPageId() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return GetLastEntryPageId();
+}
+
+page_id_t FreeSpaceMap::GetLastEntryPageId() {
+  for (auto iter = page_ids_.rbegin(); iter != page_ids_.rend(); ++iter) {
+    if (*iter != INVALID_PAGE_ID) {
+      return *iter;
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+uint32_t FreeSpaceMap::GetPageCount() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return page_ids_.size() - removed_count_;
+}
+
+std::vector<page_id_t> FreeSpaceMap::GetPageIds() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  if (removed_count_ == 0) {
+    return page_ids_;
+  }
+  std::vector<page_id_t> page_ids;
+  page_ids.reserve(page_ids_.size() - removed_count_);
+  std::copy_if(page_ids_.begin(), page_ids_.end(), std::back_inserter(page_ids), [](page_id_t page_id) {
+    return page_id != INVALID_PAGE_ID;
+  });
+  return page_ids;
+}
+
+void FreeSpaceMap::ClearEntries() {
+  page_ids_.clear();
+  buckets_.clear();
+  bucket_pos_.clear();
+  entry_of_.clear();
+  removed_count_ = 0;
+  for (auto &entries : bucket_entries_) {
+    entries.clear();
+  }
+  non_empty_buckets_ = 0;
+}
+
+uint32_t FreeSpaceMap::AddEntry(page_id_t page_id, uint32_t bucket) {
+  uint32_t entry = page_ids_.size();
+  page_ids_.push_back(page_id);
+  buckets_.push_back(bucket);
+  bucket_pos_.push_back(0);
+  if (page_id == INVALID_PAGE_ID) {
+    removed_count_++;
+    return entry;
+  }
+  entry_of_[page_id] = entry;
+  AddToBucket(entry, bucket);
+  return entry;
+}
+
+void FreeSpaceMap::Compact() {
+  std::vector<page_id_t> page_ids = std::move(page_ids_);
+  std::vector<uint8_t> buckets = std::move(buckets_);
+  ClearEntries();
+  for (uint32_t i = 0; i < page_ids.size(); i++) {
+    if (page_ids[i] != INVALID_PAGE_ID) {
+      AddEntry(page_ids[i], buckets[i]);
+    }
+  }
+  // trailing map pages are left empty for reuse
+  for (uint32_t index = 0; index < map_page_ids_.size(); index++) {
+    auto page = buffer_pool_manager_->FetchPage(map_page_ids_[index]);
+    ASSERT(page != nullptr, "Failed to fetch free space map page.");
+    auto map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+    map_page->Clear();
+    size_t end = std::min<size_t>((index + 1) * entries_per_page_, page_ids_.size());
+    for (size_t entry = index * entries_per_page_; entry < end; entry++) {
+      map_page->Append(page_ids_[entry], buckets_[entry]);
+    }
+    buffer_pool_manager_->UnpinPage(map_page_ids_[index], true);
+  }
+}
+
+void FreeSpaceMap::AddToBucket(uint32_t entry, uint32_t bucket) {
+  buckets_[entry] = bucket;
+  bucket_pos_[entry] = bucket_entries_[bucket].size();
+  bucket_entries_[bucket].push_back(entry);
+  non_empty_buckets_ |= 1ULL << bucket;
+}
+
+void FreeSpaceMap::RemoveFromBucket(uint32_t entry) {
+  auto &entries = bucket_entries_[buckets_[entry]];
+  // move the last entry of the bucket into the hole
+  uint32_t last = entries.back();
+  entries[bucket_pos_[entry]] = last;
+  bucket_pos_[last] = bucket_pos_[entry];
+  entries.pop_back();
+  if (entries.empty()) {
+    non_empty_buckets_ &= ~(1ULL << buckets_[entry]);
+  }
+}
+
+void FreeSpaceMap::Persist(uint32_t entry) {
+  ASSERT(!map_page_ids_.empty(), "Free space map is not created.");
+  uint32_t map_page_index = entry / entries_per_page_;
+  if (map_page_index == map_page_ids_.size()) {
+    // chain a new map page after the last one
+    page_id_t prev_map_page_id = map_page_ids_.back();
+    page_id_t map_page_id;
+    auto page = buffer_pool_manager_->NewPage(map_page_id, GetFileId(prev_map_page_id));
+    ASSERT(page != nullptr, "Failed to allocate free space map page.");
+    reinterpret_cast<FreeSpaceMapPage *>(page->GetData())->Init();
+    buffer_pool_manager_->UnpinPage(map_page_id, true);
+    auto prev_page = buffer_pool_manager_->FetchPage(prev_map_page_id);
+    reinterpret_cast<FreeSpaceMapPage *>(prev_page->GetData())->SetNextPageId(map_page_id);
+    buffer_pool_manager_->UnpinPage(prev_map_page_id, true);
+    map_page_ids_.push_back(map_page_id);
+  }
+  page_id_t map_page_id = map_page_ids_[map_page_index];
+  auto page = buffer_pool_manager_->FetchPage(map_page_id);
+  ASSERT(page != nullptr, "Failed to fetch free space map page.");
+  auto map_page = reinterpret_cast<FreeSpaceMapPage *>(page->GetData());
+  uint32_t index = entry % entries_per_page_;
+  if (index == map_page->GetEntryCount()) {
+    map_page->Append(page_ids_[entry], buckets_[entry]);
+  } else {
+    map_page->SetBucket(index, buckets_[entry]);
+  }
+  buffer_pool_manager_->UnpinPage(map_page_id, true);
+}
@@ -0,0 +1,81 @@
+#include "glog/logging.h"
+#include "storage/page_reclaimer.h"
+
+PageReclaimer::PageReclaimer(BufferPoolManager *buffer_pool_manager)
+        : buffer_pool_manager_(buffer_pool_manager) {
+  thread_ = std::thread([this] { Run(); });
+}
+
+PageReclaimer::~PageReclaimer() {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_requested_ = true;
+  }
+  task_cv_.notify_all();
+  thread_.join();
+}
+
+void PageReclaimer::Release(TableHeap *table_heap, std::function<void()> on_released) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    tasks_.push_back(Task{table_heap, {}, std::move(on_released)});
+  }
+  task_cv_.notify_all();
+}
+
+void PageReclaimer::Release(std::vector<page_id_t> page_ids) {
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    tasks_.push_back(Task{nullptr, std::move(page_ids), nullptr});
+  }
+  task_cv_.notify_all();
+}
+
+void PageReclaimer::Drain() {
+  std::unique_lock<std::mutex> lock(latch_);
+  idle_cv_.wait(lock, [this] { return IsIdle(); });
+}
+
+void PageReclaimer::Run() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    auto has_task = [this] { return stop_requested_ || !tasks_.empty(); };
+    if (pinned_page_ids_.empty()) {
+      task_cv_.wait(lock, has_task);
+    } else {
+      task_cv_.wait_for(lock, RETRY_INTERVAL, has_task);
+    }
+    if (stop_requested_ && tasks_.empty()) {
+      break;
+    }
+    Task task;
+    if (!tasks_.empty()) {
+      task = std::move(tasks_.front());
+      tasks_.pop_front();
+    } else {
+      task.page_ids_.swap(pinned_page_ids_);
+    }
+    busy_ = true;
+    lock.unlock();
+    std::vector<page_id_t> pinned_page_ids;
+    if (task.table_heap_ != nullptr) {
+      // pinned pages are retried by their ids, so the table heap is not needed any more
+      pinned_page_ids = task.table_heap_->FreeHeap();
+      task.table_heap_->~TableHeap();
+    } else {
+      pinned_page_ids = buffer_pool_manager_->DeletePages(task.page_ids_);
+    }
+    if (task.on_released_) {
+      task.on_released_();
+    }
+    lock.lock();
+    busy_ = false;
+    pinned_page_ids_.insert(pinned_page_ids_.end(), pinned_page_ids.begin(), pinned_page_ids.end());
+    if (IsIdle()) {
+      idle_cv_.notify_all();
+    }
+  }
+  if (!pinned_page_ids_.empty()) {
+    LOG(WARNING) << pinned_page_ids_.size() << " pinned pages are not released.";
+  }
+}
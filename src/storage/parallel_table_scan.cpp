@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <thread>
+
+#include "storage/parallel_table_scan.h"
+
+ParallelTableScan::ParallelTableScan(TableHeap *table_heap, uint32_t dop, uint32_t morsel_size)
+        : table_heap_(table_heap), dop_(std::max(dop, 1u)), morsel_size_(std::max(morsel_size, 1u)), queues_(dop_) {}
+
+void ParallelTableScan::Scan(const Consumer &consumer, Transaction *txn) {
+  Scan(consumer, nullptr, txn);
+}
+
+void ParallelTableScan::Scan(const Consumer &consumer, const ScanPredicate *predicate, Transaction *txn) {
+  // pages appended after the scan starts are not scanned, pages unlinked meanwhile are kept until it ends
+  uint64_t epoch = table_heap_->EnterEpoch();
+  page_ids_ = table_heap_->free_space_map_.GetPageIds();
+  skipped_page_count_ = 0;
+  ZoneMap *zone_map = table_heap_->GetZoneMap();
+  if (predicate != nullptr && zone_map != nullptr) {
+    auto end = std::remove_if(page_ids_.begin(), page_ids_.end(), [zone_map, predicate](page_id_t page_id) {
+      return !zone_map->MayMatch(page_id, *predicate);
+    });
+    skipped_page_count_ = page_ids_.end() - end;
+    page_ids_.erase(end, page_ids_.end());
+  }
+  size_t morsel_num = (page_ids_.size() + morsel_size_ - 1) / morsel_size_;
+  // each worker starts with a contiguous share of morsels
+  for (uint32_t worker_id = 0; worker_id < dop_; worker_id++) {
+    auto &queue = queues_[worker_id];
+    queue.morsels_.clear();
+    for (size_t i = morsel_num * worker_id / dop_; i < morsel_num * (worker_id + 1) / dop_; i++) {
+      queue.morsels_.push_back({i * morsel_size_, std::min(page_ids_.size(), (i + 1) * morsel_size_)});
+    }
+  }
+  if (dop_ == 1) {
+    RunWorker(0, consumer, txn);
+    table_heap_->ExitEpoch(epoch);
+    return;
+  }
+  std::vector<std::thread> workers;
+  for (uint32_t worker_id = 0; worker_id < dop_; worker_id++) {
+    workers.emplace_back([this, worker_id, &consumer, txn] { RunWorker(worker_id, consumer, txn); });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  table_heap_->ExitEpoch(epoch);
+}
+
+std::vector<RowId> ParallelTableScan::Filter(const std::function<bool(const RowView &row)> &predicate,
+                                             Transaction *txn) {
+  std::vector<std::vector<RowId>> partial_results(dop_);
+  Scan([&predicate, &partial_results](uint32_t worker_id, const RowView &row) {
+    if (predicate(row)) {
+      partial_results[worker_id].push_back(row.GetRowId());
+    }
+  }, txn);
+  std::vector<RowId> result;
+  for (auto &partial_result : partial_results) {
+    result.insert(result.end(), partial_result.begin(), partial_result.end());
+  }
+  return result;
+}
+
+std::vector<RowId> ParallelTableScan::Filter(const ScanPredicate &predicate, Transaction *txn) {
+  std::vector<std::vector<RowId>> partial_results(dop_);
+  Scan([&predicate, &partial_results](uint32_t worker_id, const RowView &row) {
+    if (predicate.Evaluate(row)) {
+      partial_results[worker_id].push_back(row.GetRowId());
+    }
+  }, &predicate, txn);
+  std::vector<RowId> result;
+  for (auto &partial_result : partial_results) {
+    result.insert(result.end(), partial_result.begin(), partial_result.end());
+  }
+  return result;
+}
+
+bool ParallelTableScan::NextMorsel(uint32_t worker_id, Morsel &morsel) {
+  {
+    auto &queue = queues_[worker_id];
+    std::scoped_lock<std::mutex> lock(queue.latch_);
+    if (!queue.morsels_.empty()) {
+      morsel = queue.morsels_.front();
+      queue.morsels_.pop_front();
+      return true;
+    }
+  }
+  // steal from the back, away from the pages the owner is working on
+  for (uint32_t i = 1; i < dop_; i++) {
+    auto &victim = queues_[(worker_id + i) % dop_];
+    std::scoped_lock<std::mutex> lock(victim.latch_);
+    if (!victim.morsels_.empty()) {
+      morsel = victim.morsels_.back();
+      victim.morsels_.pop_back();
+      return true;
+    }
+  }
+  return false;
+}
+
+void ParallelTableScan::RunWorker(uint32_t worker_id, const Consumer &consumer, Transaction *txn) {
+  Morsel morsel{};
+  while (NextMorsel(worker_id, morsel)) {
+    for (size_t i = morsel.begin_; i < morsel.end_; i++) {
+      ScanPage(page_ids_[i], worker_id, consumer, txn);
+    }
+  }
+}
+
+void ParallelTableScan::ScanPage(page_id_t page_id, uint32_t worker_id, const Consumer &consumer,
+                                 Transaction *txn) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  auto page = buffer_pool_manager->FetchPage(page_id);
+  if (page == nullptr) {
+    return;
+  }
+  page->RLatch();
+  table_heap_->VisitPage(page, [this, worker_id, &consumer](auto table_page) {
+    RowView row(table_heap_->schema_);
+    RowId rid;
+    bool found = table_page->GetFirstTupleRid(&rid);
+    while (found) {
+      table_page->GetTupleView(rid, row);
+      consumer(worker_id, row);
+      RowId next_rid;
+      found = table_page->GetNextTupleRid(rid, &next_rid);
+      rid = next_rid;
+    }
+  });
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+}
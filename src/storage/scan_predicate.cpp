@@ -0,0 +1,150 @@
+#include "record/type_kernels.h"
+#include "storage/scan_predicate.h"
+#include "storage/table_heap.h"
+
+using SerializedMatch = bool (*)(const char *storage, const char *value);
+
+template<TypeId type_id, ScanPredicate::CompareOp op>
+static bool MatchSerialized(const char *storage, const char *value) {
+  int result = TypeKernel<type_id>::CompareSerialized(storage, value);
+  switch (op) {
+    case ScanPredicate::kEqual:
+      return result == 0;
+    case ScanPredicate::kNotEqual:
+      return result != 0;
+    case ScanPredicate::kLessThan:
+      return result < 0;
+    case ScanPredicate::kLessThanEquals:
+      return result <= 0;
+    case ScanPredicate::kGreaterThan:
+      return result > 0;
+    case ScanPredicate::kGreaterThanEquals:
+      return result >= 0;
+    default:
+      return false;
+  }
+}
+
+template<TypeId type_id>
+static SerializedMatch SelectMatchOfType(ScanPredicate::CompareOp op) {
+  switch (op) {
+    case ScanPredicate::kEqual:
+      return &MatchSerialized<type_id, ScanPredicate::kEqual>;
+    case ScanPredicate::kNotEqual:
+      return &MatchSerialized<type_id, ScanPredicate::kNotEqual>;
+    case ScanPredicate::kLessThan:
+      return &MatchSerialized<type_id, ScanPredicate::kLessThan>;
+    case ScanPredicate::kLessThanEquals:
+      return &MatchSerialized<type_id, ScanPredicate::kLessThanEquals>;
+    case ScanPredicate::kGreaterThan:
+      return &MatchSerialized<type_id, ScanPredicate::kGreaterThan>;
+    case ScanPredicate::kGreaterThanEquals:
+      return &MatchSerialized<type_id, ScanPredicate::kGreaterThanEquals>;
+    default:
+      ASSERT(false, "Unexpected compare operator.");
+      return nullptr;
+  }
+}
+
+void ScanPredicate::AddComparison(uint32_t column, CompareOp op, const Field &value) {
+  ASSERT(op != kIsNull && op != kNotNull, "Use AddNullCheck for null checks.");
+  if (value.GetTypeId() == TypeId::kTypeChar && !value.IsNull()) {
+    // keep a copy of the value, which may refer to a buffer of the caller
+    Field copy(TypeId::kTypeChar, const_cast<char *>(value.GetData()), value.GetLength(), true);
+    comparisons_.emplace_back(column, op, copy);
+  } else {
+    comparisons_.emplace_back(column, op, value);
+  }
+  if (!value.IsNull()) {
+    Comparison &comparison = comparisons_.back();
+    comparison.value_data_.resize(value.GetSerializedSize());
+    comparison.value_.SerializeTo(comparison.value_data_.data());
+    comparison.match_ = SelectMatch(value.GetTypeId(), op);
+    // codes are never reassigned, so encoded values are tested for (in)equality by their code
+    ColumnDictionary *dictionary = table_heap_ == nullptr ? nullptr : table_heap_->GetDictionary(column);
+    if (dictionary != nullptr && (op == kEqual || op == kNotEqual)) {
+      comparison.code_ = dictionary->Lookup(value.GetData(), value.GetLength());
+    }
+  }
+}
+
+void ScanPredicate::AddNullCheck(uint32_t column, bool is_null) {
+  comparisons_.emplace_back(column, is_null ? kIsNull : kNotNull, Field(TypeId::kTypeInvalid));
+}
+
+bool ScanPredicate::Evaluate(const RowView &row) const {
+  for (auto &comparison : comparisons_) {
+    bool is_null = row.IsNull(comparison.column_);
+    if (comparison.op_ == kIsNull || comparison.op_ == kNotNull) {
+      if (is_null != (comparison.op_ == kIsNull)) {
+        return false;
+      }
+      continue;
+    }
+    if (is_null) {
+      return false;
+    }
+    if (comparison.match_ != nullptr) {
+      char *storage = row.GetFieldData(comparison.column_);
+      if (comparison.value_.GetTypeId() != TypeId::kTypeChar || TypeKernel<TypeId::kTypeChar>::IsInRow(storage)) {
+        if (!comparison.match_(storage, comparison.value_data_.data())) {
+          return false;
+        }
+        continue;
+      }
+      if (comparison.code_ != ColumnDictionary::INVALID_CODE && TypeKernel<TypeId::kTypeChar>::IsEncoded(storage)) {
+        if ((TypeKernel<TypeId::kTypeChar>::GetCode(storage) == comparison.code_) != (comparison.op_ == kEqual)) {
+          return false;
+        }
+        continue;
+      }
+    }
+    // values stored out of line or encoded are fetched and compared as fields
+    Field field = row.GetField(comparison.column_);
+    if (!field.IsFetched()) {
+      ASSERT(table_heap_ != nullptr, "No table heap to fetch the value from.");
+      if (!table_heap_->FetchField(&field, comparison.column_)) {
+        return false;
+      }
+    }
+    if (Compare(field, comparison) != CmpBool::kTrue) {
+      return false;
+    }
+  }
+  return true;
+}
+
+CmpBool ScanPredicate::Compare(const Field &field, const Comparison &comparison) {
+  const Field &value = comparison.value_;
+  switch (comparison.op_) {
+    case kEqual:
+      return field.CompareEquals(value);
+    case kNotEqual:
+      return field.CompareNotEquals(value);
+    case kLessThan:
+      return field.CompareLessThan(value);
+    case kLessThanEquals:
+      return field.CompareLessThanEquals(value);
+    case kGreaterThan:
+      return field.CompareGreaterThan(value);
+    case kGreaterThanEquals:
+      return field.CompareGreaterThanEquals(value);
+    default:
+      ASSERT(false, "Unexpected compare operator.");
+      return CmpBool::kNull;
+  }
+}
+
+ScanPredicate::MatchFunc ScanPredicate::SelectMatch(TypeId type_id, CompareOp op) {
+  switch (type_id) {
+    case TypeId::kTypeInt:
+      return SelectMatchOfType<TypeId::kTypeInt>(op);
+    case TypeId::kTypeFloat:
+      return SelectMatchOfType<TypeId::kTypeFloat>(op);
+    case TypeId::kTypeChar:
+      return SelectMatchOfType<TypeId::kTypeChar>(op);
+    default:
+      ASSERT(false, "Unsupported type.");
+      return nullptr;
+  }
+}
@@ -1,55 +1,1156 @@
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <type_traits>
+
+#include "page/overflow_page.h"
+#include "record/row_view.h"
 #include "storage/table_heap.h"
 
+TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, Schema *schema, Transaction *txn,
+                     LogManager *log_manager, LockManager *lock_manager, file_id_t file_id, TableFormat format)
+        : buffer_pool_manager_(buffer_pool_manager),
+          schema_(schema),
+          format_(format),
+          free_space_map_(buffer_pool_manager),
+          log_manager_(log_manager),
+          lock_manager_(lock_manager) {
+  for (auto column : schema_->GetColumns()) {
+    has_char_column_ |= column->GetType() == TypeId::kTypeChar;
+  }
+  auto page = buffer_pool_manager_->NewPage(first_page_id_, file_id);
+  ASSERT(page != nullptr, "Failed to allocate the first page of table heap.");
+  page->WLatch();
+  InitPage(page, first_page_id_, INVALID_PAGE_ID, 0, txn);
+  page_id_t map_page_id = free_space_map_.Create(file_id);
+  uint32_t free_space = VisitPage(page, [map_page_id](auto table_page) {
+    table_page->SetFreeSpaceMapPageId(map_page_id);
+    return table_page->GetTotalFreeSpace();
+  });
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  free_space_map_.Add(first_page_id_, free_space);
+}
+
+TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, page_id_t first_page_id, Schema *schema,
+                     LogManager *log_manager, LockManager *lock_manager, TableFormat format)
+        : buffer_pool_manager_(buffer_pool_manager),
+          first_page_id_(first_page_id),
+          schema_(schema),
+          format_(format),
+          free_space_map_(buffer_pool_manager),
+          log_manager_(log_manager),
+          lock_manager_(lock_manager) {
+  for (auto column : schema_->GetColumns()) {
+    has_char_column_ |= column->GetType() == TypeId::kTypeChar;
+  }
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  ASSERT(page != nullptr, "Failed to fetch the first page of table heap.");
+  page_id_t map_page_id = page->GetFreeSpaceMapPageId();
+  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  if (map_page_id == INVALID_PAGE_ID) {
+    RebuildFreeSpaceMap();
+  } else {
+    free_space_map_.Open(map_page_id);
+  }
+  for (auto page_id : free_space_map_.GetPageIds()) {
+    pages_with_deletes_.insert(page_id);
+  }
+}
+
 bool TableHeap::InsertTuple(Row &row, Transaction *txn) {
-  return false;
+  if (!ToastRow(row, txn)) {
+    RestoreRow(row);
+    return false;
+  }
+  bool inserted;
+  if (format_ == kPaxFormat) {
+    inserted = AppendTuples(&row, 1, txn) == 1;
+  } else {
+    inserted = IsAppendMode() ? AppendTuple(row, txn) : PlaceTuple(row, nullptr, txn);
+  }
+  if (!inserted) {
+    FreeExternalFields(row);
+  }
+  RestoreRow(row);
+  return inserted;
 }
 
-bool TableHeap::MarkDelete(const RowId &rid, Transaction *txn) {
-  // Find the page which contains the tuple.
-  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+bool TableHeap::AppendTuple(Row &row, Transaction *txn) {
+  uint32_t size = row.GetSerializedSize(schema_) + TablePage::SIZE_TUPLE;
+  size_t tail_index = std::hash<std::thread::id>()(std::this_thread::get_id()) % append_tails_.size();
+  AppendTail &tail = *append_tails_[tail_index];
+  std::scoped_lock<std::mutex> lock(tail.latch_);
+  while (true) {
+    // the cached free space is only a hint, the page may be also used by inserts which found it in the map
+    if (tail.page_id_ != INVALID_PAGE_ID && tail.free_space_ >= size) {
+      auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(tail.page_id_));
+      if (page == nullptr) {
+        return false;
+      }
+      page->WLatch();
+      bool inserted = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+      if (inserted && zone_map_ != nullptr) {
+        zone_map_->Update(tail.page_id_, row);
+      }
+      tail.free_space_ = inserted ? page->GetTotalFreeSpace() : 0;
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(tail.page_id_, inserted);
+      if (inserted) {
+        return true;
+      }
+    }
+    if (!AdvanceTail(tail, txn)) {
+      return false;
+    }
+  }
+}
+
+bool TableHeap::AdvanceTail(AppendTail &tail, Transaction *txn) {
+  if (tail.spare_page_ids_.empty()) {
+    auto page_ids = NewTablePages(APPEND_EXTENT_SIZE, txn);
+    if (page_ids.empty()) {
+      return false;
+    }
+    std::scoped_lock<std::mutex> lock(append_latch_);
+    append_page_ids_.insert(page_ids.begin(), page_ids.end());
+    tail.spare_page_ids_.assign(page_ids.rbegin(), page_ids.rend());
+  }
+  RetireTail(tail);
+  tail.page_id_ = tail.spare_page_ids_.back();
+  tail.spare_page_ids_.pop_back();
+  // a new page is empty, unless an insert found it in the map
+  tail.free_space_ = buffer_pool_manager_->GetPageSize();
+  return true;
+}
+
+void TableHeap::RetireTail(AppendTail &tail) {
+  if (tail.page_id_ == INVALID_PAGE_ID) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(append_latch_);
+    append_page_ids_.erase(tail.page_id_);
+  }
+  free_space_map_.Update(tail.page_id_, tail.free_space_);
+  tail.page_id_ = INVALID_PAGE_ID;
+}
+
+void TableHeap::SetAppendMode(bool append_mode) {
+  ASSERT(format_ == kRowFormat, "Tuples of a table in PAX format are always appended to its last page.");
+  if (append_mode == IsAppendMode()) {
+    return;
+  }
+  if (append_mode) {
+    for (size_t i = 0; i < APPEND_TAIL_COUNT; i++) {
+      append_tails_.push_back(std::make_unique<AppendTail>());
+    }
+    return;
+  }
+  // spare pages are empty and already registered in the map
+  for (auto &tail : append_tails_) {
+    RetireTail(*tail);
+  }
+  append_tails_.clear();
+  std::scoped_lock<std::mutex> lock(append_latch_);
+  append_page_ids_.clear();
+}
+
+bool TableHeap::PlaceTuple(Row &row, const RowId *home_rid, Transaction *txn) {
+  uint32_t serialized_size = row.GetSerializedSize(schema_) + (home_rid != nullptr ? sizeof(int64_t) : 0);
+  bool inserted = false;
+  while (!inserted) {
+    auto page = reinterpret_cast<TablePage *>(free_space_map_.FetchPage(serialized_size + TablePage::SIZE_TUPLE));
+    bool is_new_page = page == nullptr;
+    if (is_new_page) {
+      auto new_page_ids = NewTablePages(1, txn);
+      if (new_page_ids.empty()) {
+        break;
+      }
+      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(new_page_ids[0]));
+      if (page == nullptr) {
+        break;
+      }
+    }
+    page_id_t page_id = page->GetPageId();
+    page->WLatch();
+    // the vacuum may have unlinked the page since it was found, it is no longer in the map
+    if (IsUnlinked(page)) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      continue;
+    }
+    if (home_rid != nullptr) {
+      inserted = page->InsertMovedTuple(row, *home_rid, schema_);
+    } else {
+      inserted = page->InsertTuple(row, schema_, txn, lock_manager_, log_manager_);
+    }
+    if (inserted && zone_map_ != nullptr) {
+      zone_map_->Update(page_id, row);
+    }
+    uint32_t free_space = page->GetTotalFreeSpace();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    // a stale entry is corrected before another page is tried
+    free_space_map_.Update(page_id, free_space);
+    if (is_new_page) {
+      break;
+    }
+  }
+  return inserted;
+}
+
+std::vector<RowId> TableHeap::InsertTuples(std::vector<Row> &rows, Transaction *txn) {
+  std::vector<RowId> rids;
+  rids.reserve(rows.size());
+  uint32_t page_size = buffer_pool_manager_->GetPageSize();
+  // rows after one which does not fit in a page are not inserted
+  size_t end = 0;
+  while (end < rows.size() && ToastRow(rows[end], txn)) {
+    end++;
+  }
+  // the row which did not fit may have been encoded too, its overflow pages are already released
+  size_t toasted_end = std::min(end + 1, rows.size());
+  if (format_ == kPaxFormat) {
+    size_t inserted = AppendTuples(rows.data(), end, txn);
+    for (size_t i = 0; i < inserted; i++) {
+      rids.push_back(rows[i].GetRowId());
+    }
+    for (size_t i = inserted; i < end; i++) {
+      FreeExternalFields(rows[i]);
+    }
+    for (size_t i = 0; i < toasted_end; i++) {
+      RestoreRow(rows[i]);
+    }
+    return rids;
+  }
+  // space left to insert, used to size runs of new pages
+  uint64_t remaining_space = 0;
+  std::vector<uint32_t> space_needed(end);
+  for (size_t i = 0; i < end; i++) {
+    space_needed[i] = rows[i].GetSerializedSize(schema_) + TablePage::SIZE_TUPLE;
+    remaining_space += space_needed[i];
+  }
+  std::vector<page_id_t> new_page_ids;
+  size_t next_new_page = 0;
+  size_t next = 0;
+  while (next < end) {
+    TablePage *page;
+    bool is_new_page = next_new_page < new_page_ids.size();
+    if (is_new_page) {
+      page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(new_page_ids[next_new_page++]));
+    } else if ((page = reinterpret_cast<TablePage *>(free_space_map_.FetchPage(space_needed[next]))) == nullptr) {
+      uint64_t page_capacity = TablePage::GetMaxRowSize(page_size) + TablePage::SIZE_TUPLE;
+      size_t run_length = std::min<uint64_t>((remaining_space + page_capacity - 1) / page_capacity, MAX_PAGE_RUN);
+      new_page_ids = NewTablePages(run_length, txn);
+      next_new_page = 0;
+      if (new_page_ids.empty()) {
+        break;
+      }
+      continue;
+    }
+    if (page == nullptr) {
+      break;
+    }
+    page_id_t page_id = page->GetPageId();
+    page->WLatch();
+    if (IsUnlinked(page)) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      continue;
+    }
+    size_t inserted = page->InsertTuples(rows, next, end, schema_, txn, lock_manager_, log_manager_);
+    for (size_t i = next; zone_map_ != nullptr && i < next + inserted; i++) {
+      zone_map_->Update(page_id, rows[i]);
+    }
+    uint32_t free_space = page->GetTotalFreeSpace();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted > 0);
+    free_space_map_.Update(page_id, free_space);
+    for (size_t i = next; i < next + inserted; i++) {
+      rids.push_back(rows[i].GetRowId());
+      remaining_space -= space_needed[i];
+    }
+    next += inserted;
+    if (inserted == 0 && is_new_page) {
+      break;
+    }
+  }
+  for (size_t i = next; i < end; i++) {
+    FreeExternalFields(rows[i]);
+  }
+  for (size_t i = 0; i < toasted_end; i++) {
+    RestoreRow(rows[i]);
+  }
+  return rids;
+}
+
+void TableHeap::InitPage(Page *page, page_id_t page_id, page_id_t prev_id, uint32_t char_size, Transaction *txn) {
+  if (format_ == kRowFormat) {
+    reinterpret_cast<TablePage *>(page)->Init(page_id, prev_id, log_manager_, txn);
+    return;
+  }
+  if (char_size == 0) {
+    // without a hint, assume char values of their max length
+    for (auto column : schema_->GetColumns()) {
+      if (column->GetType() == TypeId::kTypeChar) {
+        char_size += column->GetLength() + sizeof(uint32_t);
+      }
+    }
+  }
+  // a page holds at least one tuple, even if its char values do not fit
+  uint32_t capacity = std::max(PaxPage::GetCapacity(page->GetPageSize(), schema_, char_size), 1u);
+  reinterpret_cast<PaxPage *>(page)->Init(page_id, prev_id, schema_, capacity, log_manager_, txn);
+}
+
+std::vector<page_id_t> TableHeap::NewTablePages(size_t count, Transaction *txn, uint32_t char_size) {
+  std::scoped_lock<std::mutex> lock(append_latch_);
+  std::vector<page_id_t> page_ids;
+  page_id_t last_page_id = free_space_map_.GetLastPageId();
+  auto last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+  if (last_page == nullptr) {
+    return page_ids;
+  }
+  auto get_free_space = [](auto table_page) { return table_page->GetTotalFreeSpace(); };
+  last_page->WLatch();
+  // pages missing from a stale map are found by following the chain, prev and next page ids are at the same
+  // offsets in pages of both formats
+  while (last_page->GetNextPageId() != INVALID_PAGE_ID) {
+    page_id_t next_page_id = last_page->GetNextPageId();
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page_id, false);
+    last_page_id = next_page_id;
+    last_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+    ASSERT(last_page != nullptr, "Failed to fetch table page.");
+    last_page->WLatch();
+    free_space_map_.Add(last_page_id, VisitPage(last_page, get_free_space));
+  }
+  while (page_ids.size() < count) {
+    page_id_t page_id;
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->NewPage(page_id, GetFileId()));
+    if (page == nullptr) {
+      break;
+    }
+    InitPage(page, page_id, last_page_id, char_size, txn);
+    uint32_t free_space = VisitPage(page, get_free_space);
+    last_page->SetNextPageId(page_id);
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    free_space_map_.Add(page_id, free_space);
+    page_ids.push_back(page_id);
+    last_page_id = page_id;
+    last_page = page;
+    last_page->WLatch();
+  }
+  last_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(last_page_id, !page_ids.empty());
+  return page_ids;
+}
+
+size_t TableHeap::AppendTuples(Row *rows, size_t count, Transaction *txn) {
+  size_t inserted = 0;
+  auto page = reinterpret_cast<PaxPage *>(free_space_map_.FetchLastPage());
+  bool is_new_page = false;
+  while (inserted < count && page != nullptr) {
+    page_id_t page_id = page->GetPageId();
+    page->WLatch();
+    // the last page may have been unlinked by the vacuum since it was found, the page before it is last now
+    if (IsUnlinked(page)) {
+      page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page = reinterpret_cast<PaxPage *>(free_space_map_.FetchLastPage());
+      continue;
+    }
+    size_t page_inserted = 0;
+    while (inserted + page_inserted < count &&
+           page->InsertTuple(rows[inserted + page_inserted], schema_, txn, lock_manager_, log_manager_)) {
+      if (zone_map_ != nullptr) {
+        zone_map_->Update(page_id, rows[inserted + page_inserted]);
+      }
+      page_inserted++;
+    }
+    uint32_t char_size = page->GetAverageCharSize();
+    uint32_t free_space = page->GetTotalFreeSpace();
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, page_inserted > 0);
+    free_space_map_.Update(page_id, free_space);
+    inserted += page_inserted;
+    // a new page sized for the tuple has no room for it
+    if (inserted == count || (page_inserted == 0 && is_new_page)) {
+      break;
+    }
+    auto new_page_ids = NewTablePages(1, txn, std::max(char_size, PaxPage::GetCharSize(rows[inserted], schema_)));
+    if (new_page_ids.empty()) {
+      break;
+    }
+    page = reinterpret_cast<PaxPage *>(buffer_pool_manager_->FetchPage(new_page_ids[0]));
+    is_new_page = true;
+  }
+  return inserted;
+}
+
+bool TableHeap::MarkDelete(const RowId &home_rid, Transaction *txn) {
+  // Find the page which contains the tuple, a moved tuple is marked where it is.
+  RowId rid = GetTargetRid(home_rid);
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   // If the page could not be found, then abort the transaction.
   if (page == nullptr) {
     return false;
   }
   // Otherwise, mark the tuple as deleted.
   page->WLatch();
-  page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  bool marked = VisitPage(page, [this, &rid, txn](auto table_page) {
+    return table_page->MarkDelete(rid, txn, lock_manager_, log_manager_);
+  });
+  // The delete is registered before the page is unlatched, so that the vacuum never sees the tuple marked
+  // without knowing whether its transaction is running.
+  if (marked) {
+    std::scoped_lock<std::mutex> lock(vacuum_latch_);
+    pages_with_deletes_.insert(rid.GetPageId());
+    if (txn != nullptr) {
+      running_deletes_.emplace(home_rid.Get(), rid.GetPageId());
+    }
+  }
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
-  return true;
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), marked);
+  return marked;
 }
 
 bool TableHeap::UpdateTuple(const Row &row, const RowId &rid, Transaction *txn) {
-  return false;
+  // the new values are toasted and encoded in a copy, a row without long or encoded values is written as is
+  bool need_toast = false;
+  if (has_char_column_) {
+    need_toast = !dictionaries_.empty();
+    for (size_t i = 0; i < row.GetFieldCount(); i++) {
+      need_toast |= row.GetField(i)->IsExternal() || row.GetField(i)->IsEncoded();
+    }
+    need_toast |= row.GetSerializedSize(schema_) > TablePage::GetMaxRowSize(buffer_pool_manager_->GetPageSize()) / 4;
+  }
+  std::unique_ptr<Row> toasted_row;
+  if (need_toast) {
+    toasted_row = std::make_unique<Row>(row);
+    if (!ToastRow(*toasted_row, txn)) {
+      return false;
+    }
+  }
+  const Row &new_row = need_toast ? *toasted_row : row;
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+  if (page == nullptr) {
+    if (need_toast) {
+      FreeExternalFields(*toasted_row);
+    }
+    return false;
+  }
+  Row old_row(rid);
+  RowId target_rid;
+  bool updated = UpdateTupleInPage(new_row, &old_row, &target_rid, txn);
+  if (!updated && format_ == kRowFormat && target_rid.GetPageId() != INVALID_PAGE_ID) {
+    updated = MoveTuple(new_row, rid, target_rid, &old_row, txn);
+  }
+  if (updated) {
+    FreeExternalFields(old_row);
+  } else if (need_toast) {
+    FreeExternalFields(*toasted_row);
+  }
+  return updated;
+}
+
+bool TableHeap::UpdateTupleInPage(const Row &new_row, Row *old_row, RowId *target_rid, Transaction *txn) {
+  const RowId rid = old_row->GetRowId();
+  *target_rid = RowId();
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+  if (page == nullptr) {
+    return false;
+  }
+  uint32_t free_space = 0;
+  page->WLatch();
+  bool updated = VisitPage(page, [this, &new_row, old_row, target_rid, &rid, &free_space, txn](auto table_page) {
+    bool updated = table_page->UpdateTuple(new_row, old_row, schema_, txn, lock_manager_, log_manager_);
+    free_space = table_page->GetTotalFreeSpace();
+    if constexpr (std::is_same_v<decltype(table_page), TablePage *>) {
+      if (!updated && !table_page->GetForwardRid(rid, target_rid) && table_page->GetTupleData(rid) != nullptr) {
+        *target_rid = rid;
+      }
+    }
+    return updated;
+  });
+  if (updated && zone_map_ != nullptr) {
+    zone_map_->Update(rid.GetPageId(), new_row);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), updated);
+  if (updated) {
+    free_space_map_.Update(rid.GetPageId(), free_space);
+  }
+  return updated;
+}
+
+bool TableHeap::MoveTuple(const Row &new_row, const RowId &rid, const RowId &target_rid, Row *old_row,
+                          Transaction *txn) {
+  bool is_moved = !(target_rid == rid);
+  if (is_moved) {
+    // The tuple was moved before, update it where it is.
+    old_row->SetRowId(target_rid);
+    RowId next_rid;
+    if (UpdateTupleInPage(new_row, old_row, &next_rid, txn)) {
+      return true;
+    }
+    if (next_rid.GetPageId() == INVALID_PAGE_ID) {
+      return false;
+    }
+  }
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  // A moved tuple goes back to its home slot if it fits there, so forward chains never grow.
+  page->WLatch();
+  bool restored = is_moved && page->RestoreTuple(rid, new_row, schema_);
+  if (restored && zone_map_ != nullptr) {
+    zone_map_->Update(rid.GetPageId(), new_row);
+  }
+  uint32_t free_space = page->GetTotalFreeSpace();
+  page->WUnlatch();
+  if (!restored) {
+    // Otherwise the tuple is moved to another page, the page latch is not held meanwhile.
+    Row moved_row(new_row);
+    if (!PlaceTuple(moved_row, &rid, txn)) {
+      buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+      return false;
+    }
+    page->WLatch();
+    restored = page->ForwardTuple(rid, moved_row.GetRowId(), old_row, schema_);
+    free_space = page->GetTotalFreeSpace();
+    page->WUnlatch();
+    if (!restored) {
+      buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+      FreeSlot(moved_row.GetRowId(), nullptr, txn);
+      return false;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+  free_space_map_.Update(rid.GetPageId(), free_space);
+  if (is_moved) {
+    // Read the old values from the previous location of the tuple and free it.
+    FreeSlot(target_rid, old_row, txn);
+  }
+  return true;
 }
 
 void TableHeap::ApplyDelete(const RowId &rid, Transaction *txn) {
-  // Step1: Find the page which contains the tuple.
-  // Step2: Delete the tuple from the page.
+  // Step1: Free the forward record left in the home slot of a moved tuple.
+  RowId target_rid = GetTargetRid(rid);
+  if (!(target_rid == rid)) {
+    FreeSlot(rid, nullptr, txn);
+  }
+  // Step2: Delete the tuple from the page, the delete is finished once the tuple is gone so that the vacuum
+  // does not apply it again.
+  Row old_row(target_rid);
+  FreeSlot(target_rid, &old_row, txn, &rid);
+  // Step3: Release the overflow pages of the deleted values.
+  FreeExternalFields(old_row);
+}
 
+void TableHeap::FreeSlot(const RowId &rid, Row *old_row, Transaction *txn, const RowId *finished_rid) {
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
+  assert(page != nullptr);
+  page->WLatch();
+  uint32_t free_space = VisitPage(page, [this, &rid, old_row, txn](auto table_page) {
+    if (old_row != nullptr && has_char_column_) {
+      table_page->GetStoredTuple(old_row, schema_);
+    }
+    table_page->ApplyDelete(rid, txn, log_manager_);
+    return table_page->GetTotalFreeSpace();
+  });
+  if (finished_rid != nullptr) {
+    FinishDelete(*finished_rid);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+  free_space_map_.Update(rid.GetPageId(), free_space);
 }
 
-void TableHeap::RollbackDelete(const RowId &rid, Transaction *txn) {
-  // Find the page which contains the tuple.
+RowId TableHeap::GetTargetRid(const RowId &rid) {
+  if (format_ == kPaxFormat) {
+    return rid;
+  }
   auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(rid.GetPageId()));
+  if (page == nullptr) {
+    return rid;
+  }
+  RowId target_rid = rid;
+  page->RLatch();
+  page->GetForwardRid(rid, &target_rid);
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), false);
+  return target_rid;
+}
+
+void TableHeap::RollbackDelete(const RowId &home_rid, Transaction *txn) {
+  // Find the page which contains the tuple.
+  RowId rid = GetTargetRid(home_rid);
+  auto page = buffer_pool_manager_->FetchPage(rid.GetPageId());
   assert(page != nullptr);
-  // Rollback the delete.
+  // Rollback the delete, it is finished under the page latch as in MarkDelete.
+  page->WLatch();
+  VisitPage(page, [this, &rid, txn](auto table_page) { table_page->RollbackDelete(rid, txn, log_manager_); });
+  FinishDelete(home_rid);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(rid.GetPageId(), true);
+}
+
+std::vector<page_id_t> TableHeap::FreeHeap() {
+  ReleaseUnlinkedPages();
+  append_tails_.clear();
+  append_page_ids_.clear();
+  free_space_map_.Free();
+  if (zone_map_ != nullptr) {
+    zone_map_->Clear();
+  }
+  for (auto &dictionary : dictionaries_) {
+    if (dictionary != nullptr) {
+      dictionary->Free();
+    }
+  }
+  std::vector<page_id_t> pinned_page_ids;
+  std::vector<page_id_t> page_ids;
+  // unlinked pages not released yet are deallocated with the chain, or returned if they are still pinned
+  {
+    std::scoped_lock<std::mutex> lock(vacuum_latch_);
+    for (auto &unlinked_page : unlinked_pages_) {
+      page_ids.push_back(unlinked_page.first);
+    }
+    unlinked_pages_.clear();
+  }
+  auto delete_pages = [this, &page_ids, &pinned_page_ids]() {
+    auto pinned = buffer_pool_manager_->DeletePages(page_ids);
+    pinned_page_ids.insert(pinned_page_ids.end(), pinned.begin(), pinned.end());
+    page_ids.clear();
+  };
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch table page.");
+    std::vector<page_id_t> overflow_page_ids;
+    page_id_t next_page_id = VisitPage(page, [this, page_id, &overflow_page_ids](auto table_page) {
+      for (uint32_t slot_num = 0; has_char_column_ && slot_num < table_page->GetTupleCount(); slot_num++) {
+        Row row(RowId(page_id, slot_num));
+        if (!table_page->GetStoredTuple(&row, schema_)) {
+          continue;
+        }
+        for (auto field : row.GetFields()) {
+          if (field->IsExternal()) {
+            overflow_page_ids.push_back(field->GetExternalPageId());
+          }
+        }
+      }
+      return table_page->GetNextPageId();
+    });
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_ids.push_back(page_id);
+    for (auto overflow_page_id : overflow_page_ids) {
+      CollectOverflowPages(overflow_page_id, page_ids);
+    }
+    if (page_ids.size() >= FREE_BATCH_SIZE) {
+      delete_pages();
+    }
+    page_id = next_page_id;
+  }
+  delete_pages();
+  first_page_id_ = INVALID_PAGE_ID;
+  return pinned_page_ids;
+}
+
+std::vector<page_id_t> TableHeap::TakePagesWithDeletes(size_t max) {
+  ReleaseUnlinkedPages();
+  std::scoped_lock<std::mutex> lock(vacuum_latch_);
+  std::unordered_set<page_id_t> running_page_ids;
+  for (auto &running_delete : running_deletes_) {
+    running_page_ids.insert(running_delete.second);
+  }
+  std::vector<page_id_t> page_ids;
+  for (auto iter = pages_with_deletes_.begin(); iter != pages_with_deletes_.end() && page_ids.size() < max;) {
+    if (running_page_ids.count(*iter) > 0) {
+      ++iter;
+      continue;
+    }
+    page_ids.push_back(*iter);
+    iter = pages_with_deletes_.erase(iter);
+  }
+  return page_ids;
+}
+
+void TableHeap::FinishDelete(const RowId &rid) {
+  std::scoped_lock<std::mutex> lock(vacuum_latch_);
+  running_deletes_.erase(rid.Get());
+}
+
+void TableHeap::VacuumPage(page_id_t page_id, VacuumStats &stats, Transaction *txn) {
+  ReleaseUnlinkedPages();
+  auto page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    return;
+  }
+  // Step1: Apply the deletes of the tuples stored in the page. A moved tuple is deleted later, together with the
+  // forward record in its home slot.
   page->WLatch();
-  page->RollbackDelete(rid, txn, log_manager_);
+  std::vector<RowId> rids;
+  std::vector<RowId> moved_rids;
+  std::vector<Row> old_rows;
+  uint32_t old_free_space = 0;
+  uint32_t free_space = 0;
+  VisitPage(page, [&](auto table_page) {
+    old_free_space = table_page->GetTotalFreeSpace();
+    rids = table_page->GetDeletedRids();
+    // Tuples marked by transactions which are still running are left, their deletes may be rolled back. The
+    // page may have been taken before they were marked, it is vacuumed again once they are finished.
+    {
+      std::scoped_lock<std::mutex> lock(vacuum_latch_);
+      auto iter = std::remove_if(rids.begin(), rids.end(), [this](const RowId &rid) {
+        return running_deletes_.count(rid.Get()) > 0;
+      });
+      if (iter != rids.end()) {
+        rids.erase(iter, rids.end());
+        pages_with_deletes_.insert(page_id);
+      }
+    }
+    old_rows.reserve(has_char_column_ ? rids.size() : 0);
+    for (auto &rid : rids) {
+      if (rid.GetPageId() != page_id) {
+        moved_rids.push_back(rid);
+        continue;
+      }
+      if (has_char_column_) {
+        old_rows.emplace_back(rid);
+        table_page->GetStoredTuple(&old_rows.back(), schema_);
+      }
+      table_page->ApplyDelete(rid, txn, log_manager_);
+    }
+  });
   page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  for (auto &old_row : old_rows) {
+    FreeExternalFields(old_row);
+  }
+  for (auto &rid : moved_rids) {
+    ApplyDelete(rid, txn);
+  }
+  // Step2: Compact the page, zones are not narrowed on delete so the zone of the page is rebuilt.
+  page->WLatch();
+  bool is_empty = VisitPage(page, [this, page_id, &free_space](auto table_page) {
+    if constexpr (std::is_same_v<decltype(table_page), PaxPage *>) {
+      table_page->CompactCharData(schema_);
+    } else {
+      table_page->Compact();
+    }
+    free_space = table_page->GetTotalFreeSpace();
+    if (zone_map_ != nullptr) {
+      zone_map_->Remove(page_id);
+      RowView row(schema_);
+      RowId rid;
+      for (bool found = table_page->GetFirstTupleRid(&rid); found;) {
+        table_page->GetTupleView(rid, row);
+        zone_map_->Update(page_id, row);
+        RowId next_rid;
+        found = table_page->GetNextTupleRid(rid, &next_rid);
+        rid = next_rid;
+      }
+    }
+    return table_page->IsEmpty();
+  });
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  free_space_map_.Update(page_id, free_space);
+  stats.page_count_++;
+  stats.tuple_count_ += rids.size();
+  stats.reclaimed_size_ += free_space > old_free_space ? free_space - old_free_space : 0;
+  // Step3: Release the page if nothing is left in it.
+  if (is_empty && page_id != first_page_id_ && UnlinkPage(page_id)) {
+    stats.released_page_count_++;
+  }
 }
 
-void TableHeap::FreeHeap() {
+bool TableHeap::UnlinkPage(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(append_latch_);
+  // pages of the tails in append mode are kept even if they are empty
+  if (append_page_ids_.count(page_id) > 0) {
+    return false;
+  }
+  // Inserts no longer find the page in the map. An insert which found it before holds a pin on it, so it is not
+  // released under the insert, which sees it unlinked once it latches it.
+  free_space_map_.Remove(page_id);
+  auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  ASSERT(page != nullptr, "Failed to fetch table page.");
+  page->RLatch();
+  page_id_t prev_page_id = page->GetPrevPageId();
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  // The chain only changes under the append latch. Pages are latched in chain order, prev and next page ids
+  // are at the same offsets in pages of both formats.
+  auto prev_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(prev_page_id));
+  ASSERT(prev_page != nullptr, "Failed to fetch table page.");
+  TablePage *next_page = nullptr;
+  if (next_page_id != INVALID_PAGE_ID) {
+    next_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    ASSERT(next_page != nullptr, "Failed to fetch table page.");
+  }
+  prev_page->WLatch();
+  page->WLatch();
+  if (next_page != nullptr) {
+    next_page->WLatch();
+  }
+  bool is_empty = VisitPage(page, [](auto table_page) { return table_page->IsEmpty(); });
+  uint32_t free_space = VisitPage(page, [](auto table_page) { return table_page->GetTotalFreeSpace(); });
+  if (is_empty) {
+    prev_page->SetNextPageId(next_page_id);
+    if (next_page != nullptr) {
+      next_page->SetPrevPageId(prev_page_id);
+    }
+    // the next page id is kept for the readers still on the page, see IsUnlinked
+    page->SetPrevPageId(INVALID_PAGE_ID);
+  }
+  if (next_page != nullptr) {
+    next_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(next_page_id, is_empty);
+  }
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, is_empty);
+  prev_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(prev_page_id, is_empty);
+  if (!is_empty) {
+    free_space_map_.Add(page_id, free_space);
+    return false;
+  }
+  if (zone_map_ != nullptr) {
+    zone_map_->Remove(page_id);
+  }
+  // A reader may still hold a pin on the page or move to it from a page it is on, then it is released later.
+  std::scoped_lock<std::mutex> vacuum_lock(vacuum_latch_);
+  pages_with_deletes_.erase(page_id);
+  uint64_t epoch = ++epoch_;
+  bool is_reachable = !reader_epochs_.empty() && *reader_epochs_.begin() < epoch;
+  if (is_reachable || !buffer_pool_manager_->DeletePage(page_id)) {
+    unlinked_pages_.emplace_back(page_id, epoch);
+  }
+  return true;
+}
+
+void TableHeap::ReleaseUnlinkedPages() {
+  std::scoped_lock<std::mutex> lock(vacuum_latch_);
+  // readers registered since a page was unlinked can not reach it
+  uint64_t min_epoch = reader_epochs_.empty() ? UINT64_MAX : *reader_epochs_.begin();
+  auto iter = std::remove_if(unlinked_pages_.begin(), unlinked_pages_.end(), [this, min_epoch](auto &page) {
+    return min_epoch >= page.second && buffer_pool_manager_->DeletePage(page.first);
+  });
+  unlinked_pages_.erase(iter, unlinked_pages_.end());
+}
+
+uint64_t TableHeap::EnterEpoch() {
+  std::scoped_lock<std::mutex> lock(vacuum_latch_);
+  reader_epochs_.insert(epoch_);
+  return epoch_;
+}
+
+void TableHeap::EnterEpoch(uint64_t epoch) {
+  std::scoped_lock<std::mutex> lock(vacuum_latch_);
+  reader_epochs_.insert(epoch);
+}
+
+void TableHeap::ExitEpoch(uint64_t epoch) {
+  std::scoped_lock<std::mutex> lock(vacuum_latch_);
+  reader_epochs_.erase(reader_epochs_.find(epoch));
+}
+
+void TableHeap::RebuildFreeSpaceMap() {
+  std::scoped_lock<std::mutex> lock(append_latch_);
+  // the free space map page id is at the same offset in pages of both formats
+  auto first_page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  ASSERT(first_page != nullptr, "Failed to fetch the first page of table heap.");
+  page_id_t map_page_id = first_page->GetFreeSpaceMapPageId();
+  if (map_page_id == INVALID_PAGE_ID) {
+    first_page->SetFreeSpaceMapPageId(free_space_map_.Create(GetFileId()));
+  } else {
+    free_space_map_.Open(map_page_id);
+    free_space_map_.Clear();
+  }
+  buffer_pool_manager_->UnpinPage(first_page_id_, map_page_id == INVALID_PAGE_ID);
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = reinterpret_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    ASSERT(page != nullptr, "Failed to fetch table page.");
+    page->RLatch();
+    uint32_t free_space = VisitPage(page, [](auto table_page) { return table_page->GetTotalFreeSpace(); });
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    free_space_map_.Add(page_id, free_space);
+    page_id = next_page_id;
+  }
+}
+
+void TableHeap::EnableZoneMap(const std::vector<uint32_t> &columns) {
+  auto zone_map = std::make_unique<ZoneMap>(schema_, columns);
+  RowView row(schema_);
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch table page.");
+    page->RLatch();
+    page_id_t next_page_id = VisitPage(page, [page_id, &row, &zone_map](auto table_page) {
+      RowId rid;
+      bool found = table_page->GetFirstTupleRid(&rid);
+      while (found) {
+        table_page->GetTupleView(rid, row);
+        zone_map->Update(page_id, row);
+        RowId next_rid;
+        found = table_page->GetNextTupleRid(rid, &next_rid);
+        rid = next_rid;
+      }
+      return table_page->GetNextPageId();
+    });
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  zone_map_ = std::move(zone_map);
+}
 
+page_id_t TableHeap::EnableDictionary(uint32_t column) {
+  ASSERT(schema_->GetColumn(column)->GetType() == TypeId::kTypeChar, "Only char columns can be encoded.");
+  dictionaries_.resize(schema_->GetColumnCount());
+  dictionaries_[column] = std::make_unique<ColumnDictionary>(buffer_pool_manager_);
+  return dictionaries_[column]->Create(GetFileId());
+}
+
+void TableHeap::OpenDictionary(uint32_t column, page_id_t first_page_id) {
+  ASSERT(schema_->GetColumn(column)->GetType() == TypeId::kTypeChar, "Only char columns can be encoded.");
+  dictionaries_.resize(schema_->GetColumnCount());
+  dictionaries_[column] = std::make_unique<ColumnDictionary>(buffer_pool_manager_);
+  dictionaries_[column]->Open(first_page_id);
 }
 
 bool TableHeap::GetTuple(Row *row, Transaction *txn) {
-  return false;
+  static const std::vector<uint32_t> no_columns;
+  if (!GetTuple(row, no_columns, txn)) {
+    return false;
+  }
+  for (uint32_t i = 0; i < row->GetFieldCount(); i++) {
+    Field *field = row->GetField(i);
+    if (!field->IsFetched() && !FetchField(field, i)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool TableHeap::GetTuple(Row *row, const std::vector<uint32_t> &columns, Transaction *txn) {
+  auto page = buffer_pool_manager_->FetchPage(row->GetRowId().GetPageId());
+  if (page == nullptr) {
+    return false;
+  }
+  page->RLatch();
+  bool found = VisitPage(page, [this, row, txn](auto table_page) {
+    return table_page->GetTuple(row, schema_, txn, lock_manager_);
+  });
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(row->GetRowId().GetPageId(), false);
+  if (!found && format_ == kRowFormat) {
+    // Follow the forward record of a moved tuple, the row keeps the rid of its home slot.
+    RowId home_rid = row->GetRowId();
+    RowId target_rid = GetTargetRid(home_rid);
+    if (!(target_rid == home_rid)) {
+      row->SetRowId(target_rid);
+      found = GetTuple(row, columns, txn);
+      row->SetRowId(home_rid);
+      return found;
+    }
+  }
+  if (found) {
+    for (auto column : columns) {
+      Field *field = row->GetField(column);
+      if (!field->IsFetched() && !FetchField(field, column)) {
+        return false;
+      }
+    }
+  }
+  return found;
+}
+
+bool TableHeap::FetchField(Field *field) {
+  ASSERT(!field->IsFetched(), "Value is already fetched.");
+  char *data = new char[field->GetLength()];
+  uint32_t offset = 0;
+  page_id_t page_id = field->GetExternalPageId();
+  while (page_id != INVALID_PAGE_ID && offset < field->GetLength()) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      break;
+    }
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    page->RLatch();
+    uint32_t size = std::min(overflow_page->GetDataSize(), field->GetLength() - offset);
+    memcpy(data + offset, overflow_page->GetData(), size);
+    offset += size;
+    page_id_t next_page_id = overflow_page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  if (offset < field->GetLength()) {
+    delete[] data;
+    return false;
+  }
+  field->SetFetchedData(data);
+  return true;
+}
+
+bool TableHeap::ToastRow(Row &row, Transaction *txn) {
+  uint32_t max_row_size = TablePage::GetMaxRowSize(buffer_pool_manager_->GetPageSize());
+  if (!has_char_column_) {
+    return row.GetSerializedSize(schema_) <= max_row_size;
+  }
+  // values stored out of line for another tuple are written again, tuples never share overflow pages
+  for (auto field : row.GetFields()) {
+    if (field->IsExternal()) {
+      if (!field->IsFetched() && !FetchField(field)) {
+        return false;
+      }
+      field->ClearExternal();
+    }
+  }
+  EncodeRow(row);
+  uint32_t serialized_size = row.GetSerializedSize(schema_);
+  while (serialized_size > max_row_size / 4) {
+    Field *longest = nullptr;
+    for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+      Field *field = row.GetField(i);
+      if (schema_->GetColumn(i)->GetType() == TypeId::kTypeChar && !field->IsNull() && !field->IsExternal() &&
+          field->GetLength() >= TOAST_MIN_LENGTH && (longest == nullptr || field->GetLength() > longest->GetLength())) {
+        longest = field;
+      }
+    }
+    if (longest == nullptr) {
+      break;
+    }
+    page_id_t page_id = WriteOverflowPages(longest->GetData(), longest->GetLength());
+    if (page_id == INVALID_PAGE_ID) {
+      FreeExternalFields(row);
+      return false;
+    }
+    serialized_size -= longest->GetSerializedSize();
+    longest->SetExternal(page_id);
+    serialized_size += longest->GetSerializedSize();
+  }
+  if (serialized_size > max_row_size) {
+    FreeExternalFields(row);
+    return false;
+  }
+  return true;
+}
+
+void TableHeap::EncodeRow(Row &row) {
+  for (uint32_t i = 0; i < row.GetFieldCount(); i++) {
+    Field *field = row.GetField(i);
+    if (field->IsEncoded()) {
+      ASSERT(field->IsFetched(), "Value encoded in another dictionary is not decoded.");
+      field->ClearEncoded();
+    }
+    ColumnDictionary *dictionary = GetDictionary(i);
+    if (dictionary != nullptr && !field->IsNull()) {
+      uint32_t code = dictionary->Encode(field->GetData(), field->GetLength());
+      if (code != ColumnDictionary::INVALID_CODE) {
+        field->SetEncoded(code);
+      }
+    }
+  }
+}
+
+void TableHeap::RestoreRow(Row &row) {
+  if (!has_char_column_) {
+    return;
+  }
+  for (auto field : row.GetFields()) {
+    if (field->IsEncoded()) {
+      field->ClearEncoded();
+    } else if (field->IsExternal()) {
+      field->ClearExternal();
+    }
+  }
+}
+
+void TableHeap::FreeExternalFields(Row &row) {
+  for (auto field : row.GetFields()) {
+    if (field->IsExternal()) {
+      FreeOverflowPages(field->GetExternalPageId());
+      if (field->IsFetched()) {
+        field->ClearExternal();
+      }
+    }
+  }
+}
+
+page_id_t TableHeap::WriteOverflowPages(const char *data, uint32_t len) {
+  uint32_t max_data_size = OverflowPage::GetMaxDataSize(buffer_pool_manager_->GetPageSize());
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  OverflowPage *prev_page = nullptr;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  uint32_t offset = 0;
+  while (offset < len) {
+    page_id_t page_id;
+    auto page = buffer_pool_manager_->NewPage(page_id, GetFileId());
+    if (page == nullptr) {
+      break;
+    }
+    auto overflow_page = reinterpret_cast<OverflowPage *>(page->GetData());
+    overflow_page->Init();
+    uint32_t size = std::min(max_data_size, len - offset);
+    memcpy(overflow_page->GetData(), data + offset, size);
+    overflow_page->SetDataSize(size);
+    offset += size;
+    if (prev_page == nullptr) {
+      first_page_id = page_id;
+    } else {
+      prev_page->SetNextPageId(page_id);
+      buffer_pool_manager_->UnpinPage(prev_page_id, true);
+    }
+    prev_page = overflow_page;
+    prev_page_id = page_id;
+  }
+  if (prev_page != nullptr) {
+    buffer_pool_manager_->UnpinPage(prev_page_id, true);
+  }
+  if (offset < len) {
+    FreeOverflowPages(first_page_id);
+    return INVALID_PAGE_ID;
+  }
+  return first_page_id;
+}
+
+void TableHeap::FreeOverflowPages(page_id_t page_id) {
+  std::vector<page_id_t> page_ids;
+  CollectOverflowPages(page_id, page_ids);
+  buffer_pool_manager_->DeletePages(page_ids);
+}
+
+void TableHeap::CollectOverflowPages(page_id_t page_id, std::vector<page_id_t> &page_ids) {
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager_->FetchPage(page_id);
+    if (page == nullptr) {
+      return;
+    }
+    page_id_t next_page_id = reinterpret_cast<OverflowPage *>(page->GetData())->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_ids.push_back(page_id);
+    page_id = next_page_id;
+  }
 }
 
 TableIterator TableHeap::Begin(Transaction *txn) {
-  return TableIterator();
+  return TableIterator(this, first_page_id_, txn);
+}
+
+TableIterator TableHeap::Begin(Transaction *txn, const ScanPredicate *predicate,
+                               const std::vector<uint32_t> &columns) {
+  return TableIterator(this, first_page_id_, txn, predicate, &columns);
 }
 
 TableIterator TableHeap::End() {
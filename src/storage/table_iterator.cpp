@@ -1,39 +1,223 @@
+#include <algorithm>
+
 #include "common/macros.h"
 #include "storage/table_iterator.h"
 #include "storage/table_heap.h"
 
-TableIterator::TableIterator() {
+TableIterator::TableIterator() = default;
 
+TableIterator::TableIterator(TableHeap *table_heap, page_id_t page_id, Transaction *txn,
+                             const ScanPredicate *predicate, const std::vector<uint32_t> *columns)
+        : table_heap_(table_heap), txn_(txn), predicate_(predicate), is_projected_(columns != nullptr) {
+  if (columns != nullptr) {
+    columns_ = *columns;
+    std::sort(columns_.begin(), columns_.end());
+    columns_.erase(std::unique(columns_.begin(), columns_.end()), columns_.end());
+  }
+  epoch_ = table_heap_->EnterEpoch();
+  SeekPage(page_id);
 }
 
-TableIterator::TableIterator(const TableIterator &other) {
+TableIterator::TableIterator(const TableIterator &other)
+        : table_heap_(other.table_heap_), rid_(other.rid_), txn_(other.txn_), predicate_(other.predicate_),
+          is_projected_(other.is_projected_), columns_(other.columns_),
+          skipped_page_count_(other.skipped_page_count_), epoch_(other.epoch_) {
+  if (IsRegistered()) {
+    table_heap_->EnterEpoch(epoch_);
+  }
+  if (other.is_row_read_) {
+    row_ = new Row(*other.row_);
+    is_row_read_ = true;
+  }
+}
 
+TableIterator &TableIterator::operator=(const TableIterator &other) {
+  if (this != &other) {
+    ResetRow();
+    if (IsRegistered()) {
+      table_heap_->ExitEpoch(epoch_);
+    }
+    if (other.IsRegistered()) {
+      other.table_heap_->EnterEpoch(other.epoch_);
+    }
+    table_heap_ = other.table_heap_;
+    epoch_ = other.epoch_;
+    rid_ = other.rid_;
+    txn_ = other.txn_;
+    predicate_ = other.predicate_;
+    is_projected_ = other.is_projected_;
+    columns_ = other.columns_;
+    skipped_page_count_ = other.skipped_page_count_;
+    if (other.is_row_read_) {
+      delete row_;
+      row_ = new Row(*other.row_);
+      is_row_read_ = true;
+    }
+  }
+  return *this;
 }
 
 TableIterator::~TableIterator() {
-
+  if (IsRegistered()) {
+    table_heap_->ExitEpoch(epoch_);
+  }
+  delete row_;
 }
 
 bool TableIterator::operator==(const TableIterator &itr) const {
-  return false;
+  return rid_ == itr.rid_;
 }
 
 bool TableIterator::operator!=(const TableIterator &itr) const {
-  return false;
+  return !(*this == itr);
 }
 
 const Row &TableIterator::operator*() {
-  ASSERT(false, "Not implemented yet.");
+  return *operator->();
 }
 
 Row *TableIterator::operator->() {
-  return nullptr;
+  ASSERT(rid_.GetPageId() != INVALID_PAGE_ID, "Access the end iterator.");
+  if (!is_row_read_) {
+    if (row_ == nullptr) {
+      row_ = new Row(rid_);
+    } else {
+      row_->Reset(rid_);
+    }
+    ReadRow();
+    is_row_read_ = true;
+  }
+  return row_;
 }
 
 TableIterator &TableIterator::operator++() {
+  ASSERT(rid_.GetPageId() != INVALID_PAGE_ID, "Increase the end iterator.");
+  ResetRow();
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  page_id_t page_id = rid_.GetPageId();
+  auto page = buffer_pool_manager->FetchPage(page_id);
+  ASSERT(page != nullptr, "Failed to fetch table page.");
+  page->RLatch();
+  RowId next_rid;
+  page_id_t next_page_id = INVALID_PAGE_ID;
+  bool found = table_heap_->VisitPage(page, [this, &next_rid, &next_page_id](auto table_page) {
+    next_page_id = table_page->GetNextPageId();
+    return table_page->FindTupleRid(rid_.GetSlotNum() + 1, predicate_, table_heap_->schema_, &next_rid);
+  });
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(page_id, false);
+  if (found) {
+    rid_ = next_rid;
+  } else {
+    SeekPage(next_page_id);
+  }
   return *this;
 }
 
 TableIterator TableIterator::operator++(int) {
-  return TableIterator();
+  TableIterator old(*this);
+  ++(*this);
+  return old;
+}
+
+size_t TableIterator::NextBatch(RowBatch &batch, size_t max) {
+  batch.Clear();
+  if (max == 0) {
+    return 0;
+  }
+  ResetRow();
+  // tuples may be deleted after the iterator moved to them, go on to the next page if none is left
+  while (batch.IsEmpty() && rid_.GetPageId() != INVALID_PAGE_ID) {
+    BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+    page_id_t page_id = rid_.GetPageId();
+    auto page = buffer_pool_manager->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch table page.");
+    page->RLatch();
+    RowId rid = rid_;
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    bool found = table_heap_->VisitPage(page, [this, &batch, max, &rid, &next_page_id](auto table_page) {
+      RowView row(table_heap_->schema_);
+      bool found = true;
+      while (found && batch.GetRowCount() < max) {
+        if (table_page->GetTupleView(rid, row)) {
+          batch.Append(row, is_projected_ ? &columns_ : nullptr);
+        }
+        RowId next_rid;
+        found = table_page->FindTupleRid(rid.GetSlotNum() + 1, predicate_, table_heap_->schema_, &next_rid);
+        rid = next_rid;
+      }
+      next_page_id = table_page->GetNextPageId();
+      return found;
+    });
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    if (found) {
+      rid_ = rid;
+    } else {
+      SeekPage(next_page_id);
+    }
+  }
+  // values stored out of line are read, and encoded values decoded, after the page is released
+  for (uint32_t column = 0; column < batch.column_count_; column++) {
+    for (size_t i = column; i < batch.fields_.size(); i += batch.column_count_) {
+      if (!batch.fields_[i]->IsFetched()) {
+        table_heap_->FetchField(batch.fields_[i], column);
+      }
+    }
+  }
+  return batch.GetRowCount();
+}
+
+void TableIterator::SeekPage(page_id_t page_id) {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  ZoneMap *zone_map = table_heap_->GetZoneMap();
+  while (page_id != INVALID_PAGE_ID) {
+    auto page = buffer_pool_manager->FetchPage(page_id);
+    ASSERT(page != nullptr, "Failed to fetch table page.");
+    page->RLatch();
+    // a page whose zone can not satisfy the predicate is only read for the next page id
+    bool is_skipped = predicate_ != nullptr && zone_map != nullptr && !zone_map->MayMatch(page_id, *predicate_);
+    skipped_page_count_ += is_skipped;
+    page_id_t next_page_id = INVALID_PAGE_ID;
+    bool found = table_heap_->VisitPage(page, [this, is_skipped, &next_page_id](auto table_page) {
+      next_page_id = table_page->GetNextPageId();
+      return !is_skipped && table_page->FindTupleRid(0, predicate_, table_heap_->schema_, &rid_);
+    });
+    page->RUnlatch();
+    buffer_pool_manager->UnpinPage(page_id, false);
+    if (found) {
+      return;
+    }
+    page_id = next_page_id;
+  }
+  // the end iterator moves to no page
+  table_heap_->ExitEpoch(epoch_);
+  rid_ = INVALID_ROWID;
+}
+
+void TableIterator::ReadRow() {
+  BufferPoolManager *buffer_pool_manager = table_heap_->buffer_pool_manager_;
+  auto page = buffer_pool_manager->FetchPage(rid_.GetPageId());
+  ASSERT(page != nullptr, "Failed to fetch table page.");
+  page->RLatch();
+  RowView row(table_heap_->schema_);
+  if (table_heap_->VisitPage(page, [this, &row](auto table_page) { return table_page->GetTupleView(rid_, row); })) {
+    if (is_projected_) {
+      row.Materialize(row_, columns_);
+    } else {
+      row.Materialize(row_);
+    }
+  }
+  page->RUnlatch();
+  buffer_pool_manager->UnpinPage(rid_.GetPageId(), false);
+  // values stored out of line are read, and encoded values decoded, after the page is released
+  for (uint32_t i = 0; i < row_->GetFieldCount(); i++) {
+    if (!row_->GetField(i)->IsFetched()) {
+      table_heap_->FetchField(row_->GetField(i), i);
+    }
+  }
+}
+
+void TableIterator::ResetRow() {
+  is_row_read_ = false;
 }
@@ -0,0 +1,64 @@
+#include "storage/vacuum_worker.h"
+
+void VacuumWorker::Start() {
+  ASSERT(!thread_.joinable(), "Vacuum worker is already started.");
+  thread_ = std::thread([this] { Run(); });
+}
+
+void VacuumWorker::Stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    stop_requested_ = true;
+  }
+  stop_cv_.notify_all();
+  thread_.join();
+  std::scoped_lock<std::mutex> lock(latch_);
+  stop_requested_ = false;
+}
+
+size_t VacuumWorker::RunPass(Transaction *txn) {
+  size_t page_count = 0;
+  while (true) {
+    auto page_ids = table_heap_->TakePagesWithDeletes(options_.round_page_count_);
+    if (page_ids.empty()) {
+      break;
+    }
+    VacuumStats stats;
+    for (auto page_id : page_ids) {
+      table_heap_->VacuumPage(page_id, stats, txn);
+    }
+    page_count += page_ids.size();
+    // pages left are taken by the next pass if the worker is stopped
+    std::unique_lock<std::mutex> lock(latch_);
+    stats_ += stats;
+    if (stop_cv_.wait_for(lock, options_.round_delay_, [this] { return stop_requested_; })) {
+      break;
+    }
+  }
+  std::scoped_lock<std::mutex> lock(latch_);
+  pass_count_++;
+  return page_count;
+}
+
+VacuumStats VacuumWorker::GetStats() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return stats_;
+}
+
+size_t VacuumWorker::GetPassCount() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  return pass_count_;
+}
+
+void VacuumWorker::Run() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (!stop_requested_) {
+    lock.unlock();
+    RunPass(nullptr);
+    lock.lock();
+    stop_cv_.wait_for(lock, options_.interval_, [this] { return stop_requested_; });
+  }
+}
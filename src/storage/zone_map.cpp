@@ -0,0 +1,126 @@
+#include "storage/zone_map.h"
+
+ZoneMap::ZoneMap(Schema *schema, const std::vector<uint32_t> &columns)
+        : columns_(columns), zone_of_(schema->GetColumnCount(), -1) {
+  for (size_t i = 0; i < columns_.size(); i++) {
+    ASSERT(columns_[i] < schema->GetColumnCount(), "Column out of range.");
+    zone_of_[columns_[i]] = static_cast<int>(i);
+  }
+}
+
+void ZoneMap::Update(page_id_t page_id, const Row &row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &zones = GetZones(page_id);
+  for (size_t i = 0; i < columns_.size(); i++) {
+    Widen(zones[i], *row.GetField(columns_[i]));
+  }
+}
+
+void ZoneMap::Update(page_id_t page_id, const RowView &row) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto &zones = GetZones(page_id);
+  for (size_t i = 0; i < columns_.size(); i++) {
+    Widen(zones[i], row.GetField(columns_[i]));
+  }
+}
+
+bool ZoneMap::MayMatch(page_id_t page_id, const ScanPredicate &predicate) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto it = zones_.find(page_id);
+  if (it == zones_.end()) {
+    return false;
+  }
+  for (auto &comparison : predicate.comparisons_) {
+    int zone = zone_of_[comparison.column_];
+    if (zone >= 0 && !MayMatch(it->second[zone], comparison)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void ZoneMap::Remove(page_id_t page_id) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  zones_.erase(page_id);
+}
+
+void ZoneMap::Clear() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  zones_.clear();
+}
+
+std::vector<ZoneMap::Zone> &ZoneMap::GetZones(page_id_t page_id) {
+  auto &zones = zones_[page_id];
+  if (zones.empty()) {
+    zones.resize(columns_.size());
+  }
+  return zones;
+}
+
+void ZoneMap::Widen(Zone &zone, const Field &value) {
+  if (value.IsNull()) {
+    zone.has_null_ = true;
+    return;
+  }
+  zone.has_value_ = true;
+  if (!zone.is_bounded_) {
+    return;
+  }
+  if (value.IsExternal() || !value.IsFetched()) {
+    zone.is_bounded_ = false;
+    return;
+  }
+  bool is_min = zone.min_.IsNull() || value.Compare(zone.min_) < 0;
+  bool is_max = zone.max_.IsNull() || value.Compare(zone.max_) > 0;
+  if (!is_min && !is_max) {
+    return;
+  }
+  // keep a copy of the value, which may refer to a page
+  bool is_char = value.GetTypeId() == TypeId::kTypeChar;
+  if (is_min) {
+    Field copy = is_char ? Field(TypeId::kTypeChar, const_cast<char *>(value.GetData()), value.GetLength(), true)
+                         : Field(value);
+    Swap(zone.min_, copy);
+  }
+  if (is_max) {
+    Field copy = is_char ? Field(TypeId::kTypeChar, const_cast<char *>(value.GetData()), value.GetLength(), true)
+                         : Field(value);
+    Swap(zone.max_, copy);
+  }
+}
+
+bool ZoneMap::MayMatch(const Zone &zone, const ScanPredicate::Comparison &comparison) {
+  const Field &value = comparison.value_;
+  switch (comparison.op_) {
+    case ScanPredicate::kIsNull:
+      return zone.has_null_;
+    case ScanPredicate::kNotNull:
+      return zone.has_value_;
+    default:
+      break;
+  }
+  if (value.IsNull() || !zone.has_value_) {
+    return false;
+  }
+  if (!zone.is_bounded_) {
+    return true;
+  }
+  switch (comparison.op_) {
+    case ScanPredicate::kEqual:
+      return zone.min_.CompareLessThanEquals(value) == CmpBool::kTrue &&
+             zone.max_.CompareGreaterThanEquals(value) == CmpBool::kTrue;
+    case ScanPredicate::kNotEqual:
+      return zone.min_.CompareNotEquals(value) == CmpBool::kTrue ||
+             zone.max_.CompareNotEquals(value) == CmpBool::kTrue;
+    case ScanPredicate::kLessThan:
+      return zone.min_.CompareLessThan(value) == CmpBool::kTrue;
+    case ScanPredicate::kLessThanEquals:
+      return zone.min_.CompareLessThanEquals(value) == CmpBool::kTrue;
+    case ScanPredicate::kGreaterThan:
+      return zone.max_.CompareGreaterThan(value) == CmpBool::kTrue;
+    case ScanPredicate::kGreaterThanEquals:
+      return zone.max_.CompareGreaterThanEquals(value) == CmpBool::kTrue;
+    default:
+      return true;
+  }
+}
@@ -1,6 +1,7 @@
 #include <cstdio>
 #include <random>
 #include <string>
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
@@ -70,4 +71,61 @@ TEST(BufferPoolManagerTest, BinaryDataTest) {
 
   delete bpm;
   delete disk_manager;
-}
\ No newline at end of file
+}
+TEST(BufferPoolManagerTest, TablespaceTest) {
+  const std::string db_name = "bpm_test.db";
+  const std::string tablespace_name = "bpm_test.db.ts";
+  const size_t buffer_pool_size = 4;
+  const file_id_t tablespace_id = 1;
+
+  remove(db_name.c_str());
+  remove(tablespace_name.c_str());
+  auto *disk_manager = new DiskManager(db_name);
+  auto *tablespace_manager = new DiskManager(tablespace_name);
+  auto *bpm = new BufferPoolManager(buffer_pool_size, disk_manager);
+  bpm->AddDiskManager(tablespace_id, tablespace_manager);
+
+  // Scenario: pages of both files are allocated from their own files, ids are namespaced by file id
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 8; i++) {
+    page_id_t page_id;
+    file_id_t file_id = i % 2 == 0 ? DEFAULT_FILE_ID : tablespace_id;
+    auto *page = bpm->NewPage(page_id, file_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(file_id, GetFileId(page_id));
+    EXPECT_EQ(i / 2, GetLocalPageId(page_id));
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", i);
+    page_ids.push_back(page_id);
+    EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  }
+  EXPECT_FALSE(disk_manager->IsPageFree(3));
+  EXPECT_TRUE(disk_manager->IsPageFree(4));
+  EXPECT_FALSE(tablespace_manager->IsPageFree(3));
+
+  // Scenario: evicted pages are read back from the file they belong to
+  for (int i = 0; i < 8; i++) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_TRUE(bpm->UnpinPage(page_ids[i], false));
+  }
+
+  // Scenario: pages flushed in parallel land in the right files
+  bpm->FlushAllPages();
+  char data[PAGE_SIZE];
+  tablespace_manager->ReadPage(GetLocalPageId(page_ids[7]), data);
+  EXPECT_STREQ("page 7", data);
+  disk_manager->ReadPage(GetLocalPageId(page_ids[6]), data);
+  EXPECT_STREQ("page 6", data);
+
+  // Scenario: deleting a page frees it in its own file only
+  EXPECT_TRUE(bpm->DeletePage(page_ids[1]));
+  EXPECT_TRUE(tablespace_manager->IsPageFree(0));
+  EXPECT_FALSE(disk_manager->IsPageFree(0));
+
+  delete bpm;
+  delete tablespace_manager;
+  delete disk_manager;
+  remove(db_name.c_str());
+  remove(tablespace_name.c_str());
+}
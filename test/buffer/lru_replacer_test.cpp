@@ -39,4 +39,36 @@ TEST(LRUReplacerTest, SampleTest) {
   EXPECT_EQ(6, value);
   lru_replacer.Victim(&value);
   EXPECT_EQ(4, value);
-}
\ No newline at end of file
+}
+
+TEST(LRUReplacerTest, RelinkTest) {
+  LRUReplacer lru_replacer(3);
+  int value;
+  ASSERT_FALSE(lru_replacer.Victim(&value));
+
+  // Scenario: a frame pinned in the middle of the list and unpinned again moves to the back.
+  lru_replacer.Unpin(2);
+  lru_replacer.Unpin(0);
+  lru_replacer.Unpin(1);
+  lru_replacer.Pin(0);
+  EXPECT_EQ(2, lru_replacer.Size());
+  lru_replacer.Unpin(0);
+  EXPECT_EQ(3, lru_replacer.Size());
+
+  // Scenario: pinning a frame which is not in the replacer has no effect.
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  lru_replacer.Pin(2);
+  EXPECT_EQ(2, lru_replacer.Size());
+
+  // Scenario: a victim may be unpinned again, the replacer is emptied in order.
+  lru_replacer.Unpin(2);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(1, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, value);
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  EXPECT_EQ(2, value);
+  ASSERT_FALSE(lru_replacer.Victim(&value));
+  EXPECT_EQ(0, lru_replacer.Size());
+}
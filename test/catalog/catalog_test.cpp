@@ -135,4 +135,54 @@ TEST(CatalogTest, CatalogIndexTest) {
     ASSERT_EQ(rid.Get(), ret_02[i].Get());
   }
   delete db_02;
-}
\ No newline at end of file
+}
+TEST(CatalogTest, TableDictionaryTest) {
+  auto engine = new DBStorageEngine(db_file_name, true);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("status", TypeId::kTypeChar, 16, 1, false, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableInfo *table_info = TableInfo::Create(&heap);
+  TableHeap *table_heap = TableHeap::Create(engine->bpm_, schema.get(), nullptr, nullptr, nullptr,
+                                            table_info->GetMemHeap());
+  TableMetadata *table_meta = TableMetadata::Create(0, "orders", table_heap->GetFirstPageId(), schema.get(),
+                                                    table_info->GetMemHeap());
+  table_info->Init(table_meta, table_heap);
+  ASSERT_EQ(INVALID_PAGE_ID, table_info->GetDictionaryPageId(1));
+  table_info->EnableDictionary(1);
+  ASSERT_EQ(table_heap->GetDictionary(1)->GetFirstPageId(), table_info->GetDictionaryPageId(1));
+  ASSERT_EQ(INVALID_PAGE_ID, table_info->GetDictionaryPageId(0));
+  char statuses[][10] = {"packed", "shipped", "delivered"};
+  std::vector<RowId> rids;
+  for (int i = 0; i < 30; i++) {
+    std::vector<Field> fields{Field(TypeId::kTypeInt, i),
+                              Field(TypeId::kTypeChar, statuses[i % 3], strlen(statuses[i % 3]), false)};
+    Row row(fields);
+    ASSERT_TRUE(table_heap->InsertTuple(row, nullptr));
+    rids.push_back(row.GetRowId());
+  }
+  // Scenario: a loaded table heap opens the dictionaries kept in the table metadata
+  TableHeap *loaded_table_heap = TableHeap::Create(engine->bpm_, table_info->GetRootPageId(), schema.get(), nullptr,
+                                                   nullptr, table_info->GetMemHeap());
+  table_info->Init(table_meta, loaded_table_heap);
+  table_heap->~TableHeap();
+  ASSERT_NE(nullptr, loaded_table_heap->GetDictionary(1));
+  ASSERT_EQ(3, loaded_table_heap->GetDictionary(1)->GetSize());
+  for (int i = 0; i < 30; i++) {
+    Row row(rids[i]);
+    ASSERT_TRUE(loaded_table_heap->GetTuple(&row, nullptr));
+    ASSERT_EQ(0, memcmp(statuses[i % 3], row.GetField(1)->GetData(), strlen(statuses[i % 3])));
+  }
+  // Scenario: the metadata follows the dictionaries of a new table heap, e.g. of a truncated table
+  TableHeap *new_table_heap = TableHeap::Create(engine->bpm_, schema.get(), nullptr, nullptr, nullptr,
+                                                table_info->GetMemHeap());
+  page_id_t dictionary_page_id = new_table_heap->EnableDictionary(1);
+  TableHeap *old_table_heap = table_info->ResetTableHeap(new_table_heap);
+  ASSERT_EQ(dictionary_page_id, table_info->GetDictionaryPageId(1));
+  old_table_heap->FreeHeap();
+  old_table_heap->~TableHeap();
+  table_info->~TableInfo();
+  delete engine;
+}
@@ -60,4 +60,42 @@ TEST(BPlusTreeTests, SampleTest) {
     ASSERT_TRUE(tree.GetValue(delete_seq[i], ans));
     ASSERT_EQ(kv_map[delete_seq[i]], ans[ans.size() - 1]);
   }
-}
\ No newline at end of file
+}
+TEST(BPlusTreeTests, RandomInsertRemoveTest) {
+  // odd max sizes round the min size of internal pages up
+  for (int max_size : {3, 4, 5}) {
+    DBStorageEngine engine(db_name);
+    BasicComparator<int> comparator;
+    BPlusTree<int, int, BasicComparator<int>> tree(0, engine.bpm_, comparator, max_size, max_size);
+    std::mt19937 rng(max_size);
+    map<int, int> kv_map;
+    for (int i = 0; i < 5000; i++) {
+      int key = static_cast<int>(rng() % 1000);
+      if (rng() % 3 != 0) {
+        ASSERT_EQ(kv_map.count(key) == 0, tree.Insert(key, i));
+        kv_map.emplace(key, i);
+      } else {
+        tree.Remove(key);
+        kv_map.erase(key);
+      }
+    }
+    ASSERT_TRUE(tree.Check());
+    // Scan in key order
+    auto it = kv_map.begin();
+    for (auto iter = tree.Begin(); iter != tree.End(); ++iter, ++it) {
+      ASSERT_TRUE(it != kv_map.end());
+      ASSERT_EQ(it->first, (*iter).first);
+      ASSERT_EQ(it->second, (*iter).second);
+    }
+    ASSERT_TRUE(it == kv_map.end());
+    // Scan from a key
+    ASSERT_EQ(kv_map.lower_bound(500)->first, (*tree.Begin(500)).first);
+    // Remove everything
+    for (auto &kv : kv_map) {
+      tree.Remove(kv.first);
+    }
+    ASSERT_TRUE(tree.IsEmpty());
+    ASSERT_TRUE(tree.Begin() == tree.End());
+    ASSERT_TRUE(tree.Check());
+  }
+}
@@ -10,10 +10,10 @@ TEST(PageTests, IndexRootsPageTest) {
   page->Init();
   for (int i = 0; i < 25; i++) {
     ASSERT_FALSE(page->Delete(i));
-    ASSERT_TRUE(page->Insert(i, i * 100));
+    ASSERT_TRUE(page->Insert(i, i * 100, PAGE_SIZE));
   }
   for (int i = 0; i < 25; i++) {
-    ASSERT_FALSE(page->Insert(i, 0));
+    ASSERT_FALSE(page->Insert(i, 0, PAGE_SIZE));
     page_id_t id;
     ASSERT_TRUE(page->GetRootId(i, &id));
     ASSERT_EQ(i * 100, id);
@@ -39,3 +39,26 @@ TEST(PageTests, IndexRootsPageTest) {
   }
   delete[] buf;
 }
+
+TEST(PageTests, IndexRootsPageCapacityTest) {
+  const uint32_t page_size = 2 * PAGE_SIZE;
+  char *buf = new char[page_size];
+  memset(buf, 0, page_size);
+  auto *page = reinterpret_cast<IndexRootsPage *>(buf);
+  page->Init();
+  // a page of the default size is full before a larger one
+  int max_count = IndexRootsPage::GetMaxIndexCount(PAGE_SIZE);
+  for (int i = 0; i < max_count; i++) {
+    ASSERT_TRUE(page->Insert(i, i, PAGE_SIZE));
+  }
+  ASSERT_FALSE(page->Insert(max_count, max_count, PAGE_SIZE));
+  for (int i = max_count; i < IndexRootsPage::GetMaxIndexCount(page_size); i++) {
+    ASSERT_TRUE(page->Insert(i, i, page_size));
+  }
+  ASSERT_FALSE(page->Insert(IndexRootsPage::GetMaxIndexCount(page_size), 0, page_size));
+  ASSERT_EQ(IndexRootsPage::GetMaxIndexCount(page_size), page->GetIndexCount());
+  page_id_t id;
+  ASSERT_TRUE(page->GetRootId(max_count, &id));
+  ASSERT_EQ(max_count, id);
+  delete[] buf;
+}
@@ -0,0 +1,81 @@
+#include <cstring>
+
+#include "gtest/gtest.h"
+
+extern "C" {
+int yyparse(void);
+#include "parser/minisql_lex.h"
+#include "parser/parser.h"
+}
+
+/**
+ * Parse a single statement
+ * @return root of the syntax tree, valid until MinisqlParserFinish
+ */
+static pSyntaxNode Parse(const char *sql) {
+  YY_BUFFER_STATE bp = yy_scan_string(sql);
+  yy_switch_to_buffer(bp);
+  MinisqlParserInit();
+  yyparse();
+  yy_delete_buffer(bp);
+  yylex_destroy();
+  return MinisqlParserGetError() ? nullptr : MinisqlGetParserRootNode();
+}
+
+TEST(ParserTest, TruncateTableTest) {
+  pSyntaxNode root = Parse("truncate table t;");
+  ASSERT_NE(nullptr, root);
+  ASSERT_EQ(kNodeTruncateTable, root->type_);
+  ASSERT_STREQ("t", root->child_->val_);
+  MinisqlParserFinish();
+}
+
+TEST(ParserTest, ShowIOStatsTest) {
+  pSyntaxNode root = Parse("show iostats;");
+  ASSERT_NE(nullptr, root);
+  ASSERT_EQ(kNodeShowIOStats, root->type_);
+  ASSERT_EQ(nullptr, root->child_);
+  MinisqlParserFinish();
+  root = Parse("show iostats into \"stats.txt\";");
+  ASSERT_NE(nullptr, root);
+  ASSERT_EQ(kNodeShowIOStats, root->type_);
+  ASSERT_EQ(kNodeString, root->child_->type_);
+  MinisqlParserFinish();
+}
+
+TEST(ParserTest, CreateTableOptionsTest) {
+  pSyntaxNode root = Parse("create table t(a int, b char(16)) tablespace ts using pax;");
+  ASSERT_NE(nullptr, root);
+  ASSERT_EQ(kNodeCreateTable, root->type_);
+  pSyntaxNode tablespace = root->child_->next_->next_;
+  ASSERT_EQ(kNodeTablespace, tablespace->type_);
+  ASSERT_STREQ("ts", tablespace->child_->val_);
+  pSyntaxNode format = tablespace->next_;
+  ASSERT_EQ(kNodeTableFormat, format->type_);
+  ASSERT_STREQ("pax", format->child_->val_);
+  MinisqlParserFinish();
+}
+
+TEST(ParserTest, KeywordPrefixTest) {
+  // identifiers starting with a keyword are still identifiers
+  pSyntaxNode root = Parse("drop table truncated;");
+  ASSERT_NE(nullptr, root);
+  ASSERT_EQ(kNodeDropTable, root->type_);
+  ASSERT_STREQ("truncated", root->child_->val_);
+  MinisqlParserFinish();
+}
+
+TEST(ParserTest, MultiRowInsertTest) {
+  pSyntaxNode root = Parse("insert into t values (1, \"a\"), (2, null), (3, \"c\");");
+  ASSERT_NE(nullptr, root);
+  ASSERT_EQ(kNodeInsert, root->type_);
+  int rows = 0;
+  for (pSyntaxNode values = root->child_->next_; values != nullptr; values = values->next_) {
+    ASSERT_EQ(kNodeColumnValues, values->type_);
+    ASSERT_EQ(kNodeNumber, values->child_->type_);
+    ASSERT_NE(nullptr, values->child_->next_);
+    rows++;
+  }
+  ASSERT_EQ(3, rows);
+  MinisqlParserFinish();
+}
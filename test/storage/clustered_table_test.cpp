@@ -0,0 +1,398 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/clustered_table.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "clustered_table_test.db";
+using Fields = std::vector<Field>;
+
+template<typename T>
+static T GetValue(const Field &field) {
+  char buf[sizeof(T)];
+  field.SerializeTo(buf);
+  return MACH_READ_FROM(T, buf);
+}
+
+TEST(ClusteredTableTest, InsertScanTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  ClusteredTable *table = ClusteredTable::Create(engine.bpm_, 0, schema.get(), {0}, nullptr, nullptr, &heap);
+  const int row_nums = 5000;
+  char name[64];
+  memset(name, 'c', sizeof(name));
+  // Scenario: rows inserted in random order, including negative keys, are scanned in key order
+  std::vector<int> ids;
+  for (int i = 0; i < row_nums; i++) {
+    ids.push_back(i - row_nums / 2);
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(2022));
+  for (int id : ids) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, (id & 0x3f) + 1, true)};
+    Row row(fields);
+    ASSERT_TRUE(table->InsertTuple(row, nullptr));
+  }
+  ASSERT_GT(table->GetPageCount(), 1);
+  Fields duplicate_fields{Field(TypeId::kTypeInt, ids[0]), Field(TypeId::kTypeChar, name, 1, true)};
+  Row duplicate(duplicate_fields);
+  ASSERT_FALSE(table->InsertTuple(duplicate, nullptr));
+  auto check_scan = [&](ClusteredTable *clustered_table, const Row *begin_key, const Row *end_key, int begin,
+                        int end) {
+    int next = begin;
+    clustered_table->Scan(begin_key, end_key, [&next](const RowView &row) {
+      EXPECT_EQ(next, GetValue<int32_t>(row.GetField(0)));
+      EXPECT_EQ((next & 0x3f) + 1, row.GetField(1).GetLength());
+      next++;
+      return true;
+    }, nullptr);
+    ASSERT_EQ(end, next);
+  };
+  check_scan(table, nullptr, nullptr, -row_nums / 2, row_nums / 2);
+  Fields begin_fields{Field(TypeId::kTypeInt, -100)};
+  Fields end_fields{Field(TypeId::kTypeInt, 1000)};
+  Row begin_key(begin_fields);
+  Row end_key(end_fields);
+  check_scan(table, &begin_key, &end_key, -100, 1000);
+  int count = 0;
+  table->Scan(&begin_key, nullptr, [&count](const RowView &row) { return ++count < 10; }, nullptr);
+  ASSERT_EQ(10, count);
+
+  // Scenario: point lookups, updates and deletes
+  for (int id = -row_nums / 2; id < row_nums / 2; id += 7) {
+    Fields key_fields{Field(TypeId::kTypeInt, id)};
+    Row key(key_fields);
+    Row row(INVALID_ROWID);
+    ASSERT_TRUE(table->GetTuple(key, &row, nullptr));
+    ASSERT_EQ((id & 0x3f) + 1, row.GetField(1)->GetLength());
+  }
+  for (int id = 0; id < 500; id++) {
+    Fields fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, 64, true)};
+    Row row(fields);
+    ASSERT_TRUE(table->UpdateTuple(row, nullptr));
+  }
+  for (int id = 0; id < 500; id++) {
+    Fields key_fields{Field(TypeId::kTypeInt, id)};
+    Row key(key_fields);
+    Row row(INVALID_ROWID);
+    ASSERT_TRUE(table->GetTuple(key, &row, nullptr));
+    ASSERT_EQ(64, row.GetField(1)->GetLength());
+  }
+  Fields missing_fields{Field(TypeId::kTypeInt, row_nums)};
+  Row missing_key(missing_fields);
+  Row missing_row(INVALID_ROWID);
+  ASSERT_FALSE(table->GetTuple(missing_key, &missing_row, nullptr));
+  for (int id = row_nums / 2 - 100; id < row_nums / 2; id++) {
+    Fields key_fields{Field(TypeId::kTypeInt, id)};
+    Row key(key_fields);
+    ASSERT_TRUE(table->DeleteTuple(key, nullptr));
+    ASSERT_FALSE(table->DeleteTuple(key, nullptr));
+  }
+
+
+  // Scenario: the table is loaded from the root of its tree in the index roots page
+  ClusteredTable *loaded = ClusteredTable::Create(engine.bpm_, 0, schema.get(), {0}, nullptr, nullptr, &heap);
+  ASSERT_EQ(table->GetPageCount(), loaded->GetPageCount());
+  count = 0;
+  loaded->Scan(nullptr, nullptr, [&count](const RowView &row) {
+    count++;
+    return true;
+  }, nullptr);
+  ASSERT_EQ(row_nums - 100, count);
+  Fields fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, name, 8, true)};
+  Row row(fields);
+  ASSERT_TRUE(loaded->InsertTuple(row, nullptr));
+  loaded->FreeTable();
+  ASSERT_EQ(0, loaded->GetPageCount());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  table->~ClusteredTable();
+  loaded->~ClusteredTable();
+}
+
+TEST(ClusteredTableTest, CompositeKeyTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("value", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 16, 1, false, false),
+          ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, false, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  // key columns are in a different order than in the schema
+  ClusteredTable *table = ClusteredTable::Create(engine.bpm_, 0, schema.get(), {1, 2}, nullptr, nullptr, &heap);
+  std::vector<std::string> names = {"", "a", std::string("a\0b", 3), "ab", "b", std::string("b\0", 2)};
+  std::vector<float> scores = {-1e9f, -2.5f, -0.0f, 0.5f, 3.0f, 1e9f};
+  std::vector<std::pair<std::string, float>> keys;
+  for (auto &name : names) {
+    for (float score : scores) {
+      keys.emplace_back(name, score);
+    }
+  }
+  std::vector<std::pair<std::string, float>> shuffled = keys;
+  std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(7));
+  for (auto &key : shuffled) {
+    Fields fields{Field(TypeId::kTypeInt, 0),
+                  Field(TypeId::kTypeChar, const_cast<char *>(key.first.data()), key.first.size(), true),
+                  Field(TypeId::kTypeFloat, key.second)};
+    Row row(fields);
+    ASSERT_TRUE(table->InsertTuple(row, nullptr));
+  }
+  std::sort(keys.begin(), keys.end());
+  size_t next = 0;
+  table->Scan(nullptr, nullptr, [&](const RowView &row) {
+    Field name = row.GetField(1);
+    EXPECT_EQ(keys[next].first, std::string(name.GetData(), name.GetLength()));
+    EXPECT_EQ(keys[next].second, GetValue<float>(row.GetField(2)));
+    next++;
+    return true;
+  }, nullptr);
+  ASSERT_EQ(keys.size(), next);
+  Fields null_fields{Field(TypeId::kTypeInt, 0), Field(TypeId::kTypeChar, nullptr, 0, false),
+                     Field(TypeId::kTypeFloat, 1.0f)};
+  Row null_row(null_fields);
+  ASSERT_FALSE(table->InsertTuple(null_row, nullptr));
+  table->FreeTable();
+  table->~ClusteredTable();
+}
+
+TEST(ClusteredTableTest, LargeRowTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  const uint32_t max_length = 2 * engine.bpm_->GetPageSize();
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("payload", TypeId::kTypeChar, max_length, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  ClusteredTable *table = ClusteredTable::Create(engine.bpm_, 0, schema.get(), {0}, nullptr, nullptr, &heap);
+  // rows stay in their slots, or go to one or more overflow pages
+  std::vector<uint32_t> lengths = {16, CLUSTERED_ROW_SIZE, 1000, max_length};
+  std::string payload(max_length, 0);
+  auto make_fields = [&](int id, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+      payload[i] = static_cast<char>('a' + (id + i) % 26);
+    }
+    return Fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, payload.data(), length, true)};
+  };
+  auto check_row = [&](const RowView &row, uint32_t length) {
+    int id = GetValue<int32_t>(row.GetField(0));
+    Field field = row.GetField(1);
+    ASSERT_EQ(length, field.GetLength());
+    for (uint32_t i = 0; i < length; i++) {
+      ASSERT_EQ(static_cast<char>('a' + (id + i) % 26), field.GetData()[i]);
+    }
+  };
+  const int row_nums = 400;
+  for (int id = 0; id < row_nums; id++) {
+    Fields fields = make_fields(id, lengths[id % lengths.size()]);
+    Row row(fields);
+    ASSERT_TRUE(table->InsertTuple(row, nullptr));
+  }
+  int next = 0;
+  table->Scan(nullptr, nullptr, [&](const RowView &row) {
+    check_row(row, lengths[next % lengths.size()]);
+    next++;
+    return true;
+  }, nullptr);
+  ASSERT_EQ(row_nums, next);
+  // Scenario: rows are updated in their slots and move in and out of overflow pages, the leaves do not change
+  size_t page_count = table->GetPageCount();
+  for (int id = 0; id < row_nums; id++) {
+    Fields fields = make_fields(id, lengths[(id + 1) % lengths.size()]);
+    Row row(fields);
+    ASSERT_TRUE(table->UpdateTuple(row, nullptr));
+  }
+  ASSERT_EQ(page_count, table->GetPageCount());
+  for (int id = 0; id < row_nums; id++) {
+    Fields key_fields{Field(TypeId::kTypeInt, id)};
+    Row key(key_fields);
+    Row row(INVALID_ROWID);
+    ASSERT_TRUE(table->GetTuple(key, &row, nullptr));
+    std::vector<char> data(row.GetSerializedSize(schema.get()));
+    row.SerializeTo(data.data(), schema.get());
+    check_row(RowView(data.data(), INVALID_ROWID, schema.get()), lengths[(id + 1) % lengths.size()]);
+  }
+  for (int id = 0; id < row_nums; id += 2) {
+    Fields key_fields{Field(TypeId::kTypeInt, id)};
+    Row key(key_fields);
+    ASSERT_TRUE(table->DeleteTuple(key, nullptr));
+  }
+  table->FreeTable();
+  ASSERT_EQ(0, table->GetPageCount());
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  table->~ClusteredTable();
+}
+
+TEST(ClusteredTableTest, SecondaryIndexTest) {
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("email", TypeId::kTypeChar, 16, 1, true, false),
+          ALLOC_COLUMN(heap)("score", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  ClusteredTable *table = ClusteredTable::Create(engine.bpm_, 0, schema.get(), {0}, nullptr, nullptr, &heap);
+  auto make_fields = [](int id, const std::string &email) {
+    return Fields{Field(TypeId::kTypeInt, id),
+                  Field(TypeId::kTypeChar, const_cast<char *>(email.data()), email.size(), true),
+                  Field(TypeId::kTypeFloat, 0.5f * (id % 100))};
+  };
+  const int row_nums = 1000;
+  for (int id = 0; id < row_nums / 2; id++) {
+    Fields fields = make_fields(id, "user" + std::to_string(id));
+    Row row(fields);
+    ASSERT_TRUE(table->InsertTuple(row, nullptr));
+  }
+  // Scenario: the rows in the table are indexed when the index is created, later rows as they are inserted
+  ASSERT_TRUE(table->CreateSecondaryIndex(1, {1}, nullptr));
+  for (int id = row_nums / 2; id < row_nums; id++) {
+    Fields fields = make_fields(id, "user" + std::to_string(id));
+    Row row(fields);
+    ASSERT_TRUE(table->InsertTuple(row, nullptr));
+  }
+  auto check_lookup = [&](const std::string &email, int id) {
+    Fields key_fields{Field(TypeId::kTypeChar, const_cast<char *>(email.data()), email.size(), true)};
+    Row key(key_fields);
+    Row row(INVALID_ROWID);
+    if (id < 0) {
+      ASSERT_FALSE(table->GetTupleBySecondaryKey(0, key, &row, nullptr));
+      return;
+    }
+    ASSERT_TRUE(table->GetTupleBySecondaryKey(0, key, &row, nullptr));
+    ASSERT_EQ(id, GetValue<int32_t>(*row.GetField(0)));
+    ASSERT_EQ(0.5f * (id % 100), GetValue<float>(*row.GetField(2)));
+  };
+  for (int id = 0; id < row_nums; id += 3) {
+    check_lookup("user" + std::to_string(id), id);
+  }
+  // Scenario: a secondary key of another row is rejected
+  Fields taken_fields = make_fields(row_nums, "user1");
+  Row taken(taken_fields);
+  ASSERT_FALSE(table->InsertTuple(taken, nullptr));
+  Fields moved_fields = make_fields(2, "user1");
+  Row moved(moved_fields);
+  ASSERT_FALSE(table->UpdateTuple(moved, nullptr));
+  Fields null_fields{Field(TypeId::kTypeInt, row_nums), Field(TypeId::kTypeChar, nullptr, 0, false),
+                     Field(TypeId::kTypeFloat, 1.0f)};
+  Row null_row(null_fields);
+  ASSERT_FALSE(table->InsertTuple(null_row, nullptr));
+  // Scenario: updates and deletes move and remove secondary keys
+  Fields updated_fields = make_fields(2, "renamed");
+  Row updated(updated_fields);
+  ASSERT_TRUE(table->UpdateTuple(updated, nullptr));
+  check_lookup("user2", -1);
+  check_lookup("renamed", 2);
+  Fields key_fields{Field(TypeId::kTypeInt, 3)};
+  Row key(key_fields);
+  ASSERT_TRUE(table->DeleteTuple(key, nullptr));
+  check_lookup("user3", -1);
+  Fields reused_fields = make_fields(row_nums, "user3");
+  Row reused(reused_fields);
+  ASSERT_TRUE(table->InsertTuple(reused, nullptr));
+  check_lookup("user3", row_nums);
+  // Scenario: an index can not be created over duplicate keys
+  ASSERT_FALSE(table->CreateSecondaryIndex(2, {2}, nullptr));
+  table->FreeTable();
+  ASSERT_TRUE(engine.bpm_->CheckAllUnpinned());
+  table->~ClusteredTable();
+}
+
+TEST(ClusteredTableTest, DISABLED_RangeScanBenchmark) {
+  const int row_nums = 500000;
+  const int range_size = 1000;
+  const int range_nums = 500;
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false),
+          ALLOC_COLUMN(heap)("account", TypeId::kTypeFloat, 2, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'r', sizeof(name));
+  std::vector<int> ids(row_nums);
+  for (int i = 0; i < row_nums; i++) {
+    ids[i] = i;
+  }
+  std::shuffle(ids.begin(), ids.end(), std::mt19937(2022));
+  std::mt19937 random(7);
+  std::vector<int> range_begins(range_nums);
+  for (auto &begin : range_begins) {
+    begin = static_cast<int>(random() % (row_nums - range_size));
+  }
+  auto make_fields = [&name](int id) {
+    return Fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name, id % 64, true),
+                  Field(TypeId::kTypeFloat, 1.0f * id)};
+  };
+  // the buffer pool holds a fraction of the table, rows are inserted in random key order
+  const uint32_t pool_size = 1024;
+  {
+    // heap table, a map from key to rid stands in for the primary key index
+    DBStorageEngine engine(db_file_name, true, pool_size);
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+    std::map<int, RowId> index;
+    for (int id : ids) {
+      Fields fields = make_fields(id);
+      Row row(fields);
+      table_heap->InsertTuple(row, nullptr);
+      index.emplace(id, row.GetRowId());
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    for (int begin : range_begins) {
+      for (auto iter = index.lower_bound(begin); iter != index.end() && iter->first < begin + range_size; iter++) {
+        Row row(iter->second);
+        table_heap->GetTuple(&row, nullptr);
+        count++;
+      }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(range_nums * range_size, count);
+    std::cout << "heap table with index: " << static_cast<uint64_t>(range_nums / seconds) << " range scans/sec, "
+              << table_heap->GetPageCount() << " pages" << std::endl;
+    table_heap->~TableHeap();
+  }
+  {
+    DBStorageEngine engine(db_file_name, true, pool_size);
+    ClusteredTable *table = ClusteredTable::Create(engine.bpm_, 0, schema.get(), {0}, nullptr, nullptr, &heap);
+    for (int id : ids) {
+      Fields fields = make_fields(id);
+      Row row(fields);
+      table->InsertTuple(row, nullptr);
+    }
+    auto start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    for (int begin : range_begins) {
+      Fields begin_fields{Field(TypeId::kTypeInt, begin)};
+      Fields end_fields{Field(TypeId::kTypeInt, begin + range_size)};
+      Row begin_key(begin_fields);
+      Row end_key(end_fields);
+      table->Scan(&begin_key, &end_key, [&count](const RowView &row) {
+        Row materialized(INVALID_ROWID);
+        row.Materialize(&materialized);
+        count++;
+        return true;
+      }, nullptr);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(range_nums * range_size, count);
+    std::cout << "clustered table: " << static_cast<uint64_t>(range_nums / seconds) << " range scans/sec, "
+              << table->GetPageCount() << " pages" << std::endl;
+    table->~ClusteredTable();
+  }
+  remove(db_file_name.c_str());
+}
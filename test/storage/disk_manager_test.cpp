@@ -1,7 +1,17 @@
+#include <chrono>
+#include <fstream>
+#include <string>
 #include <unordered_set>
+#include <vector>
 
+#include "common/instance.h"
 #include "gtest/gtest.h"
+#include "index/b_plus_tree.h"
+#include "index/generic_key.h"
+#include "page/b_plus_tree_internal_page.h"
+#include "page/b_plus_tree_leaf_page.h"
 #include "storage/disk_manager.h"
+#include "utils/utils.h"
 
 TEST(DiskManagerTest, BitMapPageTest) {
   const size_t size = 512;
@@ -55,4 +65,190 @@ TEST(DiskManagerTest, DISABLED_FreePageAllocationTest) {
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 2, meta_page->GetExtentUsedPage(0));
   EXPECT_EQ(DiskManager::BITMAP_SIZE - 3, meta_page->GetExtentUsedPage(1));
   remove(db_name.c_str());
-}
\ No newline at end of file
+}
+TEST(DiskManagerTest, PageSizeTest) {
+  std::string db_name = "disk_page_size_test.db";
+  for (uint32_t page_size : {4096, 8192, 16384, 32768}) {
+    remove(db_name.c_str());
+    auto *disk_mgr = new DiskManager(db_name, page_size);
+    ASSERT_EQ(page_size, disk_mgr->GetPageSize());
+    ASSERT_EQ(8 * (page_size - 8), disk_mgr->GetBitmapSize());
+    std::vector<char> data(page_size);
+    for (uint32_t i = 0; i < page_size; i++) {
+      data[i] = static_cast<char>(i * 7);
+    }
+    page_id_t page_id = INVALID_PAGE_ID;
+    for (int i = 0; i < 3; i++) {
+      page_id = disk_mgr->AllocatePage();
+    }
+    ASSERT_EQ(2, page_id);
+    disk_mgr->WritePage(page_id, data.data());
+    disk_mgr->Close();
+    delete disk_mgr;
+    // page size recorded in the file wins over the requested one
+    disk_mgr = new DiskManager(db_name, PAGE_SIZE);
+    ASSERT_EQ(page_size, disk_mgr->GetPageSize());
+    ASSERT_FALSE(disk_mgr->IsPageFree(page_id));
+    ASSERT_TRUE(disk_mgr->IsPageFree(page_id + 1));
+    std::vector<char> read_data(page_size);
+    disk_mgr->ReadPage(page_id, read_data.data());
+    ASSERT_EQ(0, memcmp(data.data(), read_data.data(), page_size));
+    auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+    ASSERT_EQ(page_size, meta_page->GetPageSize());
+    ASSERT_EQ(3, meta_page->GetAllocatedPages());
+    delete disk_mgr;
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, DISABLED_PageSizeBenchmark) {
+  using KeyType = GenericKey<16>;
+  using Tree = BPlusTree<KeyType, RowId, GenericComparator<16>>;
+  std::string db_name = "disk_page_size_bench.db";
+  std::string tree_db_name = "disk_page_size_tree_bench.db";
+  const size_t data_size = 64 * 1024 * 1024;
+  const int key_nums = 1000000;
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {ALLOC_COLUMN(heap)("k", TypeId::kTypeInt, 0, false, false)};
+  Schema key_schema(columns);
+  GenericComparator<16> comparator(&key_schema);
+  std::vector<int> keys(key_nums);
+  for (int i = 0; i < key_nums; i++) {
+    keys[i] = i;
+  }
+  ShuffleArray(keys);
+  for (uint32_t page_size : {4096, 8192, 16384, 32768}) {
+    // tree of 16 bytes keys built by inserting the keys in random order, leaves hold (key, rid) and internal pages
+    // hold (key, page id)
+    using LeafMapping = std::pair<KeyType, RowId>;
+    using InternalMapping = std::pair<KeyType, page_id_t>;
+    size_t leaf_size = (page_size - LEAF_PAGE_HEADER_SIZE) / sizeof(LeafMapping) - 1;
+    size_t internal_size = (page_size - INTERNAL_PAGE_HEADER_SIZE) / sizeof(InternalMapping) - 1;
+    remove(tree_db_name.c_str());
+    int height = 0;
+    size_t leaf_nums = 0;
+    {
+      DBStorageEngine engine(tree_db_name, true, DEFAULT_BUFFER_POOL_SIZE, page_size);
+      Tree tree(0, engine.bpm_, comparator, leaf_size, internal_size);
+      for (int key : keys) {
+        std::vector<Field> fields{Field(TypeId::kTypeInt, key)};
+        KeyType index_key;
+        index_key.SerializeFromKey(Row(fields), &key_schema);
+        ASSERT_TRUE(tree.Insert(index_key, RowId(key)));
+      }
+      // the height is the length of the path from the leftmost leaf to the root
+      Page *page = tree.FindLeafPage(KeyType(), true);
+      page_id_t page_id = page->GetPageId();
+      for (page_id_t next_id = page_id; next_id != INVALID_PAGE_ID; leaf_nums++) {
+        auto leaf = reinterpret_cast<BPlusTreeLeafPage<KeyType, RowId, GenericComparator<16>> *>(
+                engine.bpm_->FetchPage(next_id)->GetData());
+        next_id = leaf->GetNextPageId();
+        engine.bpm_->UnpinPage(leaf->GetPageId(), false);
+      }
+      engine.bpm_->UnpinPage(page_id, false);
+      while (page_id != INVALID_PAGE_ID) {
+        auto node = reinterpret_cast<BPlusTreePage *>(engine.bpm_->FetchPage(page_id)->GetData());
+        engine.bpm_->UnpinPage(page_id, false);
+        page_id = node->GetParentPageId();
+        height++;
+      }
+      tree.Destroy();
+    }
+    remove(tree_db_name.c_str());
+    // sequential scan throughput
+    remove(db_name.c_str());
+    DiskManager disk_mgr(db_name, page_size);
+    std::vector<char> data(page_size, 'x');
+    const size_t page_nums = data_size / page_size;
+    for (size_t i = 0; i < page_nums; i++) {
+      disk_mgr.WritePage(disk_mgr.AllocatePage(), data.data());
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < page_nums; i++) {
+      disk_mgr.ReadPage(i, data.data());
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "page size " << page_size << ": leaf fan-out " << leaf_size << ", internal fan-out " << internal_size
+              << ", tree of " << key_nums << " keys with " << leaf_nums << " leaves and height " << height << ", scan "
+              << data_size / 1024.0 / 1024.0 / elapsed.count() << " MB/s, " << page_nums / elapsed.count()
+              << " pages/s" << std::endl;
+    disk_mgr.Close();
+  }
+  remove(db_name.c_str());
+}
+
+TEST(DiskManagerTest, IOStatsTest) {
+  // Scenario: percentiles are reported with the upper bound of their log-scaled bucket
+  LatencyHistogram histogram;
+  for (uint64_t i = 1; i <= 1000; i++) {
+    histogram.Record(i * 1000);
+  }
+  EXPECT_EQ(1000, histogram.GetCount());
+  uint64_t p50 = histogram.GetPercentile(0.5);
+  EXPECT_GE(p50, 500000);
+  EXPECT_LE(p50, 500000 * 5 / 4);
+  EXPECT_GE(histogram.GetPercentile(0.999), 999000);
+  EXPECT_GE(histogram.GetPercentile(0.999), histogram.GetPercentile(0.99));
+  for (uint64_t latency : {0, 3, 4, 9, 1000, 123456789}) {
+    EXPECT_GE(LatencyHistogram::GetBucketUpperBound(LatencyHistogram::GetBucketIndex(latency)), latency);
+  }
+
+  // Scenario: I/O of a disk file is counted by page type
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  char data[PAGE_SIZE] = "io stats";
+  for (int i = 0; i < 10; i++) {
+    disk_mgr->WritePage(disk_mgr->AllocatePage(), data);
+  }
+  for (int i = 0; i < 10; i++) {
+    disk_mgr->ReadPage(i, data);
+  }
+  disk_mgr->Close();
+  DiskIOStats &stats = disk_mgr->GetIOStats();
+  EXPECT_EQ(10, stats.GetCount(DiskPageType::DATA_PAGE, DiskIOType::WRITE));
+  EXPECT_EQ(10, stats.GetCount(DiskPageType::DATA_PAGE, DiskIOType::READ));
+  EXPECT_EQ(10 * PAGE_SIZE, stats.GetBytes(DiskPageType::DATA_PAGE, DiskIOType::READ));
+  EXPECT_EQ(10, stats.GetCount(DiskPageType::BITMAP_PAGE, DiskIOType::WRITE));
+  EXPECT_EQ(1, stats.GetCount(DiskPageType::META_PAGE, DiskIOType::WRITE));
+  EXPECT_GT(stats.GetLatency(DiskPageType::DATA_PAGE, DiskIOType::WRITE).GetPercentile(0.99), 0);
+
+  // Scenario: stats can be dumped into a file
+  std::string stats_name = "disk_test.stats";
+  remove(stats_name.c_str());
+  ASSERT_TRUE(stats.DumpToFile(stats_name));
+  std::ifstream in(stats_name);
+  int lines = 0;
+  for (std::string line; std::getline(in, line);) {
+    lines++;
+  }
+  EXPECT_EQ(1 + DiskIOStats::PAGE_TYPE_NUM * DiskIOStats::IO_TYPE_NUM, lines);
+  stats.Reset();
+  EXPECT_EQ(0, stats.GetCount(DiskPageType::DATA_PAGE, DiskIOType::READ));
+  delete disk_mgr;
+  remove(db_name.c_str());
+  remove(stats_name.c_str());
+}
+
+TEST(DiskManagerTest, DeAllocatePagesTest) {
+  std::string db_name = "disk_test.db";
+  remove(db_name.c_str());
+  auto *disk_mgr = new DiskManager(db_name);
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(i, disk_mgr->AllocatePage());
+  }
+  // a page freed twice in the batch and a page never allocated are only counted once
+  disk_mgr->DeAllocatePages({42, 3, 99, 3, 150, 0});
+  auto *meta_page = reinterpret_cast<DiskFileMetaPage *>(disk_mgr->GetMetaData());
+  EXPECT_EQ(96, meta_page->GetAllocatedPages());
+  EXPECT_EQ(96, meta_page->GetExtentUsedPage(0));
+  for (page_id_t page_id = 0; page_id < 100; page_id++) {
+    bool freed = page_id == 0 || page_id == 3 || page_id == 42 || page_id == 99;
+    EXPECT_EQ(freed, disk_mgr->IsPageFree(page_id));
+  }
+  disk_mgr->DeAllocatePages({});
+  EXPECT_EQ(96, meta_page->GetAllocatedPages());
+  disk_mgr->Close();
+  delete disk_mgr;
+  remove(db_name.c_str());
+}
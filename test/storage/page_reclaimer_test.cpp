@@ -0,0 +1,163 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/page_reclaimer.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "page_reclaimer_test.db";
+using Fields = std::vector<Field>;
+
+class PageReclaimerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    engine_ = std::make_unique<DBStorageEngine>(db_file_name);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+            ALLOC_COLUMN(heap_)("desc", TypeId::kTypeChar, 2000, 1, true, false)
+    };
+    schema_ = std::make_shared<Schema>(columns);
+  }
+
+  /**
+   * @return a table heap of row_nums rows, every tenth row with a value stored in overflow pages
+   */
+  TableHeap *CreateTable(int row_nums) {
+    TableHeap *table_heap = TableHeap::Create(engine_->bpm_, schema_.get(), nullptr, nullptr, nullptr, &heap_);
+    std::string desc(2000, 'd');
+    for (int i = 0; i < row_nums; i++) {
+      uint32_t len = i % 10 == 0 ? desc.size() : 16;
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, const_cast<char *>(desc.c_str()), len, true)};
+      Row row(fields);
+      EXPECT_TRUE(table_heap->InsertTuple(row, nullptr));
+    }
+    return table_heap;
+  }
+
+  uint32_t GetAllocatedPages() {
+    return reinterpret_cast<DiskFileMetaPage *>(engine_->disk_mgr_->GetMetaData())->GetAllocatedPages();
+  }
+
+  void TearDown() override {
+    engine_.reset();
+    remove(db_file_name.c_str());
+  }
+
+  std::unique_ptr<DBStorageEngine> engine_;
+  SimpleMemHeap heap_;
+  std::shared_ptr<Schema> schema_;
+};
+
+TEST_F(PageReclaimerTest, ReleaseTest) {
+  PageReclaimer reclaimer(engine_->bpm_);
+  // Scenario: a table is truncated by swapping in an empty table heap, the old pages are released later
+  uint32_t allocated_pages = GetAllocatedPages();
+  TableHeap *old_table_heap = CreateTable(2000);
+  page_id_t first_page_id = old_table_heap->GetFirstPageId();
+  uint32_t old_table_pages = GetAllocatedPages() - allocated_pages;
+  ASSERT_GT(old_table_pages, old_table_heap->GetPageCount());
+  TableHeap *table_heap = TableHeap::Create(engine_->bpm_, schema_.get(), nullptr, nullptr, nullptr, &heap_);
+  uint32_t new_table_pages = GetAllocatedPages() - allocated_pages - old_table_pages;
+  // the old table heap is destroyed by the reclaimer before the callback
+  bool is_released = false;
+  reclaimer.Release(old_table_heap, [&is_released] { is_released = true; });
+  reclaimer.Drain();
+  EXPECT_TRUE(is_released);
+  // table pages, overflow pages and free space map pages are all released
+  EXPECT_EQ(allocated_pages + new_table_pages, GetAllocatedPages());
+  EXPECT_TRUE(engine_->bpm_->IsPageFree(first_page_id));
+  EXPECT_FALSE(engine_->bpm_->IsPageFree(table_heap->GetFirstPageId()));
+  EXPECT_EQ(table_heap->End(), table_heap->Begin(nullptr));
+
+  // Scenario: pages of a dropped index are released as a list
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 10; i++) {
+    page_id_t page_id;
+    ASSERT_NE(nullptr, engine_->bpm_->NewPage(page_id));
+    engine_->bpm_->UnpinPage(page_id, true);
+    page_ids.push_back(page_id);
+  }
+  reclaimer.Release(page_ids);
+  reclaimer.Drain();
+  for (auto page_id : page_ids) {
+    EXPECT_TRUE(engine_->bpm_->IsPageFree(page_id));
+  }
+  table_heap->~TableHeap();
+}
+
+TEST_F(PageReclaimerTest, PinnedPageTest) {
+  // Scenario: a page still pinned by a reader is released once it is unpinned
+  uint32_t allocated_pages = GetAllocatedPages();
+  TableHeap *table_heap = CreateTable(500);
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  ASSERT_NE(nullptr, engine_->bpm_->FetchPage(first_page_id));
+  PageReclaimer reclaimer(engine_->bpm_);
+  reclaimer.Release(table_heap);
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(engine_->bpm_->IsPageFree(first_page_id));
+  EXPECT_EQ(allocated_pages + 1, GetAllocatedPages());
+  engine_->bpm_->UnpinPage(first_page_id, false);
+  reclaimer.Drain();
+  EXPECT_TRUE(engine_->bpm_->IsPageFree(first_page_id));
+  EXPECT_EQ(allocated_pages, GetAllocatedPages());
+}
+
+TEST(PageReclaimerBenchmark, DISABLED_TruncateLatencyBenchmark) {
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  char name[64];
+  memset(name, 'n', sizeof(name));
+  auto create_table = [&](DBStorageEngine &engine, int row_nums) {
+    TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+    std::vector<Row> batch;
+    for (int i = 0; i < row_nums; i++) {
+      Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, i % 64, true)};
+      batch.emplace_back(fields);
+      if (batch.size() == 1000 || i == row_nums - 1) {
+        table_heap->InsertTuples(batch, nullptr);
+        batch.clear();
+      }
+    }
+    return table_heap;
+  };
+  auto elapsed_ms = [](std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  };
+  for (int row_nums : {10000, 100000, 1000000}) {
+    DBStorageEngine engine(db_file_name, true, 32768);
+    // synchronous truncate walks the page chain before returning
+    TableHeap *table_heap = create_table(engine, row_nums);
+    size_t page_count = table_heap->GetPageCount();
+    auto start = std::chrono::steady_clock::now();
+    table_heap->FreeHeap();
+    table_heap->~TableHeap();
+    table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+    double sync_ms = elapsed_ms(start);
+    table_heap->~TableHeap();
+    // asynchronous truncate only swaps in an empty table heap
+    PageReclaimer reclaimer(engine.bpm_);
+    table_heap = create_table(engine, row_nums);
+    start = std::chrono::steady_clock::now();
+    TableHeap *old_table_heap = table_heap;
+    table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+    reclaimer.Release(old_table_heap);
+    double async_ms = elapsed_ms(start);
+    start = std::chrono::steady_clock::now();
+    reclaimer.Drain();
+    double release_ms = elapsed_ms(start);
+    std::cout << row_nums << " rows, " << page_count << " pages: sync truncate " << sync_ms << " ms, async truncate "
+              << async_ms << " ms, background release " << release_ms << " ms" << std::endl;
+    table_heap->~TableHeap();
+  }
+  remove(db_file_name.c_str());
+}
@@ -0,0 +1,98 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/parallel_table_scan.h"
+#include "storage/table_heap.h"
+
+static string db_file_name = "parallel_table_scan_test.db";
+using Fields = std::vector<Field>;
+
+static TableHeap *CreateTable(DBStorageEngine &engine, Schema *schema, MemHeap *heap, int row_nums) {
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema, nullptr, nullptr, nullptr, heap);
+  char name[64];
+  memset(name, 'a', sizeof(name));
+  std::vector<Row> batch;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, i % 64, false)};
+    batch.emplace_back(fields);
+    if (batch.size() == 1000 || i == row_nums - 1) {
+      EXPECT_EQ(batch.size(), table_heap->InsertTuples(batch, nullptr).size());
+      batch.clear();
+    }
+  }
+  return table_heap;
+}
+
+TEST(ParallelTableScanTest, ScanTest) {
+  const int row_nums = 19200;
+  DBStorageEngine engine(db_file_name);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = CreateTable(engine, schema.get(), &heap, row_nums);
+  // every row is passed exactly once, whatever the degree of parallelism
+  for (uint32_t dop : {1, 2, 3, 8}) {
+    for (uint32_t morsel_size : {1, 16}) {
+      ParallelTableScan scan(table_heap, dop, morsel_size);
+      std::vector<std::vector<int64_t>> partial_rids(dop);
+      scan.Scan([&partial_rids](uint32_t worker_id, const RowView &row) {
+        partial_rids[worker_id].push_back(row.GetRowId().Get());
+      }, nullptr);
+      std::unordered_set<int64_t> rids;
+      for (auto &worker_rids : partial_rids) {
+        rids.insert(worker_rids.begin(), worker_rids.end());
+      }
+      ASSERT_EQ(row_nums, rids.size());
+      // predicates are evaluated in the workers
+      auto result = scan.Filter([](const RowView &row) { return row.GetField(1).GetLength() >= 32; }, nullptr);
+      ASSERT_EQ(row_nums / 2, result.size());
+      for (auto rid : result) {
+        Row row(rid);
+        ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+        ASSERT_GE(row.GetField(1)->GetLength(), 32);
+      }
+    }
+  }
+  table_heap->~TableHeap();
+}
+
+TEST(ParallelTableScanTest, DISABLED_ScanScalingBenchmark) {
+  const int row_nums = 2000000;
+  DBStorageEngine engine(db_file_name, true, 65536);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = CreateTable(engine, schema.get(), &heap, row_nums);
+  Field threshold(TypeId::kTypeInt, row_nums / 3);
+  uint32_t max_dop = std::max(std::thread::hardware_concurrency(), 1u);
+  double base_seconds = 0;
+  for (uint32_t dop = 1; dop <= max_dop; dop *= 2) {
+    ParallelTableScan scan(table_heap, dop);
+    auto start = std::chrono::steady_clock::now();
+    auto result = scan.Filter([&threshold](const RowView &row) {
+      return row.GetField(0).CompareLessThan(threshold) == CmpBool::kTrue;
+    }, nullptr);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(row_nums / 3, result.size());
+    if (dop == 1) {
+      base_seconds = seconds;
+    }
+    std::cout << "dop " << dop << ": " << static_cast<uint64_t>(row_nums / seconds) << " rows/sec, speedup "
+              << base_seconds / seconds << std::endl;
+  }
+  table_heap->~TableHeap();
+}
@@ -0,0 +1,305 @@
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "common/instance.h"
+#include "gtest/gtest.h"
+#include "record/field.h"
+#include "record/schema.h"
+#include "storage/parallel_table_scan.h"
+#include "storage/scan_predicate.h"
+#include "storage/table_heap.h"
+#include "storage/vacuum_worker.h"
+
+static string db_file_name = "vacuum_worker_test.db";
+using Fields = std::vector<Field>;
+
+class VacuumWorkerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    engine_ = std::make_unique<DBStorageEngine>(db_file_name);
+    std::vector<Column *> columns = {
+            ALLOC_COLUMN(heap_)("id", TypeId::kTypeInt, 0, false, false),
+            ALLOC_COLUMN(heap_)("name", TypeId::kTypeChar, 64, 1, true, false)
+    };
+    schema_ = std::make_shared<Schema>(columns);
+    table_heap_ = TableHeap::Create(engine_->bpm_, schema_.get(), nullptr, nullptr, nullptr, &heap_);
+    memset(name_, 'n', sizeof(name_));
+    for (int i = 0; i < row_nums_; i++) {
+      Fields fields = MakeFields(i, i % 32);
+      Row row(fields);
+      ASSERT_TRUE(table_heap_->InsertTuple(row, nullptr));
+      ids_[row.GetRowId().Get()] = i;
+    }
+  }
+
+  void TearDown() override {
+    table_heap_->~TableHeap();
+  }
+
+  Fields MakeFields(int id, int len) {
+    return Fields{Field(TypeId::kTypeInt, id), Field(TypeId::kTypeChar, name_, len, true)};
+  }
+
+  /**
+   * Mark the rows with ids in [begin, end) and every third row deleted
+   * @return number of rows deleted
+   */
+  size_t DeleteRows(int begin, int end) {
+    std::vector<int64_t> deleted;
+    for (auto &id_kv : ids_) {
+      if ((id_kv.second >= begin && id_kv.second < end) || id_kv.second % 3 == 0) {
+        deleted.push_back(id_kv.first);
+      }
+    }
+    for (auto rid : deleted) {
+      EXPECT_TRUE(table_heap_->MarkDelete(RowId(rid), nullptr));
+      ids_.erase(rid);
+    }
+    return deleted.size();
+  }
+
+  void CheckRows(TableHeap *table_heap) {
+    for (auto &id_kv : ids_) {
+      Row row((RowId(id_kv.first)));
+      ASSERT_TRUE(table_heap->GetTuple(&row, nullptr));
+      ASSERT_EQ(CmpBool::kTrue, row.GetField(0)->CompareEquals(Field(TypeId::kTypeInt, id_kv.second)));
+    }
+    size_t count = 0;
+    for (auto iter = table_heap->Begin(nullptr); iter != table_heap->End(); ++iter) {
+      ASSERT_EQ(1, ids_.count(iter->GetRowId().Get()));
+      count++;
+    }
+    ASSERT_EQ(ids_.size(), count);
+  }
+
+  const int row_nums_ = 6000;
+  std::unique_ptr<DBStorageEngine> engine_;
+  SimpleMemHeap heap_;
+  std::shared_ptr<Schema> schema_;
+  TableHeap *table_heap_{nullptr};
+  char name_[64];
+  std::unordered_map<int64_t, int> ids_;   // id of each row left
+};
+
+TEST_F(VacuumWorkerTest, VacuumTest) {
+  table_heap_->EnableZoneMap({0});
+  // rows moved by updates are vacuumed with the forward records in their home slots
+  for (auto &id_kv : ids_) {
+    if (id_kv.second % 5 == 0) {
+      Fields fields = MakeFields(id_kv.second, 64);
+      Row row(fields);
+      ASSERT_TRUE(table_heap_->UpdateTuple(row, RowId(id_kv.first), nullptr));
+    }
+  }
+  uint32_t page_count = table_heap_->GetPageCount();
+  size_t deleted = DeleteRows(1000, 4000);
+  ScanPredicate predicate(table_heap_);
+  predicate.AddComparison(0, ScanPredicate::kGreaterThanEquals, Field(TypeId::kTypeInt, 1000));
+  predicate.AddComparison(0, ScanPredicate::kLessThan, Field(TypeId::kTypeInt, 4000));
+  ParallelTableScan scan(table_heap_, 2);
+  ASSERT_TRUE(scan.Filter(predicate, nullptr).empty());
+  size_t scanned_page_count = page_count - scan.GetSkippedPageCount();
+  VacuumWorker worker(table_heap_);
+  ASSERT_GT(worker.RunPass(nullptr), 0);
+  VacuumStats stats = worker.GetStats();
+  ASSERT_EQ(deleted, stats.tuple_count_);
+  ASSERT_GT(stats.reclaimed_size_, 0);
+  ASSERT_GT(stats.released_page_count_, 0);
+  ASSERT_EQ(page_count - stats.released_page_count_, table_heap_->GetPageCount());
+  ASSERT_EQ(0, worker.RunPass(nullptr));
+  ASSERT_EQ(2, worker.GetPassCount());
+  CheckRows(table_heap_);
+  // zones are rebuilt from the rows left, fewer pages may hold the deleted ids
+  ASSERT_TRUE(scan.Filter(predicate, nullptr).empty());
+  ASSERT_LT(table_heap_->GetPageCount() - scan.GetSkippedPageCount(), scanned_page_count);
+  // freed space is reused by inserts
+  for (int i = row_nums_; i < row_nums_ + 2000; i++) {
+    Fields fields = MakeFields(i, i % 32);
+    Row row(fields);
+    ASSERT_TRUE(table_heap_->InsertTuple(row, nullptr));
+    ids_[row.GetRowId().Get()] = i;
+  }
+  ASSERT_LE(table_heap_->GetPageCount(), page_count);
+  CheckRows(table_heap_);
+  // a loaded table heap does not know its deletes, so all its pages are vacuumed
+  TableHeap *loaded_heap = TableHeap::Create(engine_->bpm_, table_heap_->GetFirstPageId(), schema_.get(),
+                                             nullptr, nullptr, &heap_);
+  ASSERT_EQ(table_heap_->GetPageCount(), loaded_heap->GetPageCount());
+  ASSERT_EQ(loaded_heap->GetPageCount(), loaded_heap->TakePagesWithDeletes(SIZE_MAX).size());
+  CheckRows(loaded_heap);
+  loaded_heap->~TableHeap();
+}
+
+TEST_F(VacuumWorkerTest, BackgroundTest) {
+  VacuumOptions options;
+  options.interval_ = std::chrono::milliseconds(1);
+  options.round_page_count_ = 4;
+  options.round_delay_ = std::chrono::milliseconds(1);
+  VacuumWorker worker(table_heap_, options);
+  worker.Start();
+  size_t deleted = DeleteRows(0, 3000);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+  while (worker.GetStats().tuple_count_ < deleted && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  worker.Stop();
+  VacuumStats stats = worker.GetStats();
+  ASSERT_EQ(deleted, stats.tuple_count_);
+  ASSERT_GT(stats.released_page_count_, 0);
+  ASSERT_GT(worker.GetPassCount(), 0);
+  CheckRows(table_heap_);
+}
+
+TEST_F(VacuumWorkerTest, TransactionTest) {
+  // deletes are vacuumed once their transaction is committed or aborted
+  Transaction txn;
+  std::vector<std::pair<int64_t, int>> marked;
+  for (auto &id_kv : ids_) {
+    if (id_kv.second < 3000) {
+      marked.emplace_back(id_kv);
+    }
+  }
+  for (auto &rid_id : marked) {
+    ASSERT_TRUE(table_heap_->MarkDelete(RowId(rid_id.first), &txn));
+    ASSERT_FALSE(table_heap_->MarkDelete(RowId(rid_id.first), &txn));
+  }
+  VacuumWorker worker(table_heap_);
+  ASSERT_EQ(0, worker.RunPass(nullptr));
+  for (auto &rid_id : marked) {
+    if (rid_id.second < 1500) {
+      table_heap_->ApplyDelete(RowId(rid_id.first), &txn);
+      ids_.erase(rid_id.first);
+    } else {
+      table_heap_->RollbackDelete(RowId(rid_id.first), &txn);
+    }
+  }
+  ASSERT_GT(worker.RunPass(nullptr), 0);
+  ASSERT_GT(worker.GetStats().released_page_count_, 0);
+  CheckRows(table_heap_);
+}
+
+TEST_F(VacuumWorkerTest, RunningDeleteTest) {
+  // a tuple marked by a transaction after its page is taken by a pass is left until the transaction is finished
+  page_id_t page_id = RowId(ids_.begin()->first).GetPageId();
+  std::vector<int64_t> rids;
+  for (auto &id_kv : ids_) {
+    if (RowId(id_kv.first).GetPageId() == page_id) {
+      rids.push_back(id_kv.first);
+    }
+  }
+  ASSERT_GT(rids.size(), 2);
+  ASSERT_TRUE(table_heap_->MarkDelete(RowId(rids[0]), nullptr));
+  ids_.erase(rids[0]);
+  ASSERT_EQ(std::vector<page_id_t>{page_id}, table_heap_->TakePagesWithDeletes(SIZE_MAX));
+  Transaction txn;
+  ASSERT_TRUE(table_heap_->MarkDelete(RowId(rids[1]), &txn));
+  VacuumStats stats;
+  table_heap_->VacuumPage(page_id, stats, nullptr);
+  ASSERT_EQ(1, stats.tuple_count_);
+  table_heap_->RollbackDelete(RowId(rids[1]), &txn);
+  CheckRows(table_heap_);
+  VacuumWorker worker(table_heap_);
+  ASSERT_EQ(1, worker.RunPass(nullptr));
+  ASSERT_EQ(0, worker.GetStats().tuple_count_);
+  CheckRows(table_heap_);
+}
+
+TEST_F(VacuumWorkerTest, IteratorTest) {
+  std::vector<page_id_t> page_ids;
+  for (auto iter = table_heap_->Begin(nullptr); iter != table_heap_->End(); ++iter) {
+    if (page_ids.empty() || page_ids.back() != iter->GetRowId().GetPageId()) {
+      page_ids.push_back(iter->GetRowId().GetPageId());
+    }
+  }
+  ASSERT_GT(page_ids.size(), 3);
+  // the page an iterator is on and the page after it are unlinked, but not released until the iterator is done
+  auto iter = table_heap_->Begin(nullptr);
+  while (iter->GetRowId().GetPageId() != page_ids[1]) {
+    ++iter;
+  }
+  std::vector<int64_t> deleted;
+  for (auto &id_kv : ids_) {
+    page_id_t page_id = RowId(id_kv.first).GetPageId();
+    if (page_id == page_ids[1] || page_id == page_ids[2]) {
+      deleted.push_back(id_kv.first);
+    }
+  }
+  for (auto rid : deleted) {
+    ASSERT_TRUE(table_heap_->MarkDelete(RowId(rid), nullptr));
+    ids_.erase(rid);
+  }
+  VacuumWorker worker(table_heap_);
+  ASSERT_GT(worker.RunPass(nullptr), 0);
+  ASSERT_EQ(2, worker.GetStats().released_page_count_);
+  ASSERT_FALSE(engine_->bpm_->IsPageFree(page_ids[1]));
+  ASSERT_FALSE(engine_->bpm_->IsPageFree(page_ids[2]));
+  ++iter;
+  ASSERT_EQ(page_ids[3], iter->GetRowId().GetPageId());
+  while (iter != table_heap_->End()) {
+    ++iter;
+  }
+  worker.RunPass(nullptr);
+  ASSERT_TRUE(engine_->bpm_->IsPageFree(page_ids[1]));
+  ASSERT_TRUE(engine_->bpm_->IsPageFree(page_ids[2]));
+  CheckRows(table_heap_);
+}
+
+TEST(VacuumWorkerBenchmark, DISABLED_ScanAfterDeleteBenchmark) {
+  const int row_nums = 1000000;
+  DBStorageEngine engine(db_file_name, true, 32768);
+  SimpleMemHeap heap;
+  std::vector<Column *> columns = {
+          ALLOC_COLUMN(heap)("id", TypeId::kTypeInt, 0, false, false),
+          ALLOC_COLUMN(heap)("name", TypeId::kTypeChar, 64, 1, true, false)
+  };
+  auto schema = std::make_shared<Schema>(columns);
+  TableHeap *table_heap = TableHeap::Create(engine.bpm_, schema.get(), nullptr, nullptr, nullptr, &heap);
+  char name[64];
+  memset(name, 'n', sizeof(name));
+  std::vector<RowId> rids;
+  std::vector<Row> batch;
+  for (int i = 0; i < row_nums; i++) {
+    Fields fields{Field(TypeId::kTypeInt, i), Field(TypeId::kTypeChar, name, i % 32, true)};
+    batch.emplace_back(fields);
+    if (batch.size() == 1000) {
+      auto batch_rids = table_heap->InsertTuples(batch, nullptr);
+      rids.insert(rids.end(), batch_rids.begin(), batch_rids.end());
+      batch.clear();
+    }
+  }
+  // a delete heavy workload leaves one row in ten, mostly in the older half of the table
+  size_t left = 0;
+  for (int i = 0; i < row_nums; i++) {
+    if (i < row_nums / 2 && i % 5 == 0) {
+      left++;
+    } else {
+      table_heap->MarkDelete(rids[i], nullptr);
+    }
+  }
+  auto run_scan = [&](const char *label) {
+    auto start = std::chrono::steady_clock::now();
+    size_t count = 0;
+    for (int i = 0; i < 5; i++) {
+      count = 0;
+      ParallelTableScan(table_heap, 1).Scan([&count](uint32_t worker_id, const RowView &row) { count++; }, nullptr);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / 5;
+    ASSERT_EQ(left, count);
+    std::cout << label << ": " << table_heap->GetPageCount() << " pages, " << seconds * 1e3 << " ms per scan"
+              << std::endl;
+  };
+  run_scan("before vacuum");
+  VacuumWorker worker(table_heap);
+  auto start = std::chrono::steady_clock::now();
+  worker.RunPass(nullptr);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  VacuumStats stats = worker.GetStats();
+  std::cout << "vacuum: " << stats.page_count_ / seconds / 1e3 << "K pages/sec, " << stats.tuple_count_
+            << " tuples removed, " << stats.reclaimed_size_ / 1024 << " KB reclaimed, "
+            << stats.released_page_count_ << " pages released" << std::endl;
+  run_scan("after vacuum");
+  table_heap->~TableHeap();
+}